@@ -0,0 +1,166 @@
+#include "huge_page_allocator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Random-lookup walk over one large column, once on the regular heap and
+ * once through HugePageAllocator
+ * The column holds a single random cycle, so every lookup depends on the
+ * one before it and lands on an unpredictable page: the walk runs at the
+ * speed of its TLB and cache misses. The regular heap copy is advised
+ * MADV_NOHUGEPAGE so transparent huge pages do not blur the comparison.
+ *
+ * Usage: huge_page_bench [column MiB = 512] [lookups = 20000000] [explicit]
+ * "explicit" tries reserved MAP_HUGETLB pages before transparent ones.
+ * dTLB misses are read with perf_event_open and reported as n/a where the
+ * kernel or the container does not allow it. Configure with
+ * CMAKE_BUILD_TYPE=Release for representative timings.
+ */
+
+namespace {
+
+// Counts data-TLB load misses of the calling thread while open
+class TlbMissCounter {
+public:
+    TlbMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~TlbMissCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    TlbMissCounter(const TlbMissCounter&) = delete;
+    TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+    void start() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Misses since start, or -1 when the counter is unavailable
+    long long stop() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            long long count = 0;
+            if (read(fd_, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count))) {
+                return count;
+            }
+        }
+#endif
+        return -1;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// Links column into one cycle through every row, in random order
+void buildCycle(uint32_t* column, size_t rows, uint64_t seed) {
+    std::vector<uint32_t> order(rows);
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin() + 1, order.end(), std::mt19937_64(seed));
+    for (size_t i = 0; i < rows; ++i) {
+        column[order[i]] = order[(i + 1) % rows];
+    }
+}
+
+void walk(const char* label, const uint32_t* column, size_t lookups) {
+    TlbMissCounter misses;
+    uint32_t position = 0;
+    misses.start();
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i) {
+        position = column[position];
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const long long missCount = misses.stop();
+
+    const double nanos = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::printf("%-12s %8.2f ns/lookup", label, nanos / static_cast<double>(lookups));
+    if (missCount >= 0) {
+        std::printf("  %6.3f dTLB misses/lookup", static_cast<double>(missCount) / static_cast<double>(lookups));
+    } else {
+        std::printf("  dTLB misses n/a");
+    }
+    // Printing the end of the walk keeps the loop from being optimized away
+    std::printf("  (end %u)\n", position);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t mebibytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 512;
+    const size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000000;
+    if (argc > 3 && std::string(argv[3]) == "explicit") {
+        HugePageMemory::setExplicitHugePages(true);
+    }
+    const size_t rows = mebibytes * 1024 * 1024 / sizeof(uint32_t);
+    if (rows < 2 || lookups == 0) {
+        std::fprintf(stderr, "usage: %s [column MiB] [lookups] [explicit]\n", argv[0]);
+        return 1;
+    }
+    std::printf("column %zu MiB, %zu lookups\n", mebibytes, lookups);
+
+    {
+        // Left untouched until advised, so no page faults in as a huge page
+        std::unique_ptr<uint32_t[]> column(new uint32_t[rows]);
+#ifdef __linux__
+        const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t begin = (reinterpret_cast<uintptr_t>(column.get()) + page - 1) & ~(page - 1);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(column.get() + rows) & ~(page - 1);
+        if (end > begin) {
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_NOHUGEPAGE);
+        }
+#endif
+        buildCycle(column.get(), rows, 42);
+        walk("4k pages", column.get(), lookups);
+    }
+
+    {
+        std::vector<uint32_t, HugePageAllocator<uint32_t>> column(rows);
+        buildCycle(column.data(), rows, 42);
+        walk("huge pages", column.data(), lookups);
+    }
+
+    const HugePageMemory::Stats stats = HugePageMemory::getStats();
+    std::printf("huge-page mappings: %llu explicit, %llu transparent\n",
+                static_cast<unsigned long long>(stats.explicitMappings),
+                static_cast<unsigned long long>(stats.transparentMappings));
+    return 0;
+}
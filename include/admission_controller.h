@@ -0,0 +1,108 @@
+#ifndef ADMISSION_CONTROLLER_H
+#define ADMISSION_CONTROLLER_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Priority classes for admission control, highest first
+ */
+enum class RequestPriority {
+    Critical = 0,  // latency-sensitive point reads
+    Normal = 1,    // writes and small aggregates
+    Bulk = 2,      // full scans and large batches
+};
+
+/**
+ * Per-class admission settings
+ */
+struct AdmissionOptions {
+    double initialLimit = 8.0;        // starting concurrency limit
+    double minLimit = 1.0;
+    double maxLimit = 256.0;
+    size_t maxQueueDepth = 64;        // waiters beyond this are rejected at once
+    double backoffRatio = 0.9;        // multiplicative decrease on slow calls
+    std::chrono::microseconds targetLatency{10000};
+    std::chrono::microseconds queueTimeout{50000};  // default deadline for queued calls
+};
+
+/**
+ * Admission controller with bounded per-class queues and AIMD limits
+ * Each priority class has its own concurrency limit that grows additively
+ * while observed latency stays under the class target and shrinks
+ * multiplicatively when it does not. A class is not admitted while a
+ * higher class has waiters, so bulk work cannot starve critical calls.
+ * Requests whose deadline cannot be met given the queue ahead of them and
+ * the observed latency are rejected immediately instead of queueing.
+ */
+class AdmissionController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Admission grant; releases its slot and reports latency when destroyed
+     */
+    class Ticket {
+    public:
+        Ticket() = default;
+        Ticket(Ticket&& other) noexcept;
+        Ticket& operator=(Ticket&& other) noexcept;
+        ~Ticket();
+
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        bool admitted() const { return controller_ != nullptr; }
+        explicit operator bool() const { return admitted(); }
+        void release();
+
+    private:
+        friend class AdmissionController;
+        Ticket(AdmissionController* controller, RequestPriority priority);
+
+        AdmissionController* controller_ = nullptr;
+        RequestPriority priority_ = RequestPriority::Normal;
+        Clock::time_point start_;
+    };
+
+    explicit AdmissionController(const AdmissionOptions& options = AdmissionOptions());
+    ~AdmissionController() = default;
+
+    void configure(RequestPriority priority, const AdmissionOptions& options);
+
+    // Blocks until admitted or the deadline passes; an empty ticket means rejected
+    Ticket admit(RequestPriority priority);
+    Ticket admit(RequestPriority priority, Clock::time_point deadline);
+
+    // Statistics
+    double getLimit(RequestPriority priority) const;
+    size_t getInFlight(RequestPriority priority) const;
+    size_t getQueued(RequestPriority priority) const;
+    uint64_t getAdmitted(RequestPriority priority) const;
+    uint64_t getRejected(RequestPriority priority) const;
+
+private:
+    static constexpr size_t kClassCount = 3;
+
+    struct ClassState {
+        AdmissionOptions options;
+        double limit = 0.0;
+        size_t inFlight = 0;
+        size_t queued = 0;
+        double avgLatencyUs = 0.0;
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        std::condition_variable ready;
+    };
+
+    bool canAdmit(size_t index) const;
+    void finish(RequestPriority priority, Clock::duration latency);
+
+    mutable std::mutex mutex_;
+    std::array<ClassState, kClassCount> classes_;
+};
+
+#endif // ADMISSION_CONTROLLER_H
@@ -0,0 +1,33 @@
+#ifndef AGE_INDEX_H
+#define AGE_INDEX_H
+
+#include "materialized_view.h"
+#include "roaring_bitmap.h"
+#include <map>
+#include <shared_mutex>
+
+/**
+ * Secondary index from age to the set of user ids, maintained as a view
+ * Each distinct age owns a RoaringBitmap, so a range lookup is the union
+ * of a few compressed bitmaps rather than a column scan, and the result can
+ * be combined with other predicates without materializing row lists.
+ */
+class AgeIndex : public MaterializedView {
+public:
+    void onInsert(int userId, const std::string& name, int age) override;
+    void onDelete(int userId, const std::string& name, int age) override;
+    void onUpdate(int userId, const std::string& oldName, int oldAge,
+                  const std::string& newName, int newAge) override;
+
+    // Users aged within [low, high]
+    RoaringBitmap findRange(int low, int high) const;
+    uint64_t countRange(int low, int high) const;
+
+    uint64_t size() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::map<int, RoaringBitmap> by_age_;
+};
+
+#endif // AGE_INDEX_H
@@ -0,0 +1,47 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Self-contained LZ77-family block codec
+ * Input is split into independent fixed-size blocks so that blocks can be
+ * compressed and decompressed in parallel. Each block is encoded as a
+ * sequence of (literal run, back-reference) pairs; blocks that do not
+ * shrink are stored raw so decompression never costs more than a copy.
+ *
+ * Framed layout (all integers little-endian):
+ *   magic "LZB1" | u32 block size | u32 block count | u64 raw size
+ *   per block: u32 raw length | u32 stored length (high bit = raw) | payload
+ */
+class BlockCodec {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    /**
+     * @param blockSize raw bytes per independent block
+     * @param threads   worker threads for framed calls; 0 picks hardware concurrency
+     */
+    explicit BlockCodec(size_t blockSize = kDefaultBlockSize, unsigned threads = 0);
+    ~BlockCodec() = default;
+
+    // Single-block primitives
+    static std::vector<uint8_t> compressBlock(const uint8_t* data, size_t size);
+    static std::vector<uint8_t> decompressBlock(const uint8_t* data, size_t size, size_t rawSize);
+
+    // Framed multi-block operations; decompress throws std::runtime_error on corrupt
+    // input, including frames cut with a larger block size than this codec's
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& input) const;
+    std::vector<uint8_t> decompress(const std::vector<uint8_t>& framed) const;
+
+    size_t getBlockSize() const { return block_size_; }
+    unsigned getThreadCount() const { return threads_; }
+
+private:
+    size_t block_size_;
+    unsigned threads_;
+};
+
+#endif // BLOCK_CODEC_H
@@ -1,6 +1,7 @@
 #ifndef CALCULATOR_H
 #define CALCULATOR_H
 
+#include <cstddef>
 #include <string>
 #include <stdexcept>
 
@@ -19,6 +20,16 @@ public:
     int multiply(int a, int b);
     double divide(double a, double b);
     
+    // Column-at-a-time forms: out[i] = a[i] op b[i] for i < count. The loops
+    // have no branches, so they compile to SIMD; out may alias a or b
+    void add(const double* a, const double* b, double* out, size_t count);
+    void subtract(const double* a, const double* b, double* out, size_t count);
+    void multiply(const double* a, const double* b, double* out, size_t count);
+    // Throws like divide() if any divisor is zero, before writing out
+    void divide(const double* a, const double* b, double* out, size_t count);
+    // out[i] = sqrt(a[i]); throws like squareRoot() if any a[i] is negative
+    void squareRoot(const double* a, double* out, size_t count);
+    
     // Boolean operations for boolean assertion demonstrations
     bool isPositive(int number);
     bool isEven(int number);
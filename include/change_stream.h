@@ -0,0 +1,117 @@
+#ifndef CHANGE_STREAM_H
+#define CHANGE_STREAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Kind of user mutation carried by a change record
+ */
+enum class ChangeType {
+    Insert,
+    Update,
+    Delete,
+};
+
+/**
+ * One user mutation; name and age hold the row after the change
+ * (the removed row for deletes)
+ */
+struct ChangeRecord {
+    uint64_t sequence = 0;
+    ChangeType type = ChangeType::Insert;
+    int userId = 0;
+    std::string name;
+    int age = 0;
+};
+
+/**
+ * Change-data-capture stream over a broadcast ring buffer
+ * Publishers claim a sequence number with one fetch_add and write the
+ * record into slot (sequence mod capacity). Every subscriber keeps its own
+ * cursor and reads at its own pace without coordinating with other
+ * subscribers. A subscriber that falls more than `capacity` records
+ * behind observes an overrun and skips ahead to the oldest retained record.
+ *
+ * Each slot is a seqlock: its version says which sequence it holds and
+ * whether that record is still being written. Subscribers copy a record
+ * out and keep it only if the version did not move meanwhile, so polling
+ * takes no lock and never delays a publisher. A slot is written by one
+ * publisher at a time, in sequence order: a publisher whose slot still
+ * holds a write from the previous lap yields until that write is done,
+ * which only happens when a whole ring of records was claimed during it.
+ * Names live in per-slot buffers that only grow and are freed with the
+ * stream, so a subscriber never copies from freed memory.
+ *
+ * Records are delivered strictly in sequence: a publisher that has claimed
+ * a number but not stored its record yet makes every subscriber report
+ * Empty at that position, even when later records are already stored.
+ */
+class ChangeStream {
+public:
+    enum class PollResult {
+        Record,   // a record was delivered
+        Empty,    // caught up with publishers
+        Overrun,  // records were lost; cursor moved to the oldest retained one
+    };
+
+    /**
+     * Independent reading position in a stream; the stream must outlive it
+     */
+    class Subscriber {
+    public:
+        PollResult poll(ChangeRecord& out);
+        uint64_t getPosition() const { return cursor_; }
+        uint64_t getDropped() const { return dropped_; }
+
+    private:
+        friend class ChangeStream;
+        Subscriber(const ChangeStream* stream, uint64_t cursor);
+
+        const ChangeStream* stream_;
+        uint64_t cursor_;
+        uint64_t dropped_ = 0;
+    };
+
+    /**
+     * @param capacity records retained for slow subscribers, rounded up to a power of two
+     */
+    explicit ChangeStream(size_t capacity = 4096);
+    ~ChangeStream() = default;
+
+    ChangeStream(const ChangeStream&) = delete;
+    ChangeStream& operator=(const ChangeStream&) = delete;
+
+    // Returns the sequence number assigned to the record
+    uint64_t publish(ChangeType type, int userId, const std::string& name, int age);
+
+    // New subscribers see only records published after subscribing
+    Subscriber subscribe() const;
+    Subscriber subscribeFrom(uint64_t sequence) const;
+
+    uint64_t getNextSequence() const { return next_.load(std::memory_order_acquire); }
+    size_t getCapacity() const { return mask_ + 1; }
+
+private:
+    // Fields are atomics so a copy racing a publisher is stale, never undefined;
+    // version is 2 * sequence + 1 while sequence is written, 2 * sequence + 2 after
+    struct Slot {
+        std::atomic<uint64_t> version{0};
+        std::atomic<uint8_t> type{0};
+        std::atomic<int> userId{0};
+        std::atomic<int> age{0};
+        std::atomic<size_t> nameLength{0};
+        // name[0] is the buffer's capacity in words, the name's bytes follow
+        std::atomic<std::atomic<uint64_t>*> name{nullptr};
+        std::vector<std::unique_ptr<std::atomic<uint64_t>[]>> buffers;  // publisher-only
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    std::atomic<uint64_t> next_{0};
+};
+
+#endif // CHANGE_STREAM_H
@@ -0,0 +1,70 @@
+#ifndef CONNECTION_MONITOR_H
+#define CONNECTION_MONITOR_H
+
+#include "database_interface.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Health check cadence and reconnect backoff
+ */
+struct HealthCheckOptions {
+    std::chrono::milliseconds interval{1000};   // probe period while connected
+    std::chrono::milliseconds minBackoff{10};   // first reconnect delay once down
+    std::chrono::milliseconds maxBackoff{2000}; // cap for the doubling delay
+};
+
+/**
+ * Caches a database's connection state for hot paths
+ * A background thread probes isConnected() every interval and publishes
+ * the answer in an atomic, so readers pay one load instead of a virtual
+ * call that may be a round trip. While the link is down it calls connect()
+ * instead, doubling the delay after each failed attempt up to maxBackoff.
+ * Callers that see an operation fail can ask for an immediate probe.
+ */
+class ConnectionMonitor {
+public:
+    ConnectionMonitor(std::shared_ptr<DatabaseInterface> database, std::string connectionString,
+                      const HealthCheckOptions& options = HealthCheckOptions());
+    ~ConnectionMonitor();
+
+    ConnectionMonitor(const ConnectionMonitor&) = delete;
+    ConnectionMonitor& operator=(const ConnectionMonitor&) = delete;
+
+    bool isConnected() const { return connected_.load(std::memory_order_acquire); }
+
+    // An operation failed in a way a dropped link would explain; probe now
+    void reportFailure();
+
+    // Statistics
+    uint64_t getProbes() const { return probes_.load(std::memory_order_relaxed); }
+    uint64_t getReconnectAttempts() const { return reconnect_attempts_.load(std::memory_order_relaxed); }
+    uint64_t getReconnects() const { return reconnects_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void probe(std::chrono::milliseconds& backoff);
+
+    std::shared_ptr<DatabaseInterface> database_;
+    std::string connection_string_;
+    HealthCheckOptions options_;
+
+    std::atomic<bool> connected_;
+    std::atomic<uint64_t> probes_{0};
+    std::atomic<uint64_t> reconnect_attempts_{0};
+    std::atomic<uint64_t> reconnects_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool probe_requested_ = false;
+    bool stopping_ = false;
+    std::thread checker_;
+};
+
+#endif // CONNECTION_MONITOR_H
@@ -4,6 +4,39 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include "admission_controller.h"
+#include "db_status.h"
+#include "hedge_policy.h"
+#include "replica_router.h"
+#include "single_flight.h"
+
+class HyperLogLog;
+
+/**
+ * Plain user row returned by batch lookups
+ * A record for an unknown id has an empty name and age -1
+ */
+struct UserRecord {
+    int id = 0;
+    std::string name;
+    int age = -1;
+};
+
+/**
+ * One write in a bulk batch; inserts ignore userId, deletes ignore name and age
+ */
+enum class MutationType {
+    Insert,
+    Update,
+    Delete,
+};
+
+struct UserMutation {
+    MutationType type = MutationType::Insert;
+    int userId = 0;
+    std::string name;
+    int age = -1;
+};
 
 /**
  * Abstract database interface for demonstrating Google Mock
@@ -20,11 +53,46 @@ public:
     
     // Data operations for mock testing
     virtual bool insertUser(const std::string& name, int age) = 0;
+    // Insert under a caller-chosen id, for routers that own the id space.
+    // Backends that assign ids themselves keep the default, which fails
+    virtual bool insertUserWithId(int userId, const std::string& name, int age);
+    // Insert that reports the id it assigned, or -1 on failure. The default
+    // wraps insertUser, which does not tell the id, so a successful insert
+    // through it returns kUnknownId; ids are never below 1
+    static constexpr int kUnknownId = 0;
+    virtual int insertUserReturningId(const std::string& name, int age);
     virtual std::string getUserName(int userId) = 0;
     virtual int getUserAge(int userId) = 0;
     virtual bool updateUser(int userId, const std::string& name, int age) = 0;
     virtual bool deleteUser(int userId) = 0;
     
+    // Typed variants: the outcome is the return value, and a failure's text
+    // is in DbStatus::detail() on the calling thread. The defaults wrap the
+    // calls above and classify getLastError(); engines and routers implement
+    // them natively and leave getLastError() untouched
+    virtual DbStatus tryInsertUser(const std::string& name, int age);
+    virtual DbStatus tryInsertUserWithId(int userId, const std::string& name, int age);
+    virtual DbStatus tryUpdateUser(int userId, const std::string& name, int age);
+    virtual DbStatus tryDeleteUser(int userId);
+    virtual DbStatus tryGetUser(int userId, UserRecord& out);
+    
+    // Batch lookup; result[i] describes userIds[i]. The default issues one
+    // getUserName/getUserAge pair per id, engines override it to overlap misses
+    virtual std::vector<UserRecord> getUsers(const std::vector<int>& userIds);
+    
+    // Bulk write in batch order; true only if every mutation succeeded. The
+    // default applies them one call at a time, engines override it to batch
+    virtual bool applyMutations(const std::vector<UserMutation>& mutations);
+    
+    // Keyset pagination: up to limit users with id > afterId, in id order.
+    // Pass the last id of a page to get the next one; 0 starts at the top.
+    // The default pages over a full SELECT *, engines seek their id order
+    virtual std::vector<UserRecord> listUsers(int afterId, size_t limit);
+    
+    // Folds the names selected by a COUNT(DISTINCT NAME) query into sketch,
+    // so routers can merge per-backend sketches. The default fails
+    virtual bool mergeDistinctNames(const std::string& query, HyperLogLog& sketch);
+    
     // Operations with different parameter types for testing MOCK_METHOD
     virtual std::vector<std::string> getAllUserNames() = 0;
     virtual int getUserCount() = 0;
@@ -33,8 +101,18 @@ public:
     // Operations with const and non-const versions
     virtual std::string getLastError() const = 0;
     virtual void clearError() = 0;
+    
+private:
+    // Status for a failed untyped call, built from getLastError()
+    DbStatus failureStatus() const;
 };
 
+class ConnectionMonitor;
+class JsonWriter;
+class WriteBehindQueue;
+struct HealthCheckOptions;
+struct WriteBehindOptions;
+
 /**
  * Database service class that uses DatabaseInterface
  * This class will be tested using mocked database interface
@@ -47,13 +125,79 @@ public:
     // Service operations that will be tested with mocks
     bool initializeConnection(const std::string& connectionString);
     bool createUser(const std::string& name, int age);
+    // createUser reporting the new id: -1 on failure, and kUnknownId when the
+    // backend cannot tell. A queued insert has no id yet, so under
+    // write-behind this drains the queue and then writes directly
+    int createUserReturningId(const std::string& name, int age);
     std::string getUserInfo(int userId);
+    // Same text written into a reused string; false (and empty) if not found
+    bool getUserInfo(int userId, std::string& out);
+    // One line per found user, each ending in '\n'; returns the number found
+    size_t getUsersInfo(const std::vector<int>& userIds, std::string& out);
+    // Appends a JSON array of the found users to writer; returns the number found
+    size_t getUsersJson(const std::vector<int>& userIds, JsonWriter& writer);
+    std::vector<UserRecord> getUsers(const std::vector<int>& userIds);
     bool removeUser(int userId);
+    bool updateUser(int userId, const std::string& name, int age);
     int getTotalUsers();
+    std::vector<std::string> getAllUserNames();
+    std::vector<UserRecord> listUsers(int afterId, size_t limit);
+    
+    // Optional admission control; calls rejected by it fail like a lost connection
+    void setAdmissionController(std::shared_ptr<AdmissionController> controller);
+    
+    // Optional read replicas; the constructor's database stays the primary and
+    // takes every write. Replicas are connected by initializeConnection, so
+    // ones added after it must already be connected
+    void setReplicas(std::vector<std::shared_ptr<DatabaseInterface>> replicas,
+                     const ReplicaOptions& options = ReplicaOptions());
+    
+    // Optional hedging of getUserInfo across replicas; needs setReplicas
+    void setHedgePolicy(std::shared_ptr<HedgePolicy> policy);
+    
+    // Optional coalescing: concurrent getUserInfo calls for the same user, and
+    // concurrent getTotalUsers calls, share one backend read
+    void setRequestCoalescing(bool enabled);
+    
+    // Optional write-behind: writes are buffered, merged per user and applied
+    // in batches through applyMutations, so they only report acceptance.
+    // flush() waits until earlier writes are applied and reports failures
+    void enableWriteBehind(const WriteBehindOptions& options);
+    bool flush();
+    
+    // Optional health checking: a background thread probes the primary and
+    // reconnects it with backoff, and calls check the cached state instead
+    // of calling isConnected(). Reconnects reuse initializeConnection's string.
+    // Writes that fail with NotConnected trigger an immediate probe. Call it
+    // before the service is shared between threads: calls read the monitor
+    // without synchronization
+    void enableHealthCheck(const HealthCheckOptions& options);
     
 private:
+    bool connected() const;
+    bool admit(RequestPriority priority, AdmissionController::Ticket& ticket);
+    DatabaseInterface& readSource(ReplicaRouter::Lease& lease);
+    ReplicaRouter::Lease beginWrite();
+    bool lookupUserInfo(int userId, std::string& name, int& age);
+    void fetchUserInfo(int userId, std::string& name, int& age);
+    void hedgedRead(int userId, std::string& name, int& age);
+    bool coalescing() const;
+    bool applyWrite(UserMutation mutation);
+    void finishWrite(MutationType type, int userId, DbStatus status);
+    
     std::shared_ptr<DatabaseInterface> database_;
+    std::shared_ptr<AdmissionController> admission_;
+    std::shared_ptr<ReplicaRouter> replicas_;
+    std::shared_ptr<HedgePolicy> hedging_;
+    // One flight table per operation, keyed by user id (0 for counts)
+    std::shared_ptr<SingleFlight<int, std::pair<std::string, int>>> user_info_flights_;
+    std::shared_ptr<SingleFlight<int, int>> total_users_flights_;
+    std::shared_ptr<WriteBehindQueue> write_behind_;
+    std::shared_ptr<ConnectionMonitor> monitor_;
+    std::string connection_string_;
     bool initialized_ = false;
+    // Runs first attempts of hedged reads; declared last so it is joined first
+    std::unique_ptr<HedgeExecutor> hedge_executor_;
 };
 
 #endif // DATABASE_INTERFACE_H
\ No newline at end of file
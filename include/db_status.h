@@ -0,0 +1,49 @@
+#ifndef DB_STATUS_H
+#define DB_STATUS_H
+
+#include <string>
+
+/**
+ * Failure classes reported by typed DatabaseInterface calls
+ */
+enum class DbError {
+    None,
+    NotConnected,
+    InvalidArgument,  // empty name, negative age
+    NotFound,
+    AlreadyExists,
+    OutOfRange,       // id outside the backend's id space
+    Unsupported,
+    Unknown,
+};
+
+/**
+ * Outcome of a typed DatabaseInterface call
+ * The status is just the code, so checking it costs no allocation and no
+ * extra virtual call. The readable detail of the calling thread's latest
+ * failure lives in thread-local storage as a literal plus an optional
+ * copied context, and becomes a std::string only when detail() is asked.
+ */
+class DbStatus {
+public:
+    DbStatus() = default;
+    DbStatus(DbError code) : code_(code) {}
+
+    bool ok() const { return code_ == DbError::None; }
+    DbError code() const { return code_; }
+
+    // Records a failure for the calling thread; message must be a string
+    // literal, context (appended to it) is copied into reused storage
+    static DbStatus fail(DbError code, const char* message, const std::string& context = std::string());
+
+    // Detail of the calling thread's latest recorded failure, "" if none
+    static std::string detail();
+
+    // Best-effort code for a getLastError() text, for untyped backends
+    static DbError classify(const std::string& message);
+
+private:
+    DbError code_ = DbError::None;
+};
+
+#endif // DB_STATUS_H
@@ -0,0 +1,40 @@
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <string>
+
+/**
+ * Levenshtein distance from one pattern to many texts
+ * Patterns of up to 64 bytes use Myers' bit-parallel algorithm (in Hyyrö's
+ * formulation): a whole DP column lives in two 64-bit delta vectors and
+ * each text byte costs a handful of word operations. The per-byte match
+ * masks are built once in the constructor and reused for every text.
+ * Longer patterns fall back to a DP restricted to the diagonal band the
+ * distance bound allows. Both stop early once the bound cannot be met.
+ */
+class EditDistanceMatcher {
+public:
+    static constexpr size_t kMaxBitParallelLength = 64;
+
+    explicit EditDistanceMatcher(const std::string& pattern);
+
+    // Distance to text, or maxDistance + 1 once it is known to exceed maxDistance
+    int distance(const std::string& text, int maxDistance = INT_MAX - 1) const;
+
+    const std::string& pattern() const { return pattern_; }
+
+    // Plain full-matrix Levenshtein distance
+    static int reference(const std::string& a, const std::string& b);
+
+private:
+    int bitParallel(const std::string& text, int maxDistance) const;
+    int banded(const std::string& text, int maxDistance) const;
+
+    std::string pattern_;
+    std::array<uint64_t, 256> match_masks_{};
+};
+
+#endif // EDIT_DISTANCE_H
@@ -0,0 +1,55 @@
+#ifndef EXPRESSION_EVALUATOR_H
+#define EXPRESSION_EVALUATOR_H
+
+#include "calculator.h"
+#include "query_parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Column-at-a-time evaluator for query expressions
+ * An expression is evaluated over a whole batch of rows at once: a leaf
+ * fills a column with the batch's ids, its ages or a constant, and each
+ * operator is one element-wise Calculator pass over its operands' columns.
+ * Per-row work is then a handful of branch-free loops instead of a tree
+ * walk per row. Callers feed at most kBatchRows rows per call so the
+ * intermediate columns, which are reused between calls, stay in cache.
+ */
+class ExpressionEvaluator {
+public:
+    static constexpr size_t kBatchRows = 1024;
+
+    // Input columns of one batch
+    struct Batch {
+        const double* ids = nullptr;
+        const double* ages = nullptr;
+        size_t rows = 0;
+    };
+
+    // out[i] is the expression's value on row i; throws std::invalid_argument
+    // if a divisor is zero or a square root's operand negative on any row,
+    // or if the tree is deeper than QueryParser::kMaxNesting
+    void evaluate(const QueryExpression& expression, const Batch& batch, std::vector<double>& out);
+
+    // selected[i] is 1 where the Compare predicate holds on row i
+    void compare(const QueryPredicate& predicate, const Batch& batch, std::vector<uint8_t>& selected);
+
+    // Shortest text that strtod reads back as value, at most 17 significant
+    // digits; integral values below 1e15 have no fraction
+    static void formatInto(std::string& out, double value);
+
+private:
+    void evaluateInto(const QueryExpression& expression, const Batch& batch, double* out, size_t depth);
+    // Operator levels below the root, exact up to limit and above it otherwise
+    static size_t depthOf(const QueryExpression& expression, size_t limit);
+
+    Calculator calculator_;
+    // scratch_[d] holds right operands of operators d levels down
+    std::vector<std::vector<double>> scratch_;
+    std::vector<double> left_;
+    std::vector<double> right_;
+};
+
+#endif // EXPRESSION_EVALUATOR_H
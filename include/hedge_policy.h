@@ -0,0 +1,101 @@
+#ifndef HEDGE_POLICY_H
+#define HEDGE_POLICY_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Hedged read settings
+ */
+struct HedgeOptions {
+    double percentile = 0.95;         // a read slower than this is hedged
+    double budgetRatio = 0.05;        // hedges earned per read
+    double maxBurst = 10.0;           // unspent hedges that can accumulate
+    size_t windowSize = 1024;         // latency samples kept
+    size_t minSamples = 32;           // below this the initial delay is used
+    std::chrono::microseconds initialDelay{10000};
+    std::chrono::microseconds minDelay{500};
+};
+
+/**
+ * Decides when a slow read gets a second, redundant attempt
+ * The hedge delay is the configured percentile of recently observed read
+ * latencies, so only the slowest few percent of reads are duplicated. A
+ * token bucket filled at budgetRatio per read caps the extra load, which
+ * keeps hedging from amplifying an overload that slows every backend.
+ */
+class HedgePolicy {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit HedgePolicy(const HedgeOptions& options = HedgeOptions());
+    ~HedgePolicy() = default;
+
+    HedgePolicy(const HedgePolicy&) = delete;
+    HedgePolicy& operator=(const HedgePolicy&) = delete;
+
+    // How long to wait for the first attempt before hedging
+    Clock::duration hedgeDelay();
+    void recordLatency(Clock::duration latency);
+
+    // Called once per read; earns budget
+    void onRead();
+    // Spends one hedge from the budget, if any is left
+    bool tryHedge();
+    void recordHedgeWin();
+
+    // Statistics
+    uint64_t getReads() const;
+    uint64_t getHedges() const;
+    uint64_t getHedgeWins() const;
+
+private:
+    HedgeOptions options_;
+
+    mutable std::mutex mutex_;
+    std::vector<int64_t> samples_;     // ring of latencies in microseconds
+    size_t next_sample_ = 0;
+    size_t samples_since_refresh_ = 0;
+    Clock::duration delay_;
+    double tokens_ = 0.0;
+    uint64_t reads_ = 0;
+    uint64_t hedges_ = 0;
+    uint64_t hedge_wins_ = 0;
+};
+
+/**
+ * Fixed set of worker threads for the attempts a hedged read hands off
+ * Nothing ever waits in line: submit accepts a task only when a worker is
+ * idle to start it at once, and otherwise the caller reads inline without
+ * hedging. Tasks must not throw. The destructor runs every accepted task
+ * and joins the workers, so no attempt outlives the owner.
+ */
+class HedgeExecutor {
+public:
+    explicit HedgeExecutor(size_t threads = 4);
+    ~HedgeExecutor();
+
+    HedgeExecutor(const HedgeExecutor&) = delete;
+    HedgeExecutor& operator=(const HedgeExecutor&) = delete;
+
+    // Hands the task to an idle worker; false if every worker is busy
+    bool submit(std::function<void()> task);
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> tasks_;  // never more than idle_
+    size_t idle_ = 0;                          // workers not running a task
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+#endif // HEDGE_POLICY_H
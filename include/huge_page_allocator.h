@@ -0,0 +1,82 @@
+#ifndef HUGE_PAGE_ALLOCATOR_H
+#define HUGE_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Backing store for large engine structures
+ * Allocations of at least kLargeThreshold bytes are mapped directly,
+ * rounded up to whole 2 MB pages at a 2 MB-aligned address, and backed by
+ * huge pages: explicit MAP_HUGETLB pages when enabled and available,
+ * otherwise transparent huge pages requested with madvise. When a NUMA
+ * node is given the mapping is bound to that node with MPOL_BIND.
+ * Smaller allocations and non-Linux builds fall back to the regular heap.
+ * bench/huge_page_bench.cpp measures the effect on random lookups.
+ */
+class HugePageMemory {
+public:
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+    static constexpr size_t kLargeThreshold = kHugePageSize / 2;
+
+    struct Stats {
+        uint64_t mappedBytes = 0;        // currently mapped through the large path
+        uint64_t explicitMappings = 0;   // mappings served by MAP_HUGETLB
+        uint64_t transparentMappings = 0;  // mappings madvise accepted for THP
+        uint64_t boundMappings = 0;      // mappings bound to a NUMA node
+    };
+
+    // numaNode < 0 leaves placement to the kernel (first touch)
+    static void* allocate(size_t bytes, int numaNode = -1);
+    static void deallocate(void* pointer, size_t bytes) noexcept;
+
+    // Try reserved MAP_HUGETLB pages before transparent huge pages
+    static void setExplicitHugePages(bool enabled);
+
+    // NUMA node of the calling thread's current CPU, or -1 when unknown
+    static int currentNumaNode();
+
+    static Stats getStats();
+};
+
+/**
+ * STL allocator placing container storage through HugePageMemory
+ * Carries the NUMA node it allocates on, so a shard's columns can be bound
+ * to the node of the worker thread that owns them.
+ */
+template <typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    explicit HugePageAllocator(int numaNode) noexcept : numa_node_(numaNode) {}
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>& other) noexcept : numa_node_(other.getNumaNode()) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(HugePageMemory::allocate(count * sizeof(T), numa_node_));
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        HugePageMemory::deallocate(pointer, count * sizeof(T));
+    }
+
+    int getNumaNode() const noexcept { return numa_node_; }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>& other) const noexcept {
+        return numa_node_ == other.getNumaNode();
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    int numa_node_ = -1;
+};
+
+#endif // HUGE_PAGE_ALLOCATOR_H
@@ -0,0 +1,48 @@
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * HyperLogLog distinct-value sketch
+ * Each value is hashed to 64 bits; the top precision bits pick one of
+ * 2^precision one-byte registers, which keeps the longest run of leading
+ * zeros seen in the remaining bits. The estimate is the bias-corrected
+ * harmonic mean of the registers, with linear counting for small sets. At
+ * the default precision the sketch is 16 KiB with ~0.8% standard error,
+ * whatever the number of values. Sketches of the same precision merge by
+ * register-wise max, so per-segment or per-shard sketches combine exactly
+ * as if every value had been added to one sketch. The hash is fixed, so
+ * sketches built in different processes are mergeable too.
+ */
+class HyperLogLog {
+public:
+    static constexpr int kMinPrecision = 4;
+    static constexpr int kMaxPrecision = 18;
+    static constexpr int kDefaultPrecision = 14;
+
+    explicit HyperLogLog(int precision = kDefaultPrecision);
+
+    void add(const std::string& value) { addHash(hash(value.data(), value.size())); }
+    void addHash(uint64_t hash);
+
+    // Register-wise max; false (and unchanged) when the precisions differ
+    bool merge(const HyperLogLog& other);
+
+    uint64_t estimate() const;
+    void clear();
+
+    int precision() const { return precision_; }
+    double standardError() const;
+
+    static uint64_t hash(const char* data, size_t length);
+
+private:
+    int precision_;
+    std::vector<uint8_t> registers_;
+};
+
+#endif // HYPERLOGLOG_H
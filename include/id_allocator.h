@@ -0,0 +1,48 @@
+#ifndef ID_ALLOCATOR_H
+#define ID_ALLOCATOR_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free user id allocator with per-thread blocks
+ * Each thread carves a block of blockSize consecutive ids off a shared
+ * atomic counter and hands them out from thread-local storage, so the
+ * shared cache line is touched once per block instead of once per id.
+ * Ids are unique and increase within a thread, but threads interleave in
+ * blocks and a thread that stops allocating leaves the rest of its block
+ * unused, so the id space has gaps.
+ *
+ * Ids chosen elsewhere are announced with reserveThrough(), which raises a
+ * floor every later allocation stays above; a thread whose block lies
+ * below the floor skips ahead in it or carves a fresh one. An allocation
+ * re-reads the floor after taking its id, but one that overlaps a
+ * reservation can still return the reserved id, so callers mixing the two
+ * must detect the clash (ShardedDatabase retries on AlreadyExists).
+ */
+class IdAllocator {
+public:
+    static constexpr int kDefaultBlockSize = 64;
+
+    explicit IdAllocator(int firstId = 1, int blockSize = kDefaultBlockSize);
+    IdAllocator(const IdAllocator&) = delete;
+    IdAllocator& operator=(const IdAllocator&) = delete;
+
+    int allocate();
+
+    // Later allocations, on every thread, return ids above userId
+    void reserveThrough(int userId);
+
+    // Every id allocated or reserved so far is below this
+    int limit() const { return next_.load(std::memory_order_acquire); }
+
+    int blockSize() const { return block_size_; }
+
+private:
+    const uint64_t instance_;  // never reused, keys this allocator's thread-local blocks
+    const int block_size_;
+    std::atomic<int> next_;
+    std::atomic<int> floor_;
+};
+
+#endif // ID_ALLOCATOR_H
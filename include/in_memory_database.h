@@ -0,0 +1,182 @@
+#ifndef IN_MEMORY_DATABASE_H
+#define IN_MEMORY_DATABASE_H
+
+#include "age_index.h"
+#include "change_stream.h"
+#include "database_interface.h"
+#include "expression_evaluator.h"
+#include "huge_page_allocator.h"
+#include "hyperloglog.h"
+#include "materialized_view.h"
+#include "name_index.h"
+#include "query_parser.h"
+#include "roaring_bitmap.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * In-memory column store implementing DatabaseInterface
+ * User ids are assigned sequentially and double as row slots, so a point
+ * lookup is a bounds check plus one load per column. Deleted rows leave a
+ * tombstone in the live column. Readers share a reader/writer lock.
+ *
+ * An explicit id far enough ahead that the slots up to it would be mostly
+ * tombstones switches the instance to sparse ids for good: rows then take
+ * the next free slot, and an ordered id-to-slot map, plus a column of
+ * each slot's id, replace the arithmetic. A shard that receives only every
+ * Nth id of a wide range so keeps storage proportional to its own rows.
+ *
+ * An instance may own a strided id range (firstId, firstId + idStride, ...)
+ * so several instances can serve disjoint partitions of one id space.
+ * Column storage comes from HugePageMemory, optionally bound to one NUMA
+ * node; name bytes longer than the inline buffer stay on the regular heap.
+ *
+ * Arithmetic in column lists and WHERE comparisons is evaluated in
+ * batches of gathered rows by an ExpressionEvaluator.
+ *
+ * Distinct-name counts come from one HyperLogLog sketch per segment of
+ * kSketchSegmentRows slots. Sketches are built on first use and then follow
+ * inserts; a delete or rename cannot be taken out of a sketch, so it only
+ * marks its segment for a rebuild on the next distinct count.
+ */
+class InMemoryDatabase : public DatabaseInterface {
+public:
+    static constexpr size_t kSketchSegmentRows = 65536;
+
+    InMemoryDatabase() = default;
+    InMemoryDatabase(int firstId, int idStride, int numaNode = -1);
+    ~InMemoryDatabase() override = default;
+
+    // Connection management
+    bool connect(const std::string& connectionString) override;
+    void disconnect() override;
+    bool isConnected() const override;
+
+    // Data operations
+    bool insertUser(const std::string& name, int age) override;
+    bool insertUserWithId(int userId, const std::string& name, int age) override;
+    int insertUserReturningId(const std::string& name, int age) override;
+    std::string getUserName(int userId) override;
+    int getUserAge(int userId) override;
+    bool updateUser(int userId, const std::string& name, int age) override;
+    bool deleteUser(int userId) override;
+    DbStatus tryInsertUser(const std::string& name, int age) override;
+    DbStatus tryInsertUserWithId(int userId, const std::string& name, int age) override;
+    DbStatus tryUpdateUser(int userId, const std::string& name, int age) override;
+    DbStatus tryDeleteUser(int userId) override;
+    DbStatus tryGetUser(int userId, UserRecord& out) override;
+    // Typed insertUserReturningId; userId is set on success
+    DbStatus tryInsertUserReturningId(const std::string& name, int age, int& userId);
+    std::vector<UserRecord> getUsers(const std::vector<int>& userIds) override;
+    bool applyMutations(const std::vector<UserMutation>& mutations) override;
+    std::vector<UserRecord> listUsers(int afterId, size_t limit) override;
+
+    // Aggregate operations
+    std::vector<std::string> getAllUserNames() override;
+    int getUserCount() override;
+    bool executeQuery(const std::string& query, std::vector<std::string>& results) override;
+    bool mergeDistinctNames(const std::string& query, HyperLogLog& sketch) override;
+
+    // Estimated number of distinct names, within HyperLogLog error; -1 on failure
+    int64_t estimateDistinctNames();
+
+    // Error state
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Every committed insert/update/delete is published here, in commit order
+    void setChangeStream(std::shared_ptr<ChangeStream> stream);
+
+    // Attaches an incrementally maintained view, seeding it from existing rows
+    void addView(std::shared_ptr<MaterializedView> view);
+
+    // Attaches a name search index that also serves NAME LIKE queries
+    std::shared_ptr<NameIndex> enableNameIndex();
+
+    // Attaches an age bitmap index that serves AGE comparisons in queries
+    std::shared_ptr<AgeIndex> enableAgeIndex();
+
+    // Drops tombstone slots once they outnumber live rows by the margin that
+    // also triggers sparse ids, switching to sparse ids if needed; returns
+    // the slots dropped. Ids are kept, and new ids still follow the highest
+    size_t compact();
+
+private:
+    template <typename T>
+    using Column = std::vector<T, HugePageAllocator<T>>;
+
+    // Gathered id and age columns of one expression batch
+    struct ExpressionBatch {
+        std::vector<double> ids;
+        std::vector<double> ages;
+    };
+
+    struct NameSketch {
+        HyperLogLog sketch;
+        bool valid = false;
+    };
+
+    // Callers must hold mutex_
+    size_t slotOf(int userId) const;
+    int idOf(size_t slot) const;
+    int nextId() const;
+    bool isLive(int userId) const;
+    // Live slots in id order
+    std::vector<size_t> liveSlots() const;
+    void makeSparse();
+    std::vector<size_t> selectSlots(const ParsedQuery& query) const;
+    // Ids matching predicate; with within, only its ids are considered and
+    // only the result's intersection with it is exact
+    RoaringBitmap evaluate(const QueryPredicate& predicate, const RoaringBitmap* within = nullptr) const;
+    RoaringBitmap liveIds() const;
+    bool runQuery(const ParsedQuery& parsed, std::vector<std::string>& results) const;
+    ExpressionEvaluator::Batch loadBatch(const size_t* slots, size_t rows, ExpressionBatch& batch) const;
+    void projectColumns(const std::vector<QueryColumn>& columns, const std::vector<size_t>& slots,
+                        std::vector<std::string>& results) const;
+    bool distinctNames(const ParsedQuery& query, HyperLogLog& sketch) const;
+    void mergeNameSketches(HyperLogLog& sketch) const;
+    void commitInsert(int userId, const std::string& name, int age);
+    void commitUpdate(size_t slot, const std::string& name, int age);
+    void commitDelete(size_t slot);
+    void invalidateNameSketch(size_t slot);
+    // Untyped calls: false, with "Not connected" for getLastError, when down
+    bool checkConnected();
+    // Failures of typed calls only reach the calling thread's DbStatus
+    // detail; untyped calls pass them through report() to getLastError
+    DbStatus fail(DbError code, const char* message, const std::string& context = std::string());
+    bool report(DbStatus status);
+
+    mutable std::shared_mutex mutex_;
+    Column<std::string> names_;
+    Column<int> ages_;
+    Column<uint8_t> live_;
+    int live_count_ = 0;
+    int first_id_ = 1;
+    int id_stride_ = 1;
+    // Sparse ids only: slot -> id, id -> slot (tombstones keep their slot),
+    // and the id sequential inserts continue from
+    bool sparse_ = false;
+    Column<int> ids_;
+    std::map<int, size_t> slots_;
+    int next_id_ = 1;
+    std::shared_ptr<ChangeStream> changes_;
+    std::vector<std::shared_ptr<MaterializedView>> views_;
+    std::shared_ptr<NameIndex> name_index_;
+    std::shared_ptr<AgeIndex> age_index_;
+
+    // Rebuilt by readers under sketch_mutex_; writers hold mutex_ exclusively
+    mutable std::mutex sketch_mutex_;
+    mutable std::vector<NameSketch> name_sketches_;
+
+    std::atomic<bool> connected_{false};
+    // Last failure of an untyped call, for getLastError()
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+};
+
+#endif // IN_MEMORY_DATABASE_H
@@ -0,0 +1,71 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include "database_interface.h"
+#include "query_parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Streaming JSON writer over one growable buffer
+ * Values are appended directly as text: commas and colons are placed from
+ * a small nesting stack, integers go through the locale-free digit-pair
+ * formatter and strings are escaped sixteen bytes at a time with SSE2
+ * where available (scalar elsewhere). Bytes >= 0x80 pass through, so
+ * UTF-8 input stays UTF-8. The writer does not validate nesting.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(size_t initialCapacity = 256);
+    ~JsonWriter() = default;
+
+    // Structure
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(const std::string& name);
+
+    // Scalars
+    void value(const std::string& text);
+    void value(const char* text);
+    void value(const char* text, size_t length);
+    void value(int number);
+    void value(bool flag);
+    void nullValue();
+
+    // {"id":1,"name":"Alice","age":25}
+    void writeUser(const UserRecord& record);
+    // Array of user objects; records with an empty name are skipped
+    void writeUsers(const std::vector<UserRecord>& records);
+    // Array of the rows executeQuery returned for query, one JSON value per
+    // row: a user object for SELECT *, {"name":...} for SELECT NAME,
+    // {"count":n} for counts and an array of the listed columns otherwise.
+    // Names holding a comma split right unless NAME is listed twice.
+    // Returns false, writing nothing, if query does not parse
+    bool writeRows(const std::string& query, const std::vector<std::string>& rows);
+
+    const std::string& str() const { return buffer_; }
+    std::string take();
+    // Empties the output but keeps its capacity
+    void clear();
+
+    // Appends the escaped body of a JSON string (without quotes) to out
+    static void escape(std::string& out, const char* data, size_t length);
+
+private:
+    void beforeValue();
+    void open(char bracket);
+    void close(char bracket);
+    // Engine-formatted number text, or null if it is not finite
+    void number(const char* text, size_t length);
+    void writeColumns(const std::vector<QueryColumn>& columns, const std::string& row);
+
+    std::string buffer_;
+    std::vector<uint8_t> has_items_;  // one entry per open container
+    bool after_key_ = false;
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,72 @@
+#ifndef MATERIALIZED_VIEW_H
+#define MATERIALIZED_VIEW_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Aggregate over the users table maintained by delta propagation
+ * The engine calls the hooks for every committed mutation (and once per
+ * existing row when the view is attached), so reading the aggregate never
+ * scans the table. Hooks may be called concurrently by different
+ * partitions and must be thread-safe.
+ */
+class MaterializedView {
+public:
+    virtual ~MaterializedView() = default;
+
+    virtual void onInsert(int userId, const std::string& name, int age) = 0;
+    virtual void onDelete(int userId, const std::string& name, int age) = 0;
+
+    // Defaults to retracting the old row and applying the new one
+    virtual void onUpdate(int userId, const std::string& oldName, int oldAge,
+                          const std::string& newName, int newAge);
+};
+
+/**
+ * Number of users per fixed-width age bucket
+ * Bucket i covers ages [i * width, (i + 1) * width); the last bucket also
+ * takes every older age.
+ */
+class AgeBucketCountView : public MaterializedView {
+public:
+    AgeBucketCountView(int bucketWidth, size_t bucketCount);
+
+    void onInsert(int userId, const std::string& name, int age) override;
+    void onDelete(int userId, const std::string& name, int age) override;
+    void onUpdate(int userId, const std::string& oldName, int oldAge,
+                  const std::string& newName, int newAge) override;
+
+    size_t bucketOf(int age) const;
+    int64_t getCount(size_t bucket) const;
+    int64_t getCountForAge(int age) const { return getCount(bucketOf(age)); }
+    std::vector<int64_t> getCounts() const;
+    size_t getBucketCount() const { return counts_.size(); }
+
+private:
+    int bucket_width_;
+    std::vector<std::atomic<int64_t>> counts_;
+};
+
+/**
+ * Row count and age sum, giving the average age in constant time
+ */
+class AgeStatsView : public MaterializedView {
+public:
+    void onInsert(int userId, const std::string& name, int age) override;
+    void onDelete(int userId, const std::string& name, int age) override;
+    void onUpdate(int userId, const std::string& oldName, int oldAge,
+                  const std::string& newName, int newAge) override;
+
+    int64_t getCount() const { return count_.load(); }
+    int64_t getAgeSum() const { return age_sum_.load(); }
+    double getAverageAge() const;
+
+private:
+    std::atomic<int64_t> count_{0};
+    std::atomic<int64_t> age_sum_{0};
+};
+
+#endif // MATERIALIZED_VIEW_H
@@ -0,0 +1,73 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "pool_allocator.h"
+#include <atomic>
+#include <utility>
+
+/**
+ * Unbounded lock-free multi-producer single-consumer queue
+ * Intrusive linked list after Vyukov: producers publish with one atomic
+ * exchange, the single consumer pops without any read-modify-write.
+ * push() may be called from any thread; pop() and empty() only from the
+ * owning consumer thread. Nodes come from SlabPool, so the consumer's
+ * frees flow back to producers in batches.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        if (tail_ != &stub_) {
+            delete tail_;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node;
+        node->value = std::move(value);
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    bool pop(T& out) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        // The popped node becomes the new stub
+        out = std::move(next->value);
+        tail_ = next;
+        if (tail != &stub_) {
+            delete tail;
+        }
+        return true;
+    }
+
+    bool empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+
+        static void* operator new(size_t bytes) { return SlabPool::allocate(bytes); }
+        static void operator delete(void* pointer, size_t bytes) { SlabPool::deallocate(pointer, bytes); }
+    };
+
+    Node stub_;
+    std::atomic<Node*> head_;
+    Node* tail_;
+};
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,74 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include "materialized_view.h"
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A fuzzy search hit: the user and the edit distance of their name
+ */
+struct NameMatch {
+    int userId;
+    int distance;
+};
+
+/**
+ * Search index over user names, maintained as a materialized view
+ * Prefix lookups walk a radix tree whose edges carry whole label runs, so
+ * the depth is bounded by the number of branching points rather than the
+ * name length; tree nodes come from SlabPool. Substring lookups intersect
+ * the sorted posting lists of the pattern's trigrams, shortest list first,
+ * and confirm each candidate against the stored name. Patterns shorter than
+ * a trigram fall back to scanning the stored names. All results are user
+ * ids in ascending order; matching is case-sensitive.
+ *
+ * Fuzzy lookups keep only names within the length bound that share enough
+ * of the query's trigrams (one edit breaks at most three), then verify the
+ * survivors with the bit-parallel kernel in EditDistanceMatcher.
+ */
+class NameIndex : public MaterializedView {
+public:
+    NameIndex();
+    ~NameIndex() override;
+
+    NameIndex(const NameIndex&) = delete;
+    NameIndex& operator=(const NameIndex&) = delete;
+
+    void onInsert(int userId, const std::string& name, int age) override;
+    void onDelete(int userId, const std::string& name, int age) override;
+    void onUpdate(int userId, const std::string& oldName, int oldAge,
+                  const std::string& newName, int newAge) override;
+
+    std::vector<int> findPrefix(const std::string& prefix) const;
+    std::vector<int> findSubstring(const std::string& text) const;
+    // SQL LIKE: % matches any run, _ any single character
+    std::vector<int> findLike(const std::string& pattern) const;
+
+    // Names within maxDistance edits, nearest first, ties by user id
+    std::vector<NameMatch> findSimilar(const std::string& name, int maxDistance) const;
+
+    static bool likeMatch(const std::string& text, const std::string& pattern);
+
+    size_t size() const;
+
+private:
+    struct Node;
+
+    void insertName(int userId, const std::string& name);
+    void removeName(int userId, const std::string& name);
+    std::vector<int> substringLocked(const std::string& text) const;
+    std::vector<int> prefixLocked(const std::string& prefix) const;
+    static uint32_t trigramAt(const std::string& text, size_t position);
+    static std::vector<uint32_t> trigramsOf(const std::string& text);
+
+    mutable std::shared_mutex mutex_;
+    Node* root_;
+    std::unordered_map<uint32_t, std::vector<int>> postings_;
+    std::unordered_map<int, std::string> names_;
+};
+
+#endif // NAME_INDEX_H
@@ -0,0 +1,102 @@
+#ifndef PARTITIONED_DATABASE_H
+#define PARTITIONED_DATABASE_H
+
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Shared-nothing, thread-per-core DatabaseInterface
+ * Each partition is an InMemoryDatabase owned by one pinned worker thread
+ * and touched by no other thread. Callers never take a lock on user data:
+ * every operation is sent as a message on the owning worker's lock-free
+ * MPSC queue, and cross-partition operations scatter one message per
+ * partition and gather the replies.
+ *
+ * Partition p of N owns user ids p+1, p+1+N, p+1+2N, ... so routing a
+ * point operation is a single modulo. Inserts are spread round-robin.
+ */
+class PartitionedDatabase : public DatabaseInterface {
+public:
+    /**
+     * @param partitions number of worker threads; 0 picks hardware concurrency
+     */
+    explicit PartitionedDatabase(size_t partitions = 0);
+    ~PartitionedDatabase() override;
+
+    PartitionedDatabase(const PartitionedDatabase&) = delete;
+    PartitionedDatabase& operator=(const PartitionedDatabase&) = delete;
+
+    // Connection management
+    bool connect(const std::string& connectionString) override;
+    void disconnect() override;
+    bool isConnected() const override;
+
+    // Point operations, routed to the owning partition
+    bool insertUser(const std::string& name, int age) override;
+    bool insertUserWithId(int userId, const std::string& name, int age) override;
+    int insertUserReturningId(const std::string& name, int age) override;
+    std::string getUserName(int userId) override;
+    int getUserAge(int userId) override;
+    bool updateUser(int userId, const std::string& name, int age) override;
+    bool deleteUser(int userId) override;
+    std::vector<UserRecord> getUsers(const std::vector<int>& userIds) override;
+    std::vector<UserRecord> listUsers(int afterId, size_t limit) override;
+
+    // Typed point operations; a failure's detail is carried back from the
+    // owning worker to the calling thread
+    DbStatus tryInsertUser(const std::string& name, int age) override;
+    DbStatus tryInsertUserWithId(int userId, const std::string& name, int age) override;
+    DbStatus tryUpdateUser(int userId, const std::string& name, int age) override;
+    DbStatus tryDeleteUser(int userId) override;
+    DbStatus tryGetUser(int userId, UserRecord& out) override;
+
+    // Cross-partition operations, gathered from every partition
+    std::vector<std::string> getAllUserNames() override;
+    int getUserCount() override;
+    bool executeQuery(const std::string& query, std::vector<std::string>& results) override;
+    // Partition sketches are merged, so distinct names are counted once overall
+    bool mergeDistinctNames(const std::string& query, HyperLogLog& sketch) override;
+    int64_t estimateDistinctNames();
+
+    // Error state
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Partitions publish their mutations into the shared stream
+    void setChangeStream(std::shared_ptr<ChangeStream> stream);
+
+    // Every partition feeds the same view, so views must tolerate concurrent hooks
+    void addView(std::shared_ptr<MaterializedView> view);
+
+    size_t getPartitionCount() const { return partitions_.size(); }
+    size_t partitionOf(int userId) const;
+
+private:
+    struct Partition;
+    using Task = std::function<void(InMemoryDatabase&)>;
+
+    void submit(size_t partition, Task task);
+    template <typename R, typename Fn>
+    R call(size_t partition, Fn fn);
+    template <typename Fn>
+    DbStatus callTyped(size_t partition, Fn fn);
+    template <typename R, typename Fn>
+    std::vector<R> broadcast(Fn fn);
+
+    bool checkConnected();
+    void setError(const std::string& message);
+
+    std::vector<std::unique_ptr<Partition>> partitions_;
+    std::atomic<size_t> next_insert_{0};
+    std::atomic<bool> connected_{false};
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+};
+
+#endif // PARTITIONED_DATABASE_H
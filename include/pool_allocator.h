@@ -0,0 +1,72 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Size-class slab pool for small fixed-size engine objects
+ * Requests up to kMaxBlockSize bytes are rounded up to a 16-byte size
+ * class and served from 64 KB slabs. Each thread keeps a private free
+ * list per class, refilled from and returned to a central pool in batches
+ * so the central lock is taken once per batch rather than once per block.
+ * Blocks may be freed on a different thread than the one that allocated
+ * them. Larger requests go straight to the global heap.
+ */
+class SlabPool {
+public:
+    static constexpr size_t kGranularity = 16;
+    static constexpr size_t kMaxBlockSize = 512;
+    static constexpr size_t kSlabSize = 64 * 1024;
+    static constexpr size_t kBatchSize = 32;
+
+    struct ClassStats {
+        size_t blockSize = 0;
+        uint64_t allocations = 0;    // blocks handed out, including cached ones
+        uint64_t frees = 0;
+        uint64_t reservedBytes = 0;  // slab memory carved for this class
+
+        // Threads publish counters independently, so frees may briefly lead
+        uint64_t inUseBytes() const { return allocations > frees ? (allocations - frees) * blockSize : 0; }
+        // Share of reserved memory not holding a live block
+        double fragmentation() const;
+    };
+
+    static void* allocate(size_t bytes);
+    static void deallocate(void* pointer, size_t bytes) noexcept;
+
+    // Counters are published when a thread exchanges a batch with the central pool
+    static std::vector<ClassStats> getStats();
+    static ClassStats getStats(size_t bytes);
+};
+
+/**
+ * Stateless STL allocator drawing from SlabPool
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(SlabPool::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        SlabPool::deallocate(pointer, count * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+#endif // POOL_ALLOCATOR_H
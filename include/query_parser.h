@@ -0,0 +1,122 @@
+#ifndef QUERY_PARSER_H
+#define QUERY_PARSER_H
+
+#include <climits>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Column list of a SELECT
+ */
+enum class QueryProjection {
+    Star,   // id,name,age rows
+    Name,   // names only
+    Count,  // COUNT(*)
+    CountDistinctName,  // COUNT(DISTINCT NAME), estimated
+    Columns,  // comma-separated NAME and arithmetic over ID and AGE
+};
+
+enum class ExpressionKind {
+    Number,
+    Id,
+    Age,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    SquareRoot,
+};
+
+/**
+ * Arithmetic over the numeric columns
+ * Number leaves hold value; SquareRoot holds one operand and the other
+ * operators two. Unary minus is folded into literals and otherwise written
+ * as 0 - operand.
+ */
+struct QueryExpression {
+    ExpressionKind kind = ExpressionKind::Number;
+    double value = 0;
+    std::vector<QueryExpression> operands;
+};
+
+struct QueryColumn {
+    bool isName = false;         // NAME; otherwise expression
+    QueryExpression expression;
+};
+
+enum class CompareOp {
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+};
+
+enum class PredicateKind {
+    NameLike,  // NAME LIKE 'pattern', with % and _ wildcards
+    AgeRange,  // low <= AGE <= high
+    Compare,   // operands[0] op operands[1], for comparisons AgeRange cannot express
+    And,
+    Or,
+    Not,
+};
+
+/**
+ * WHERE clause node
+ */
+struct QueryPredicate {
+    PredicateKind kind = PredicateKind::NameLike;
+    std::string text;                     // pattern for NameLike
+    int low = INT_MIN;                    // inclusive bounds for AgeRange
+    int high = INT_MAX;
+    CompareOp op = CompareOp::Equal;      // for Compare
+    std::vector<QueryExpression> operands;
+    std::vector<QueryPredicate> children; // operands of And, Or and Not
+};
+
+struct ParsedQuery {
+    QueryProjection projection = QueryProjection::Star;
+    std::vector<QueryColumn> columns;  // for Columns
+    bool hasWhere = false;
+    QueryPredicate where;
+};
+
+/**
+ * Recursive-descent parser for the small SQL subset the engines accept
+ *
+ *   SELECT ( * | COUNT(*) | COUNT(DISTINCT NAME) | column { , column } ) FROM USERS
+ *          [ WHERE condition ] [;]
+ *
+ *   column     := NAME | expr
+ *   condition  := term { OR term }
+ *   term       := factor { AND factor }
+ *   factor     := NOT factor | '(' condition ')' | comparison
+ *   comparison := NAME LIKE 'pattern'
+ *               | expr ( = | != | <> | < | <= | > | >= ) expr
+ *               | expr BETWEEN expr AND expr
+ *   expr       := product { ( + | - ) product }
+ *   product    := unary { ( * | / ) unary }
+ *   unary      := - unary | number | ID | AGE | SQRT '(' expr ')' | '(' expr ')'
+ *
+ * A lone NAME column is the Name projection. Comparing a bare AGE with
+ * literals gives an AgeRange, which an age index can serve; any other
+ * comparison is a Compare over evaluated expressions.
+ *
+ * Keywords are case-insensitive and whitespace is free-form; string
+ * literals keep their case, with '' standing for a single quote.
+ *
+ * NOT, parentheses and unary operators may nest at most kMaxNesting deep,
+ * and an expression tree may be at most kMaxNesting operators high; deeper
+ * queries fail to parse rather than exhaust the stack.
+ */
+class QueryParser {
+public:
+    static constexpr size_t kMaxNesting = 128;
+
+    // Returns false and describes the problem in error when the query is not understood
+    static bool parse(const std::string& query, ParsedQuery& out, std::string& error);
+};
+
+#endif // QUERY_PARSER_H
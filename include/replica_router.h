@@ -0,0 +1,100 @@
+#ifndef REPLICA_ROUTER_H
+#define REPLICA_ROUTER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class DatabaseInterface;
+
+/**
+ * Replica routing settings
+ */
+struct ReplicaOptions {
+    // How long a caller's reads stay on the primary after its last write
+    std::chrono::milliseconds stickyWindow{1000};
+};
+
+/**
+ * Read/write splitter over one primary and any number of read replicas
+ * Writes always go to the primary. Reads go to the connected replica with
+ * the fewest outstanding requests, ties rotating so idle replicas share
+ * load. After a write, the writing thread's reads are pinned to the primary
+ * for the sticky window so it always reads its own writes despite replica
+ * lag. With no connected replica, reads fall back to the primary.
+ */
+class ReplicaRouter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Routed target; counts as outstanding on its replica until destroyed
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        DatabaseInterface& operator*() const { return *target_; }
+        DatabaseInterface* operator->() const { return target_; }
+        bool onPrimary() const { return outstanding_ == nullptr; }
+        void release();
+
+    private:
+        friend class ReplicaRouter;
+        Lease(DatabaseInterface* target, std::atomic<int>* outstanding, ReplicaRouter* writer);
+
+        DatabaseInterface* target_ = nullptr;
+        std::atomic<int>* outstanding_ = nullptr;
+        ReplicaRouter* writer_ = nullptr;
+    };
+
+    ReplicaRouter(std::shared_ptr<DatabaseInterface> primary,
+                  std::vector<std::shared_ptr<DatabaseInterface>> replicas,
+                  const ReplicaOptions& options = ReplicaOptions());
+    ~ReplicaRouter() = default;
+
+    ReplicaRouter(const ReplicaRouter&) = delete;
+    ReplicaRouter& operator=(const ReplicaRouter&) = delete;
+
+    // avoid names a replica to skip, e.g. the one a hedged read already waits on
+    Lease routeRead(const DatabaseInterface* avoid = nullptr);
+    // Routes to the primary; the caller's reads stick to it once the write ends
+    Lease routeWrite();
+
+    // True while the calling thread's reads are pinned to the primary
+    bool callerIsSticky() const;
+
+    // Connects every replica; returns how many are connected afterwards
+    size_t connectReplicas(const std::string& connectionString);
+
+    // Statistics
+    size_t getReplicaCount() const { return replicas_.size(); }
+    int getOutstanding(size_t replica) const;
+    uint64_t getPrimaryReads() const { return primary_reads_.load(std::memory_order_relaxed); }
+    uint64_t getReplicaReads() const { return replica_reads_.load(std::memory_order_relaxed); }
+
+private:
+    void markWrite();
+
+    std::shared_ptr<DatabaseInterface> primary_;
+    std::vector<std::shared_ptr<DatabaseInterface>> replicas_;
+    std::unique_ptr<std::atomic<int>[]> outstanding_;
+    ReplicaOptions options_;
+
+    // Keys this router in each thread's table of last write times
+    const uint64_t router_id_;
+    std::atomic<size_t> rotation_{0};
+    std::atomic<uint64_t> primary_reads_{0};
+    std::atomic<uint64_t> replica_reads_{0};
+};
+
+#endif // REPLICA_ROUTER_H
@@ -0,0 +1,85 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Compressed set of 32-bit integers in the Roaring layout
+ * Values are grouped by their high 16 bits into containers kept sorted by
+ * key. A container holds its low halves as a sorted uint16 array while it
+ * has at most kArrayMax entries and as a 65536-bit bitmap beyond that, so
+ * sparse and dense runs both stay compact. Bitmap-bitmap operations work
+ * on whole words, two at a time with SSE2 where available; every container
+ * tracks its cardinality, so counting a set never touches the values.
+ */
+class RoaringBitmap {
+public:
+    static constexpr uint32_t kArrayMax = 4096;
+
+    void add(uint32_t value);
+    void remove(uint32_t value);
+    bool contains(uint32_t value) const;
+
+    uint64_t cardinality() const;
+    bool empty() const { return containers_.empty(); }
+
+    RoaringBitmap& operator&=(const RoaringBitmap& other);
+    RoaringBitmap& operator|=(const RoaringBitmap& other);
+    // Removes every value present in other (AND NOT)
+    RoaringBitmap& operator-=(const RoaringBitmap& other);
+
+    // Size of the intersection without building it
+    uint64_t andCardinality(const RoaringBitmap& other) const;
+
+    bool operator==(const RoaringBitmap& other) const;
+    bool operator!=(const RoaringBitmap& other) const { return !(*this == other); }
+
+    // Calls fn for every value in ascending order
+    template <typename Fn>
+    void forEach(Fn fn) const;
+
+    std::vector<uint32_t> toVector() const;
+
+private:
+    struct Container {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> array;  // sorted low halves while sparse
+        std::vector<uint64_t> words;  // 1024-word bitmap once dense
+
+        bool dense() const { return !words.empty(); }
+    };
+
+    Container* find(uint16_t key);
+    const Container* find(uint16_t key) const;
+
+    std::vector<Container> containers_;
+};
+
+inline RoaringBitmap operator&(RoaringBitmap a, const RoaringBitmap& b) { return a &= b; }
+inline RoaringBitmap operator|(RoaringBitmap a, const RoaringBitmap& b) { return a |= b; }
+inline RoaringBitmap operator-(RoaringBitmap a, const RoaringBitmap& b) { return a -= b; }
+
+template <typename Fn>
+void RoaringBitmap::forEach(Fn fn) const {
+    for (const Container& container : containers_) {
+        const uint32_t high = static_cast<uint32_t>(container.key) << 16;
+        if (!container.dense()) {
+            for (uint16_t low : container.array) {
+                fn(high | low);
+            }
+            continue;
+        }
+        for (size_t i = 0; i < container.words.size(); ++i) {
+            uint64_t word = container.words[i];
+            while (word != 0) {
+                fn(high | static_cast<uint32_t>(i * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+#endif // ROARING_BITMAP_H
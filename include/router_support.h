@@ -0,0 +1,26 @@
+#ifndef ROUTER_SUPPORT_H
+#define ROUTER_SUPPORT_H
+
+#include "database_interface.h"
+#include "query_parser.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Helpers shared by the engines that fan one call out to several backends
+ * and combine the replies: PartitionedDatabase, ShardedDatabase and
+ * TieredDatabase
+ */
+class RouterSupport {
+public:
+    // Projection of query, from one parse. False when the query does not
+    // parse; routers then forward it anyway so a backend reports the error
+    static bool projectionOf(const std::string& query, QueryProjection& projection);
+
+    // First limit users of per-backend pages that are each in id order;
+    // records are moved out of pages
+    static std::vector<UserRecord> mergePages(std::vector<std::vector<UserRecord>>& pages, size_t limit);
+};
+
+#endif // ROUTER_SUPPORT_H
@@ -0,0 +1,91 @@
+#ifndef SHARDED_DATABASE_H
+#define SHARDED_DATABASE_H
+
+#include "database_interface.h"
+#include "id_allocator.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Client-side router spreading users over several DatabaseInterface backends
+ * The router owns the user id space: it assigns ids itself and places each
+ * user on backend jumpHash(id, N), using insertUserWithId on the backend.
+ * Ids come from an IdAllocator, so concurrent inserters draw from their
+ * own blocks and ids are unique but not dense. An InMemoryDatabase backend
+ * switches to sparse ids, so each shard stores only its own rows.
+ * Point operations touch exactly one backend; aggregates fan out to all
+ * backends in parallel and merge the replies. Adding a backend moves only
+ * the ~1/(N+1) of users that jump hash reassigns to it.
+ */
+class ShardedDatabase : public DatabaseInterface {
+public:
+    explicit ShardedDatabase(std::vector<std::shared_ptr<DatabaseInterface>> backends);
+    ~ShardedDatabase() override = default;
+
+    // Jump consistent hash (Lamping & Veach): bucket in [0, buckets)
+    static int32_t jumpHash(uint64_t key, int32_t buckets);
+
+    // Connection management; connect passes the string to every backend
+    bool connect(const std::string& connectionString) override;
+    void disconnect() override;
+    bool isConnected() const override;
+
+    // Point operations, routed to one backend
+    bool insertUser(const std::string& name, int age) override;
+    bool insertUserWithId(int userId, const std::string& name, int age) override;
+    int insertUserReturningId(const std::string& name, int age) override;
+    std::string getUserName(int userId) override;
+    int getUserAge(int userId) override;
+    bool updateUser(int userId, const std::string& name, int age) override;
+    bool deleteUser(int userId) override;
+    std::vector<UserRecord> getUsers(const std::vector<int>& userIds) override;
+    std::vector<UserRecord> listUsers(int afterId, size_t limit) override;
+
+    // Typed point operations, forwarded to the backend's typed calls
+    DbStatus tryInsertUser(const std::string& name, int age) override;
+    DbStatus tryInsertUserWithId(int userId, const std::string& name, int age) override;
+    DbStatus tryUpdateUser(int userId, const std::string& name, int age) override;
+    DbStatus tryDeleteUser(int userId) override;
+    DbStatus tryGetUser(int userId, UserRecord& out) override;
+
+    // Aggregate operations, fanned out to every backend
+    std::vector<std::string> getAllUserNames() override;
+    int getUserCount() override;
+    bool executeQuery(const std::string& query, std::vector<std::string>& results) override;
+    // Backend sketches are merged, so names on several shards count once
+    bool mergeDistinctNames(const std::string& query, HyperLogLog& sketch) override;
+
+    // Error state
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Adds a connected backend and migrates the users jump hash moves onto it
+    bool addBackend(std::shared_ptr<DatabaseInterface> backend);
+
+    size_t getBackendCount() const;
+    // Index of the backend that holds userId
+    size_t backendOf(int userId) const;
+
+private:
+    // Callers must hold backends_mutex_
+    size_t backendIndex(int userId) const;
+    DatabaseInterface& route(int userId) const;
+    bool insertRouted(int userId, const std::string& name, int age);
+    DbStatus insertAllocated(const std::string& name, int age, int& userId);
+    void setError(const std::string& message);
+    void captureError(DatabaseInterface& backend);
+
+    mutable std::shared_mutex backends_mutex_;
+    std::vector<std::shared_ptr<DatabaseInterface>> backends_;
+    IdAllocator ids_;
+
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+};
+
+#endif // SHARDED_DATABASE_H
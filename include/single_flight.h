@@ -0,0 +1,91 @@
+#ifndef SINGLE_FLIGHT_H
+#define SINGLE_FLIGHT_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Duplicate call suppression for concurrent identical requests
+ * The first caller for a key runs the function; callers arriving while it
+ * is in flight wait for and share its result (or exception) instead of
+ * issuing their own. Nothing is cached: once the call returns, the next
+ * caller for the key starts a new flight.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+class SingleFlight {
+public:
+    SingleFlight() = default;
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    template <typename Fn>
+    V run(const K& key, Fn&& fn) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = flights_.find(key);
+        if (it != flights_.end()) {
+            std::shared_future<V> shared = it->second.result;
+            lock.unlock();
+            shared_calls_.fetch_add(1, std::memory_order_relaxed);
+            return shared.get();
+        }
+
+        std::promise<V> promise;
+        const uint64_t generation = ++generation_;
+        flights_.emplace(key, Flight{promise.get_future().share(), generation});
+        lock.unlock();
+
+        try {
+            V value = fn();
+            finish(key, generation);
+            promise.set_value(value);
+            return value;
+        } catch (...) {
+            finish(key, generation);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    // Callers after this start a new flight even if one is still running,
+    // e.g. after a write that the running flight may not observe
+    void forget(const K& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flights_.erase(key);
+    }
+
+    size_t getInFlight() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return flights_.size();
+    }
+
+    // Calls answered by another caller's flight
+    uint64_t getSharedCalls() const { return shared_calls_.load(std::memory_order_relaxed); }
+
+private:
+    struct Flight {
+        std::shared_future<V> result;
+        uint64_t generation;
+    };
+
+    // Removes the flight unless forget() already replaced it with a newer one
+    void finish(const K& key, uint64_t generation) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = flights_.find(key);
+        if (it != flights_.end() && it->second.generation == generation) {
+            flights_.erase(it);
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<K, Flight, Hash> flights_;
+    uint64_t generation_ = 0;
+    std::atomic<uint64_t> shared_calls_{0};
+};
+
+#endif // SINGLE_FLIGHT_H
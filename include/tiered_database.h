@@ -0,0 +1,196 @@
+#ifndef TIERED_DATABASE_H
+#define TIERED_DATABASE_H
+
+#include "block_codec.h"
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Placement policy for TieredDatabase
+ */
+struct TieringOptions {
+    std::string directory;                        // cold segment files; created on connect
+    size_t maxHotRows = 0;                        // sweeps demote the least-read rows beyond this; 0 = no cap
+    size_t segmentRows = 4096;                    // demoted rows per segment file
+    std::chrono::milliseconds sweepInterval{0};   // background sweep period; 0 sweeps only on request
+};
+
+/**
+ * Tier sizes and point-read hit counts
+ */
+struct TierStats {
+    size_t hotRows = 0;
+    size_t coldRows = 0;
+    size_t coldSegments = 0;
+    uint64_t coldBytes = 0;   // compressed bytes on disk
+    uint64_t hotHits = 0;     // point reads served from memory
+    uint64_t coldHits = 0;    // point reads that had to promote a cold row
+    uint64_t promotions = 0;  // cold rows brought back by reads and writes
+    uint64_t demotions = 0;
+
+    // Share of point reads served from memory; 1 before any read
+    double hitRatio() const;
+};
+
+/**
+ * Two-tier engine: hot rows in an InMemoryDatabase, cold rows on disk
+ * Every hot row has a saturating read counter. A sweep works like a CLOCK
+ * pass: rows not read since the previous sweep are demoted, then, if the
+ * hot tier is still above maxHotRows, the rows with the lowest counts; the
+ * survivors' counts are halved so old popularity fades. Demoted rows are
+ * written in id order to segment files of segmentRows rows, compressed
+ * with BlockCodec. In memory a cold row costs only its id, kept in the
+ * sorted id list of its segment, and a sweep asks the hot engine to
+ * compact away the tombstones the demoted rows left.
+ *
+ * Reading or updating a cold row promotes it back into the
+ * hot tier under its own id; the last decoded segment is cached, so a run
+ * of cold reads from one segment decompresses it once. A segment's file is
+ * removed once none of its rows is still cold. Scans (listUsers, counts,
+ * executeQuery) read both tiers without promoting anything. Unfiltered
+ * counts need no segment; other scans decode the segments one at a time,
+ * so at most one segment's rows are in memory per scan.
+ *
+ * Point reads on hot rows share a reader/writer lock; writes and
+ * promotions take it exclusively. A sweep ranks rows under the shared
+ * lock, writes its segments holding neither, and takes the lock
+ * exclusively only to move the rows; a row written meanwhile stays hot.
+ * Segment files carry the process id and an instance number, so
+ * instances sharing a directory never collide, and are deleted with the
+ * instance.
+ */
+class TieredDatabase : public DatabaseInterface {
+public:
+    explicit TieredDatabase(const TieringOptions& options);
+    ~TieredDatabase() override;
+
+    TieredDatabase(const TieredDatabase&) = delete;
+    TieredDatabase& operator=(const TieredDatabase&) = delete;
+
+    // Connection management; connect also creates the segment directory
+    bool connect(const std::string& connectionString) override;
+    void disconnect() override;
+    bool isConnected() const override;
+
+    // Point operations; cold rows are promoted on access
+    bool insertUser(const std::string& name, int age) override;
+    bool insertUserWithId(int userId, const std::string& name, int age) override;
+    int insertUserReturningId(const std::string& name, int age) override;
+    std::string getUserName(int userId) override;
+    int getUserAge(int userId) override;
+    bool updateUser(int userId, const std::string& name, int age) override;
+    bool deleteUser(int userId) override;
+    std::vector<UserRecord> listUsers(int afterId, size_t limit) override;
+
+    // Typed point operations; failures stay with the calling thread
+    DbStatus tryInsertUser(const std::string& name, int age) override;
+    DbStatus tryInsertUserWithId(int userId, const std::string& name, int age) override;
+    DbStatus tryUpdateUser(int userId, const std::string& name, int age) override;
+    DbStatus tryDeleteUser(int userId) override;
+    DbStatus tryGetUser(int userId, UserRecord& out) override;
+
+    // Aggregate operations over both tiers
+    std::vector<std::string> getAllUserNames() override;
+    int getUserCount() override;
+    bool executeQuery(const std::string& query, std::vector<std::string>& results) override;
+    bool mergeDistinctNames(const std::string& query, HyperLogLog& sketch) override;
+
+    // Error state
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Runs one demotion pass; returns the rows demoted, or -1 on failure
+    int sweep();
+
+    TierStats getStats() const;
+
+private:
+    struct Segment {
+        std::string path;
+        std::vector<int> ids;  // rows of this file that are still cold, ascending
+        uint64_t bytes = 0;
+    };
+
+    // A segment written by a sweep, with the rows as they were copied
+    struct PendingSegment {
+        uint32_t number = 0;
+        Segment segment;
+        std::vector<UserRecord> rows;
+    };
+
+    DbStatus insertHot(const std::string& name, int age, int& userId);
+    DbStatus readUser(int userId, UserRecord& out);
+    bool findUser(int userId, UserRecord& out);  // readUser for the untyped API
+
+    // Callers hold mutex_ shared or exclusive as noted
+    void touch(int userId);                           // shared
+    void setHeat(int userId, uint8_t heat);           // exclusive
+    DbStatus promote(int userId, UserRecord& out);    // exclusive
+    void rank(std::vector<int>& demoting);            // shared
+    size_t install(std::vector<PendingSegment>& written);     // exclusive
+    uint32_t segmentOf(int userId) const;             // shared; 0 if not cold
+    void dropColdRow(uint32_t segment, int userId);   // exclusive
+    // Failures of these are recorded as the calling thread's DbStatus detail
+    bool loadSegment(uint32_t segment, std::vector<UserRecord>& rows) const;
+    bool coldRecords(const std::vector<int>& userIds, std::vector<UserRecord>& out) const;
+    // Shared; fn gets each segment's still-cold rows, or a scratch engine
+    // holding them, and stops the scan by returning false
+    template <typename Fn>
+    bool forEachColdSegment(Fn fn) const;
+    template <typename Fn>
+    bool forEachColdEngine(Fn fn) const;
+
+    // Called with only sweep_run_mutex_ held
+    bool writeSegments(std::vector<int>& userIds, std::vector<PendingSegment>& written);
+
+    void run();
+    void setError(const std::string& message) const;
+    void captureError() const;
+    bool report(DbStatus status) const;  // publishes a failure's detail
+
+    TieringOptions options_;
+    BlockCodec codec_;
+    mutable InMemoryDatabase hot_;  // its read calls are not const
+
+    mutable std::shared_mutex mutex_;
+    // Saturating read counts of hot rows by id, so memory follows the hot
+    // row count rather than the largest id. Entries are added and erased
+    // under mutex_ exclusive; readers bump them with relaxed load/store, so
+    // concurrent readers may lose an increment, which only blurs the ranking
+    std::unordered_map<int, std::atomic<uint8_t>> heat_;
+    std::map<uint32_t, Segment> segments_;  // by number, so in write order
+    size_t cold_rows_ = 0;
+    uint32_t cached_segment_ = 0;   // 0 = nothing cached
+    std::vector<UserRecord> cached_rows_;
+
+    // One sweep at a time; segment numbers are drawn under it
+    std::mutex sweep_run_mutex_;
+    std::string segment_prefix_;    // directory/segment-<pid>-<instance>-
+    uint32_t next_segment_ = 1;
+
+    std::atomic<uint64_t> hot_hits_{0};
+    std::atomic<uint64_t> cold_hits_{0};
+    std::atomic<uint64_t> promotions_{0};
+    std::atomic<uint64_t> demotions_{0};
+
+    mutable std::mutex error_mutex_;
+    mutable std::string last_error_;
+
+    std::mutex sweep_mutex_;
+    std::condition_variable sweep_wake_;
+    bool stopping_ = false;
+    std::thread sweeper_;
+};
+
+#endif // TIERED_DATABASE_H
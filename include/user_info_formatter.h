@@ -0,0 +1,34 @@
+#ifndef USER_INFO_FORMATTER_H
+#define USER_INFO_FORMATTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Renders "Name: <name>, Age: <age>" without temporaries
+ * The exact output length is computed up front, so a destination is sized
+ * once and the text is written straight into it; integers are converted two
+ * digits at a time from a lookup table. Reusing the same std::string across
+ * calls therefore allocates only when a longer line than before appears.
+ */
+class UserInfoFormatter {
+public:
+    // Bytes format() writes for this name and age
+    static size_t formattedLength(size_t nameLength, int age);
+
+    // Writes formattedLength() bytes at dest and returns the end pointer
+    static char* format(char* dest, const char* name, size_t nameLength, int age);
+
+    // Replaces out's contents, keeping its capacity
+    static void formatInto(std::string& out, const std::string& name, int age);
+
+    // Appends the line followed by separator (none when separator is '\0')
+    static void append(std::string& out, const std::string& name, int age, char separator = '\0');
+
+    // Decimal digits of value, and the conversion itself
+    static size_t digitCount(uint32_t value);
+    static char* writeInt(char* dest, int value);
+};
+
+#endif // USER_INFO_FORMATTER_H
@@ -0,0 +1,79 @@
+#ifndef WRITE_BEHIND_H
+#define WRITE_BEHIND_H
+
+#include "database_interface.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Write-behind flush thresholds
+ */
+struct WriteBehindOptions {
+    size_t maxBatch = 256;                 // flush once this many writes are pending
+    std::chrono::milliseconds maxDelay{5}; // or once the oldest has waited this long
+};
+
+/**
+ * Buffers writes and applies them asynchronously in batches
+ * A background thread hands pending writes to the sink as one batch when
+ * the size or age threshold is reached. Writes to a user that still has a
+ * pending update or delete are merged into it: a later update replaces the
+ * earlier one, a delete supersedes a pending update. Inserts carry no id
+ * and are never merged. flush() is the durability barrier.
+ */
+class WriteBehindQueue {
+public:
+    using Sink = std::function<bool(const std::vector<UserMutation>&)>;
+
+    explicit WriteBehindQueue(Sink sink, const WriteBehindOptions& options = WriteBehindOptions());
+    // Applies everything still pending before returning
+    ~WriteBehindQueue();
+
+    WriteBehindQueue(const WriteBehindQueue&) = delete;
+    WriteBehindQueue& operator=(const WriteBehindQueue&) = delete;
+
+    void enqueue(UserMutation mutation);
+
+    // Blocks until every write enqueued before the call has been applied;
+    // false if any batch failed since the previous flush
+    bool flush();
+    // Waits like flush() but leaves failures for the next flush to report
+    void drain();
+
+    // Statistics
+    uint64_t getEnqueued() const;
+    uint64_t getCoalesced() const;
+    uint64_t getBatches() const;
+    size_t getPending() const;
+
+private:
+    void run();
+    void waitApplied(std::unique_lock<std::mutex>& lock);
+
+    Sink sink_;
+    WriteBehindOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;      // signals the flusher
+    std::condition_variable applied_;   // signals flush() callers
+    std::vector<UserMutation> pending_;
+    std::unordered_map<int, size_t> pending_by_user_;  // user id -> index in pending_
+    std::chrono::steady_clock::time_point oldest_;
+    uint64_t enqueued_ = 0;
+    uint64_t applied_through_ = 0;      // enqueue count covered by applied batches
+    uint64_t coalesced_ = 0;
+    uint64_t batches_ = 0;
+    size_t flush_waiters_ = 0;
+    bool failed_ = false;
+    bool stopping_ = false;
+
+    std::thread flusher_;
+};
+
+#endif // WRITE_BEHIND_H
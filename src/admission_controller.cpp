@@ -0,0 +1,172 @@
+#include "admission_controller.h"
+#include <algorithm>
+
+namespace {
+
+// Weight of the newest sample in the latency moving average
+constexpr double kLatencySmoothing = 0.2;
+
+size_t indexOf(RequestPriority priority) {
+    return static_cast<size_t>(priority);
+}
+
+} // namespace
+
+AdmissionController::Ticket::Ticket(AdmissionController* controller, RequestPriority priority)
+    : controller_(controller), priority_(priority), start_(Clock::now()) {
+}
+
+AdmissionController::Ticket::Ticket(Ticket&& other) noexcept
+    : controller_(other.controller_), priority_(other.priority_), start_(other.start_) {
+    other.controller_ = nullptr;
+}
+
+AdmissionController::Ticket& AdmissionController::Ticket::operator=(Ticket&& other) noexcept {
+    if (this != &other) {
+        release();
+        controller_ = other.controller_;
+        priority_ = other.priority_;
+        start_ = other.start_;
+        other.controller_ = nullptr;
+    }
+    return *this;
+}
+
+AdmissionController::Ticket::~Ticket() {
+    release();
+}
+
+void AdmissionController::Ticket::release() {
+    if (controller_ != nullptr) {
+        controller_->finish(priority_, Clock::now() - start_);
+        controller_ = nullptr;
+    }
+}
+
+AdmissionController::AdmissionController(const AdmissionOptions& options) {
+    for (ClassState& state : classes_) {
+        state.options = options;
+        state.limit = std::min(std::max(options.initialLimit, options.minLimit), options.maxLimit);
+    }
+}
+
+void AdmissionController::configure(RequestPriority priority, const AdmissionOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ClassState& state = classes_[indexOf(priority)];
+    state.options = options;
+    state.limit = std::min(std::max(options.initialLimit, options.minLimit), options.maxLimit);
+}
+
+AdmissionController::Ticket AdmissionController::admit(RequestPriority priority) {
+    Clock::duration timeout;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timeout = classes_[indexOf(priority)].options.queueTimeout;
+    }
+    return admit(priority, Clock::now() + timeout);
+}
+
+AdmissionController::Ticket AdmissionController::admit(RequestPriority priority,
+                                                       Clock::time_point deadline) {
+    const size_t index = indexOf(priority);
+    std::unique_lock<std::mutex> lock(mutex_);
+    ClassState& state = classes_[index];
+
+    if (canAdmit(index)) {
+        ++state.inFlight;
+        ++state.admitted;
+        return Ticket(this, priority);
+    }
+
+    if (state.queued >= state.options.maxQueueDepth) {
+        ++state.rejected;
+        return Ticket();
+    }
+
+    // Reject up front when the queue ahead cannot drain before the deadline
+    if (state.avgLatencyUs > 0.0) {
+        double expectedWaitUs = (state.queued + 1) * state.avgLatencyUs / std::max(state.limit, 1.0);
+        auto expectedWait = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::micro>(expectedWaitUs));
+        if (Clock::now() + expectedWait > deadline) {
+            ++state.rejected;
+            return Ticket();
+        }
+    }
+
+    ++state.queued;
+    bool ready = state.ready.wait_until(lock, deadline, [this, index]() { return canAdmit(index); });
+    --state.queued;
+
+    // Lower classes may have been held back by this waiter
+    for (ClassState& other : classes_) {
+        other.ready.notify_all();
+    }
+
+    if (!ready) {
+        ++state.rejected;
+        return Ticket();
+    }
+    ++state.inFlight;
+    ++state.admitted;
+    return Ticket(this, priority);
+}
+
+double AdmissionController::getLimit(RequestPriority priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return classes_[indexOf(priority)].limit;
+}
+
+size_t AdmissionController::getInFlight(RequestPriority priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return classes_[indexOf(priority)].inFlight;
+}
+
+size_t AdmissionController::getQueued(RequestPriority priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return classes_[indexOf(priority)].queued;
+}
+
+uint64_t AdmissionController::getAdmitted(RequestPriority priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return classes_[indexOf(priority)].admitted;
+}
+
+uint64_t AdmissionController::getRejected(RequestPriority priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return classes_[indexOf(priority)].rejected;
+}
+
+bool AdmissionController::canAdmit(size_t index) const {
+    for (size_t higher = 0; higher < index; ++higher) {
+        if (classes_[higher].queued > 0) {
+            return false;
+        }
+    }
+    const ClassState& state = classes_[index];
+    return state.inFlight < std::max<size_t>(1, static_cast<size_t>(state.limit));
+}
+
+void AdmissionController::finish(RequestPriority priority, Clock::duration latency) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ClassState& state = classes_[indexOf(priority)];
+    --state.inFlight;
+
+    double latencyUs = std::chrono::duration<double, std::micro>(latency).count();
+    state.avgLatencyUs = state.avgLatencyUs == 0.0
+        ? latencyUs
+        : (1.0 - kLatencySmoothing) * state.avgLatencyUs + kLatencySmoothing * latencyUs;
+
+    // AIMD: grow only while the limit is actually being used
+    if (latency <= state.options.targetLatency) {
+        if (state.inFlight + 1 >= state.limit / 2) {
+            state.limit = std::min(state.options.maxLimit, state.limit + 1.0 / state.limit);
+        }
+    } else {
+        state.limit = std::max(state.options.minLimit, state.limit * state.options.backoffRatio);
+    }
+
+    for (ClassState& other : classes_) {
+        other.ready.notify_all();
+    }
+}
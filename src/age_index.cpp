@@ -0,0 +1,53 @@
+#include "age_index.h"
+#include <climits>
+#include <mutex>
+
+void AgeIndex::onInsert(int userId, const std::string& name, int age) {
+    (void)name;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    by_age_[age].add(static_cast<uint32_t>(userId));
+}
+
+void AgeIndex::onDelete(int userId, const std::string& name, int age) {
+    (void)name;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = by_age_.find(age);
+    if (it == by_age_.end()) {
+        return;
+    }
+    it->second.remove(static_cast<uint32_t>(userId));
+    if (it->second.empty()) {
+        by_age_.erase(it);
+    }
+}
+
+void AgeIndex::onUpdate(int userId, const std::string& oldName, int oldAge,
+                        const std::string& newName, int newAge) {
+    // Renames do not move the user between bitmaps
+    if (oldAge != newAge) {
+        MaterializedView::onUpdate(userId, oldName, oldAge, newName, newAge);
+    }
+}
+
+RoaringBitmap AgeIndex::findRange(int low, int high) const {
+    RoaringBitmap ids;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (auto it = by_age_.lower_bound(low); it != by_age_.end() && it->first <= high; ++it) {
+        ids |= it->second;
+    }
+    return ids;
+}
+
+uint64_t AgeIndex::countRange(int low, int high) const {
+    // Ages partition the users, so per-age cardinalities simply add up
+    uint64_t count = 0;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (auto it = by_age_.lower_bound(low); it != by_age_.end() && it->first <= high; ++it) {
+        count += it->second.cardinality();
+    }
+    return count;
+}
+
+uint64_t AgeIndex::size() const {
+    return countRange(INT_MIN, INT_MAX);
+}
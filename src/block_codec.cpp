@@ -0,0 +1,337 @@
+#include "block_codec.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 65535;
+constexpr int kHashBits = 12;
+constexpr uint32_t kStoredFlag = 0x80000000u;
+constexpr uint8_t kMagic[4] = {'L', 'Z', 'B', '1'};
+constexpr size_t kFrameHeaderSize = 4 + 4 + 4 + 8;
+constexpr size_t kBlockHeaderSize = 4 + 4;
+// Most output one stored byte can decode to: a length byte of 255
+constexpr size_t kMaxExpansion = 255;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+void putLength(std::vector<uint8_t>& out, size_t len) {
+    while (len >= 255) {
+        out.push_back(255);
+        len -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(len));
+}
+
+void emitSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLen,
+                  size_t offset, size_t matchLen) {
+    size_t matchCode = matchLen >= kMinMatch ? matchLen - kMinMatch : 0;
+    uint8_t token = static_cast<uint8_t>((std::min<size_t>(literalLen, 15) << 4) |
+                                         std::min<size_t>(matchCode, 15));
+    out.push_back(token);
+    if (literalLen >= 15) {
+        putLength(out, literalLen - 15);
+    }
+    out.insert(out.end(), literals, literals + literalLen);
+    if (matchLen == 0) {
+        return;
+    }
+    out.push_back(static_cast<uint8_t>(offset & 0xff));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        putLength(out, matchCode - 15);
+    }
+}
+
+size_t readLength(const uint8_t*& ip, const uint8_t* end, size_t base) {
+    if (base != 15) {
+        return base;
+    }
+    size_t len = base;
+    uint8_t b;
+    do {
+        if (ip >= end) {
+            throw std::runtime_error("Corrupt block: truncated length");
+        }
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return len;
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+void put64(std::vector<uint8_t>& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+uint64_t getLE(const uint8_t* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+// Runs fn(i) for i in [0, count) on up to `threads` workers
+template <typename Fn>
+void parallelFor(size_t count, unsigned threads, Fn fn) {
+    size_t workers = std::min<size_t>(threads, count);
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto worker = [&]() {
+        for (size_t i = next++; i < count && !failed; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                if (!failed.exchange(true)) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t t = 1; t < workers; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Decodes one block straight into its final position in the output buffer
+void decodeInto(const uint8_t* data, size_t size, uint8_t* dst, size_t rawSize) {
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + rawSize;
+    const uint8_t* ip = data;
+    const uint8_t* const iend = data + size;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        size_t literalLen = readLength(ip, iend, token >> 4);
+        if (literalLen > static_cast<size_t>(iend - ip) ||
+            literalLen > static_cast<size_t>(oend - op)) {
+            throw std::runtime_error("Corrupt block: literal run out of bounds");
+        }
+        std::memcpy(op, ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+
+        if (ip == iend) {
+            break;
+        }
+
+        if (iend - ip < 2) {
+            throw std::runtime_error("Corrupt block: truncated offset");
+        }
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t matchLen = readLength(ip, iend, token & 0x0f) + kMinMatch;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) ||
+            matchLen > static_cast<size_t>(oend - op)) {
+            throw std::runtime_error("Corrupt block: match out of bounds");
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= matchLen) {
+            std::memcpy(op, match, matchLen);
+            op += matchLen;
+        } else {
+            // Overlapping copy replicates the last `offset` bytes
+            for (size_t i = 0; i < matchLen; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    if (op != oend) {
+        throw std::runtime_error("Corrupt block: size mismatch");
+    }
+}
+
+} // namespace
+
+BlockCodec::BlockCodec(size_t blockSize, unsigned threads)
+    : block_size_(blockSize), threads_(threads) {
+    if (block_size_ == 0 || block_size_ > (kStoredFlag - 1)) {
+        throw std::invalid_argument("Block size out of range");
+    }
+    if (threads_ == 0) {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<uint8_t> BlockCodec::compressBlock(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> out;
+    out.reserve(size + size / 255 + 16);
+
+    uint32_t table[1 << kHashBits] = {};
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos + kMinMatch <= size) {
+        uint32_t sequence = read32(data + pos);
+        uint32_t& slot = table[hash4(sequence)];
+        size_t candidate = slot;
+        slot = static_cast<uint32_t>(pos + 1);
+
+        if (candidate != 0 && pos - (candidate - 1) <= kMaxOffset &&
+            read32(data + candidate - 1) == sequence) {
+            size_t ref = candidate - 1;
+            size_t len = kMinMatch;
+            while (pos + len < size && data[ref + len] == data[pos + len]) {
+                ++len;
+            }
+            emitSequence(out, data + anchor, pos - anchor, pos - ref, len);
+            pos += len;
+            anchor = pos;
+        } else {
+            // Skip faster through incompressible stretches
+            pos += 1 + ((pos - anchor) >> 6);
+        }
+    }
+
+    emitSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+std::vector<uint8_t> BlockCodec::decompressBlock(const uint8_t* data, size_t size, size_t rawSize) {
+    std::vector<uint8_t> out(rawSize);
+    decodeInto(data, size, out.data(), rawSize);
+    return out;
+}
+
+std::vector<uint8_t> BlockCodec::compress(const std::vector<uint8_t>& input) const {
+    size_t blockCount = (input.size() + block_size_ - 1) / block_size_;
+    std::vector<std::vector<uint8_t>> blocks(blockCount);
+
+    parallelFor(blockCount, threads_, [&](size_t i) {
+        size_t offset = i * block_size_;
+        size_t length = std::min(block_size_, input.size() - offset);
+        blocks[i] = compressBlock(input.data() + offset, length);
+        if (blocks[i].size() >= length) {
+            blocks[i].clear();
+        }
+    });
+
+    std::vector<uint8_t> out(std::begin(kMagic), std::end(kMagic));
+    put32(out, static_cast<uint32_t>(block_size_));
+    put32(out, static_cast<uint32_t>(blockCount));
+    put64(out, input.size());
+    for (size_t i = 0; i < blockCount; ++i) {
+        size_t offset = i * block_size_;
+        size_t length = std::min(block_size_, input.size() - offset);
+        put32(out, static_cast<uint32_t>(length));
+        if (blocks[i].empty()) {
+            put32(out, static_cast<uint32_t>(length) | kStoredFlag);
+            out.insert(out.end(), input.begin() + offset, input.begin() + offset + length);
+        } else {
+            put32(out, static_cast<uint32_t>(blocks[i].size()));
+            out.insert(out.end(), blocks[i].begin(), blocks[i].end());
+        }
+    }
+    return out;
+}
+
+std::vector<uint8_t> BlockCodec::decompress(const std::vector<uint8_t>& framed) const {
+    if (framed.size() < kFrameHeaderSize ||
+        !std::equal(std::begin(kMagic), std::end(kMagic), framed.begin())) {
+        throw std::runtime_error("Corrupt frame: bad header");
+    }
+    size_t blockSize = getLE(framed.data() + 4, 4);
+    size_t blockCount = getLE(framed.data() + 8, 4);
+    uint64_t rawSize = getLE(framed.data() + 12, 8);
+    // Nothing is allocated from a header field until the input can back it:
+    // the block count by the block headers present, each block's raw length
+    // by what its stored bytes can expand to, and rawSize by their sum
+    if (blockSize == 0 || blockSize > block_size_) {
+        throw std::runtime_error("Corrupt frame: block size out of range");
+    }
+    if (blockCount > (framed.size() - kFrameHeaderSize) / kBlockHeaderSize) {
+        throw std::runtime_error("Corrupt frame: block count exceeds input");
+    }
+
+    // Index the blocks first so they can be decoded independently
+    struct BlockRef {
+        size_t input;
+        size_t stored;
+        size_t output;
+        size_t raw;
+        bool isRaw;
+    };
+    std::vector<BlockRef> refs;
+    refs.reserve(blockCount);
+    size_t ip = kFrameHeaderSize;
+    size_t op = 0;
+    for (size_t i = 0; i < blockCount; ++i) {
+        if (framed.size() - ip < kBlockHeaderSize) {
+            throw std::runtime_error("Corrupt frame: truncated block header");
+        }
+        size_t raw = getLE(framed.data() + ip, 4);
+        uint32_t stored = static_cast<uint32_t>(getLE(framed.data() + ip + 4, 4));
+        ip += kBlockHeaderSize;
+        if (raw > blockSize) {
+            throw std::runtime_error("Corrupt frame: block exceeds block size");
+        }
+        size_t storedLen = stored & ~kStoredFlag;
+        if (framed.size() - ip < storedLen) {
+            throw std::runtime_error("Corrupt frame: truncated block");
+        }
+        const bool isRaw = (stored & kStoredFlag) != 0;
+        if (isRaw ? storedLen != raw : raw > storedLen * kMaxExpansion) {
+            throw std::runtime_error("Corrupt frame: block length exceeds stored data");
+        }
+        refs.push_back({ip, storedLen, op, raw, isRaw});
+        ip += storedLen;
+        op += raw;
+    }
+    if (op != rawSize || ip != framed.size()) {
+        throw std::runtime_error("Corrupt frame: size mismatch");
+    }
+
+    std::vector<uint8_t> out(rawSize);
+    parallelFor(refs.size(), threads_, [&](size_t i) {
+        const BlockRef& ref = refs[i];
+        const uint8_t* src = framed.data() + ref.input;
+        if (ref.isRaw) {
+            std::memcpy(out.data() + ref.output, src, ref.raw);
+        } else {
+            decodeInto(src, ref.stored, out.data() + ref.output, ref.raw);
+        }
+    });
+    return out;
+}
@@ -22,6 +22,37 @@ double Calculator::divide(double a, double b) {
     return a / b;
 }
 
+void Calculator::add(const double* a, const double* b, double* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+void Calculator::subtract(const double* a, const double* b, double* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+void Calculator::multiply(const double* a, const double* b, double* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+void Calculator::divide(const double* a, const double* b, double* out, size_t count) {
+    size_t zeros = 0;
+    for (size_t i = 0; i < count; ++i) {
+        zeros += b[i] == 0.0;
+    }
+    if (zeros != 0) {
+        throw std::invalid_argument("Division by zero");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = a[i] / b[i];
+    }
+}
+
 bool Calculator::isPositive(int number) {
     return number > 0;
 }
@@ -70,6 +101,19 @@ long long Calculator::factorial(int n) {
     return result;
 }
 
+void Calculator::squareRoot(const double* a, double* out, size_t count) {
+    size_t negatives = 0;
+    for (size_t i = 0; i < count; ++i) {
+        negatives += a[i] < 0.0;
+    }
+    if (negatives != 0) {
+        throw std::invalid_argument("Square root is not defined for negative numbers");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = std::sqrt(a[i]);
+    }
+}
+
 double Calculator::squareRoot(double x) {
     if (x < 0) {
         throw std::invalid_argument("Square root is not defined for negative numbers");
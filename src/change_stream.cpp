@@ -0,0 +1,123 @@
+#include "change_stream.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr size_t kWordBytes = sizeof(uint64_t);
+constexpr size_t kMinNameWords = 4;
+
+} // namespace
+
+ChangeStream::Subscriber::Subscriber(const ChangeStream* stream, uint64_t cursor)
+    : stream_(stream), cursor_(cursor) {
+}
+
+ChangeStream::PollResult ChangeStream::Subscriber::poll(ChangeRecord& out) {
+    const uint64_t head = stream_->next_.load(std::memory_order_acquire);
+    if (cursor_ >= head) {
+        return PollResult::Empty;
+    }
+
+    const uint64_t capacity = stream_->getCapacity();
+    const uint64_t oldest = head > capacity ? head - capacity : 0;
+    if (cursor_ >= oldest) {
+        const Slot& slot = stream_->slots_[cursor_ & stream_->mask_];
+        const uint64_t stored = 2 * cursor_ + 2;
+        const uint64_t version = slot.version.load(std::memory_order_acquire);
+        if (version < stored) {
+            // Sequence claimed but the publisher has not stored it yet
+            return PollResult::Empty;
+        }
+        if (version == stored) {
+            out.type = static_cast<ChangeType>(slot.type.load(std::memory_order_relaxed));
+            out.userId = slot.userId.load(std::memory_order_relaxed);
+            out.age = slot.age.load(std::memory_order_relaxed);
+            const size_t length = slot.nameLength.load(std::memory_order_relaxed);
+            const std::atomic<uint64_t>* name = slot.name.load(std::memory_order_acquire);
+            // A racing publisher may pair the length with another buffer; the
+            // version check below throws that copy away, this keeps it in bounds
+            const size_t room = name ? name[0].load(std::memory_order_relaxed) * kWordBytes : 0;
+            const size_t bytes = std::min(length, room);
+            out.name.resize(bytes);
+            for (size_t offset = 0; offset < bytes; offset += kWordBytes) {
+                const uint64_t word = name[1 + offset / kWordBytes].load(std::memory_order_relaxed);
+                std::memcpy(&out.name[offset], &word, std::min(kWordBytes, bytes - offset));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) == stored) {
+                out.sequence = cursor_;
+                ++cursor_;
+                return PollResult::Record;
+            }
+        }
+    }
+
+    // The slot was reused by a newer record: this subscriber fell too far behind
+    const uint64_t latest = stream_->next_.load(std::memory_order_acquire);
+    uint64_t resume = std::max(latest > capacity ? latest - capacity : 0, cursor_ + 1);
+    dropped_ += resume - cursor_;
+    cursor_ = resume;
+    return PollResult::Overrun;
+}
+
+ChangeStream::ChangeStream(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Change stream capacity must be positive");
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    slots_ = std::make_unique<Slot[]>(rounded);
+    mask_ = rounded - 1;
+}
+
+uint64_t ChangeStream::publish(ChangeType type, int userId, const std::string& name, int age) {
+    const uint64_t sequence = next_.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = slots_[sequence & mask_];
+
+    // Wait out the previous lap's write to this slot, if it is still going
+    const uint64_t previous = sequence > mask_ ? 2 * (sequence - mask_ - 1) + 2 : 0;
+    while (slot.version.load(std::memory_order_acquire) != previous) {
+        std::this_thread::yield();
+    }
+    slot.version.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.type.store(static_cast<uint8_t>(type), std::memory_order_relaxed);
+    slot.userId.store(userId, std::memory_order_relaxed);
+    slot.age.store(age, std::memory_order_relaxed);
+
+    const size_t words = (name.size() + kWordBytes - 1) / kWordBytes;
+    std::atomic<uint64_t>* buffer = slot.name.load(std::memory_order_relaxed);
+    if (!buffer || buffer[0].load(std::memory_order_relaxed) < words) {
+        // The old buffer stays in buffers: a subscriber may still be copying it
+        const size_t capacity = std::max({words, kMinNameWords,
+                                          buffer ? 2 * buffer[0].load(std::memory_order_relaxed) : 0});
+        slot.buffers.push_back(std::make_unique<std::atomic<uint64_t>[]>(capacity + 1));
+        buffer = slot.buffers.back().get();
+        buffer[0].store(capacity, std::memory_order_relaxed);
+        slot.name.store(buffer, std::memory_order_release);
+    }
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t word = 0;
+        const size_t offset = i * kWordBytes;
+        std::memcpy(&word, name.data() + offset, std::min(kWordBytes, name.size() - offset));
+        buffer[1 + i].store(word, std::memory_order_relaxed);
+    }
+    slot.nameLength.store(name.size(), std::memory_order_relaxed);
+
+    slot.version.store(2 * sequence + 2, std::memory_order_release);
+    return sequence;
+}
+
+ChangeStream::Subscriber ChangeStream::subscribe() const {
+    return Subscriber(this, getNextSequence());
+}
+
+ChangeStream::Subscriber ChangeStream::subscribeFrom(uint64_t sequence) const {
+    return Subscriber(this, sequence);
+}
@@ -0,0 +1,67 @@
+#include "connection_monitor.h"
+#include <algorithm>
+
+ConnectionMonitor::ConnectionMonitor(std::shared_ptr<DatabaseInterface> database, std::string connectionString,
+                                     const HealthCheckOptions& options)
+    : database_(std::move(database)),
+      connection_string_(std::move(connectionString)),
+      options_(options),
+      connected_(database_->isConnected()) {
+    options_.minBackoff = std::max(options_.minBackoff, std::chrono::milliseconds(1));
+    options_.maxBackoff = std::max(options_.maxBackoff, options_.minBackoff);
+    checker_ = std::thread([this]() { run(); });
+}
+
+ConnectionMonitor::~ConnectionMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    checker_.join();
+}
+
+void ConnectionMonitor::reportFailure() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        probe_requested_ = true;
+    }
+    wake_.notify_one();
+}
+
+void ConnectionMonitor::run() {
+    std::chrono::milliseconds backoff = options_.minBackoff;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        const auto delay = isConnected() ? options_.interval : backoff;
+        wake_.wait_until(lock, std::chrono::steady_clock::now() + delay,
+                         [this]() { return stopping_ || probe_requested_; });
+        if (stopping_) {
+            return;
+        }
+        probe_requested_ = false;
+
+        lock.unlock();
+        probe(backoff);
+        lock.lock();
+    }
+}
+
+void ConnectionMonitor::probe(std::chrono::milliseconds& backoff) {
+    probes_.fetch_add(1, std::memory_order_relaxed);
+    if (database_->isConnected()) {
+        connected_.store(true, std::memory_order_release);
+        backoff = options_.minBackoff;
+        return;
+    }
+
+    connected_.store(false, std::memory_order_release);
+    reconnect_attempts_.fetch_add(1, std::memory_order_relaxed);
+    if (database_->connect(connection_string_)) {
+        reconnects_.fetch_add(1, std::memory_order_relaxed);
+        connected_.store(true, std::memory_order_release);
+        backoff = options_.minBackoff;
+        return;
+    }
+    backoff = std::min(backoff * 2, options_.maxBackoff);
+}
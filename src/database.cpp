@@ -1,4 +1,143 @@
 #include "database_interface.h"
+#include "connection_monitor.h"
+#include "json_writer.h"
+#include "user_info_formatter.h"
+#include "write_behind.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+
+namespace {
+
+struct HedgedResult {
+    std::string name;
+    int age = -1;
+};
+
+// Rendezvous for the attempts of one hedged read; the first reply wins
+struct HedgedReply {
+    std::atomic<bool> claimed{false};
+    std::promise<HedgedResult> promise;
+};
+
+} // namespace
+
+bool DatabaseInterface::insertUserWithId(int userId, const std::string& name, int age) {
+    (void)userId;
+    (void)name;
+    (void)age;
+    return false;
+}
+
+int DatabaseInterface::insertUserReturningId(const std::string& name, int age) {
+    return insertUser(name, age) ? kUnknownId : -1;
+}
+
+DbStatus DatabaseInterface::tryInsertUser(const std::string& name, int age) {
+    return insertUser(name, age) ? DbStatus() : failureStatus();
+}
+
+DbStatus DatabaseInterface::tryInsertUserWithId(int userId, const std::string& name, int age) {
+    return insertUserWithId(userId, name, age) ? DbStatus() : failureStatus();
+}
+
+DbStatus DatabaseInterface::tryUpdateUser(int userId, const std::string& name, int age) {
+    return updateUser(userId, name, age) ? DbStatus() : failureStatus();
+}
+
+DbStatus DatabaseInterface::tryDeleteUser(int userId) {
+    return deleteUser(userId) ? DbStatus() : failureStatus();
+}
+
+DbStatus DatabaseInterface::tryGetUser(int userId, UserRecord& out) {
+    out = UserRecord();
+    out.id = userId;
+    out.name = getUserName(userId);
+    if (out.name.empty()) {
+        // Untyped lookups do not set an error, so only the connection tells the cases apart
+        return isConnected() ? DbStatus::fail(DbError::NotFound, "User not found")
+                             : DbStatus::fail(DbError::NotConnected, "Not connected");
+    }
+    out.age = getUserAge(userId);
+    return DbStatus();
+}
+
+DbStatus DatabaseInterface::failureStatus() const {
+    std::string message = getLastError();
+    return DbStatus::fail(DbStatus::classify(message), "", message);
+}
+
+std::vector<UserRecord> DatabaseInterface::getUsers(const std::vector<int>& userIds) {
+    std::vector<UserRecord> records;
+    records.reserve(userIds.size());
+    for (int userId : userIds) {
+        UserRecord record;
+        record.id = userId;
+        record.name = getUserName(userId);
+        record.age = record.name.empty() ? -1 : getUserAge(userId);
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+bool DatabaseInterface::applyMutations(const std::vector<UserMutation>& mutations) {
+    bool applied = true;
+    for (const UserMutation& mutation : mutations) {
+        switch (mutation.type) {
+        case MutationType::Insert:
+            applied = insertUser(mutation.name, mutation.age) && applied;
+            break;
+        case MutationType::Update:
+            applied = updateUser(mutation.userId, mutation.name, mutation.age) && applied;
+            break;
+        case MutationType::Delete:
+            applied = deleteUser(mutation.userId) && applied;
+            break;
+        }
+    }
+    return applied;
+}
+
+std::vector<UserRecord> DatabaseInterface::listUsers(int afterId, size_t limit) {
+    std::vector<UserRecord> page;
+    std::vector<std::string> rows;
+    if (limit == 0 || !executeQuery("SELECT * FROM USERS", rows)) {
+        return page;
+    }
+
+    // Rows are id,name,age; names may hold commas, so split at the outer ones
+    for (const std::string& row : rows) {
+        const size_t first = row.find(',');
+        const size_t last = row.rfind(',');
+        if (first == std::string::npos || first == last) {
+            continue;
+        }
+        UserRecord record;
+        record.id = std::atoi(row.c_str());
+        if (record.id <= afterId) {
+            continue;
+        }
+        record.name = row.substr(first + 1, last - first - 1);
+        record.age = std::atoi(row.c_str() + last + 1);
+        page.push_back(std::move(record));
+    }
+
+    auto byId = [](const UserRecord& a, const UserRecord& b) { return a.id < b.id; };
+    if (page.size() > limit) {
+        std::partial_sort(page.begin(), page.begin() + limit, page.end(), byId);
+        page.resize(limit);
+    } else {
+        std::sort(page.begin(), page.end(), byId);
+    }
+    return page;
+}
+
+bool DatabaseInterface::mergeDistinctNames(const std::string& query, HyperLogLog& sketch) {
+    (void)query;
+    (void)sketch;
+    return false;
+}
 
 DatabaseService::DatabaseService(std::shared_ptr<DatabaseInterface> db) 
     : database_(db) {
@@ -12,45 +151,408 @@ bool DatabaseService::initializeConnection(const std::string& connectionString)
     bool connected = database_->connect(connectionString);
     if (connected) {
         initialized_ = true;
+        connection_string_ = connectionString;
+        if (replicas_) {
+            replicas_->connectReplicas(connectionString);
+        }
     }
     return connected;
 }
 
 bool DatabaseService::createUser(const std::string& name, int age) {
-    if (!initialized_ || !database_->isConnected()) {
+    if (!initialized_ || !connected()) {
         return false;
     }
     
-    return database_->insertUser(name, age);
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Normal, ticket)) {
+        return false;
+    }
+    
+    UserMutation mutation;
+    mutation.type = MutationType::Insert;
+    mutation.name = name;
+    mutation.age = age;
+    return applyWrite(std::move(mutation));
+}
+
+int DatabaseService::createUserReturningId(const std::string& name, int age) {
+    if (!initialized_ || !connected()) {
+        return -1;
+    }
+    
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Normal, ticket)) {
+        return -1;
+    }
+    
+    // Earlier queued writes still go first; their failures are flush()'s to report
+    if (write_behind_) {
+        write_behind_->drain();
+    }
+    ReplicaRouter::Lease write = beginWrite();
+    const int userId = database_->insertUserReturningId(name, age);
+    finishWrite(MutationType::Insert, userId,
+                userId < 0 ? DbStatus(DbStatus::classify(database_->getLastError())) : DbStatus());
+    return userId;
 }
 
 std::string DatabaseService::getUserInfo(int userId) {
-    if (!initialized_ || !database_->isConnected()) {
-        return "";
+    std::string name;
+    int age = -1;
+    std::string info;
+    if (lookupUserInfo(userId, name, age)) {
+        UserInfoFormatter::formatInto(info, name, age);
     }
+    return info;
+}
+
+bool DatabaseService::getUserInfo(int userId, std::string& out) {
+    std::string name;
+    int age = -1;
+    if (!lookupUserInfo(userId, name, age)) {
+        out.clear();
+        return false;
+    }
+    UserInfoFormatter::formatInto(out, name, age);
+    return true;
+}
+
+size_t DatabaseService::getUsersInfo(const std::vector<int>& userIds, std::string& out) {
+    out.clear();
+    std::vector<UserRecord> records = getUsers(userIds);
     
-    std::string name = database_->getUserName(userId);
-    int age = database_->getUserAge(userId);
+    // Size the buffer once, then format every line in place
+    size_t total = 0;
+    for (const UserRecord& record : records) {
+        if (!record.name.empty()) {
+            total += UserInfoFormatter::formattedLength(record.name.size(), record.age) + 1;
+        }
+    }
+    out.reserve(total);
     
-    if (name.empty()) {
-        return "";
+    size_t found = 0;
+    for (const UserRecord& record : records) {
+        if (!record.name.empty()) {
+            UserInfoFormatter::append(out, record.name, record.age, '\n');
+            ++found;
+        }
     }
+    return found;
+}
+
+size_t DatabaseService::getUsersJson(const std::vector<int>& userIds, JsonWriter& writer) {
+    std::vector<UserRecord> records = getUsers(userIds);
+    writer.writeUsers(records);
     
-    return "Name: " + name + ", Age: " + std::to_string(age);
+    size_t found = 0;
+    for (const UserRecord& record : records) {
+        found += record.name.empty() ? 0 : 1;
+    }
+    return found;
+}
+
+std::vector<UserRecord> DatabaseService::getUsers(const std::vector<int>& userIds) {
+    if (!initialized_ || !connected()) {
+        return {};
+    }
+    
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Bulk, ticket)) {
+        return {};
+    }
+    
+    ReplicaRouter::Lease lease;
+    return readSource(lease).getUsers(userIds);
 }
 
 bool DatabaseService::removeUser(int userId) {
-    if (!initialized_ || !database_->isConnected()) {
+    if (!initialized_ || !connected()) {
+        return false;
+    }
+    
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Normal, ticket)) {
+        return false;
+    }
+    
+    UserMutation mutation;
+    mutation.type = MutationType::Delete;
+    mutation.userId = userId;
+    return applyWrite(std::move(mutation));
+}
+
+bool DatabaseService::updateUser(int userId, const std::string& name, int age) {
+    if (!initialized_ || !connected()) {
+        return false;
+    }
+    
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Normal, ticket)) {
         return false;
     }
     
-    return database_->deleteUser(userId);
+    UserMutation mutation;
+    mutation.type = MutationType::Update;
+    mutation.userId = userId;
+    mutation.name = name;
+    mutation.age = age;
+    return applyWrite(std::move(mutation));
 }
 
 int DatabaseService::getTotalUsers() {
-    if (!initialized_ || !database_->isConnected()) {
+    if (!initialized_ || !connected()) {
         return -1;
     }
     
-    return database_->getUserCount();
-}
\ No newline at end of file
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Normal, ticket)) {
+        return -1;
+    }
+    
+    auto count = [this]() {
+        ReplicaRouter::Lease lease;
+        return readSource(lease).getUserCount();
+    };
+    return coalescing() ? total_users_flights_->run(0, count) : count();
+}
+
+std::vector<std::string> DatabaseService::getAllUserNames() {
+    if (!initialized_ || !connected()) {
+        return {};
+    }
+    
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Bulk, ticket)) {
+        return {};
+    }
+    
+    ReplicaRouter::Lease lease;
+    return readSource(lease).getAllUserNames();
+}
+
+std::vector<UserRecord> DatabaseService::listUsers(int afterId, size_t limit) {
+    if (!initialized_ || !connected()) {
+        return {};
+    }
+    
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Bulk, ticket)) {
+        return {};
+    }
+    
+    ReplicaRouter::Lease lease;
+    return readSource(lease).listUsers(afterId, limit);
+}
+
+void DatabaseService::setAdmissionController(std::shared_ptr<AdmissionController> controller) {
+    admission_ = std::move(controller);
+}
+
+bool DatabaseService::admit(RequestPriority priority, AdmissionController::Ticket& ticket) {
+    if (!admission_) {
+        return true;
+    }
+    
+    ticket = admission_->admit(priority);
+    return ticket.admitted();
+}
+
+void DatabaseService::setReplicas(std::vector<std::shared_ptr<DatabaseInterface>> replicas,
+                                  const ReplicaOptions& options) {
+    if (replicas.empty() || !database_) {
+        replicas_.reset();
+        return;
+    }
+    replicas_ = std::make_shared<ReplicaRouter>(database_, std::move(replicas), options);
+}
+
+DatabaseInterface& DatabaseService::readSource(ReplicaRouter::Lease& lease) {
+    if (!replicas_) {
+        return *database_;
+    }
+    lease = replicas_->routeRead();
+    return *lease;
+}
+
+ReplicaRouter::Lease DatabaseService::beginWrite() {
+    return replicas_ ? replicas_->routeWrite() : ReplicaRouter::Lease();
+}
+
+void DatabaseService::setHedgePolicy(std::shared_ptr<HedgePolicy> policy) {
+    hedging_ = std::move(policy);
+    if (hedging_ && !hedge_executor_) {
+        hedge_executor_ = std::make_unique<HedgeExecutor>();
+    }
+}
+
+void DatabaseService::setRequestCoalescing(bool enabled) {
+    if (enabled) {
+        user_info_flights_ = std::make_shared<SingleFlight<int, std::pair<std::string, int>>>();
+        total_users_flights_ = std::make_shared<SingleFlight<int, int>>();
+    } else {
+        user_info_flights_.reset();
+        total_users_flights_.reset();
+    }
+}
+
+bool DatabaseService::lookupUserInfo(int userId, std::string& name, int& age) {
+    if (!initialized_ || !connected()) {
+        return false;
+    }
+    
+    AdmissionController::Ticket ticket;
+    if (!admit(RequestPriority::Critical, ticket)) {
+        return false;
+    }
+    
+    if (coalescing()) {
+        auto info = user_info_flights_->run(userId, [this, userId]() {
+            std::pair<std::string, int> reply("", -1);
+            fetchUserInfo(userId, reply.first, reply.second);
+            return reply;
+        });
+        name = std::move(info.first);
+        age = info.second;
+    } else {
+        fetchUserInfo(userId, name, age);
+    }
+    return !name.empty();
+}
+
+bool DatabaseService::coalescing() const {
+    // A caller pinned to the primary must not share a flight served by a replica
+    return user_info_flights_ && !(replicas_ && replicas_->callerIsSticky());
+}
+
+void DatabaseService::fetchUserInfo(int userId, std::string& name, int& age) {
+    if (hedging_ && replicas_) {
+        hedgedRead(userId, name, age);
+        return;
+    }
+    ReplicaRouter::Lease lease;
+    DatabaseInterface& source = readSource(lease);
+    name = source.getUserName(userId);
+    age = source.getUserAge(userId);
+}
+
+void DatabaseService::hedgedRead(int userId, std::string& name, int& age) {
+    ReplicaRouter::Lease first = replicas_->routeRead();
+    if (first.onPrimary()) {
+        // Sticky or no replica up: there is no equivalent backend to hedge to
+        name = first->getUserName(userId);
+        age = first->getUserAge(userId);
+        return;
+    }
+    hedging_->onRead();
+
+    // The first attempt goes to an idle executor worker so a slow replica
+    // never holds up the caller, which runs the hedge itself if one is due.
+    // Attempts never queue: with every worker busy the caller reads inline.
+    // The task keeps the router, and with it the backends, alive until it
+    // finishes; the executor is joined before the service is destroyed
+    auto reply = std::make_shared<HedgedReply>();
+    std::future<HedgedResult> winner = reply->promise.get_future();
+    auto slot = std::make_shared<ReplicaRouter::Lease>(std::move(first));
+    const DatabaseInterface* firstTarget = &**slot;
+    const bool queued = hedge_executor_->submit(
+        [reply, slot, userId, router = replicas_, policy = hedging_]() {
+            HedgedResult result;
+            try {
+                auto start = HedgePolicy::Clock::now();
+                result.name = (*slot)->getUserName(userId);
+                result.age = (*slot)->getUserAge(userId);
+                policy->recordLatency(HedgePolicy::Clock::now() - start);
+            } catch (...) {
+                slot->release();
+                if (!reply->claimed.exchange(true)) {
+                    reply->promise.set_exception(std::current_exception());
+                }
+                return;
+            }
+            slot->release();
+            (void)router;
+            if (!reply->claimed.exchange(true)) {
+                reply->promise.set_value(std::move(result));
+            }
+        });
+    if (!queued) {
+        // No worker idle: read inline rather than wait for one
+        ReplicaRouter::Lease lease = std::move(*slot);
+        name = lease->getUserName(userId);
+        age = lease->getUserAge(userId);
+        return;
+    }
+
+    if (winner.wait_for(hedging_->hedgeDelay()) != std::future_status::ready &&
+        hedging_->tryHedge()) {
+        ReplicaRouter::Lease hedge = replicas_->routeRead(firstTarget);
+        auto start = HedgePolicy::Clock::now();
+        std::string hedgedName = hedge->getUserName(userId);
+        int hedgedAge = hedge->getUserAge(userId);
+        hedging_->recordLatency(HedgePolicy::Clock::now() - start);
+        hedge.release();
+        if (!reply->claimed.exchange(true)) {
+            hedging_->recordHedgeWin();
+            name = std::move(hedgedName);
+            age = hedgedAge;
+            return;
+        }
+    }
+    HedgedResult result = winner.get();
+    name = std::move(result.name);
+    age = result.age;
+}
+
+void DatabaseService::enableWriteBehind(const WriteBehindOptions& options) {
+    std::shared_ptr<DatabaseInterface> database = database_;
+    write_behind_ = std::make_shared<WriteBehindQueue>(
+        [database](const std::vector<UserMutation>& batch) { return database->applyMutations(batch); },
+        options);
+}
+
+bool DatabaseService::flush() {
+    return write_behind_ ? write_behind_->flush() : true;
+}
+
+void DatabaseService::enableHealthCheck(const HealthCheckOptions& options) {
+    monitor_ = std::make_shared<ConnectionMonitor>(database_, connection_string_, options);
+}
+
+bool DatabaseService::connected() const {
+    return monitor_ ? monitor_->isConnected() : database_->isConnected();
+}
+
+bool DatabaseService::applyWrite(UserMutation mutation) {
+    ReplicaRouter::Lease write = beginWrite();
+    const int userId = mutation.userId;
+    const MutationType type = mutation.type;
+
+    DbStatus status;
+    if (write_behind_) {
+        write_behind_->enqueue(std::move(mutation));
+    } else if (type == MutationType::Insert) {
+        status = database_->tryInsertUser(mutation.name, mutation.age);
+    } else if (type == MutationType::Update) {
+        status = database_->tryUpdateUser(userId, mutation.name, mutation.age);
+    } else {
+        status = database_->tryDeleteUser(userId);
+    }
+    finishWrite(type, userId, status);
+    return status.ok();
+}
+
+void DatabaseService::finishWrite(MutationType type, int userId, DbStatus status) {
+    // Only a lost link is worth an early probe; bad input or a missing user is not
+    if (status.code() == DbError::NotConnected && monitor_) {
+        monitor_->reportFailure();
+    }
+
+    // Reads starting after this write must not join a flight that predates it
+    if (user_info_flights_) {
+        if (type != MutationType::Insert) {
+            user_info_flights_->forget(userId);
+        }
+        total_users_flights_->forget(0);
+    }
+}
@@ -0,0 +1,48 @@
+#include "db_status.h"
+
+namespace {
+
+struct FailureDetail {
+    const char* message = "";
+    std::string context;
+};
+
+thread_local FailureDetail t_detail;
+
+bool startsWith(const std::string& text, const char* prefix) {
+    return text.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+} // namespace
+
+DbStatus DbStatus::fail(DbError code, const char* message, const std::string& context) {
+    t_detail.message = message;
+    t_detail.context.assign(context);
+    return DbStatus(code);
+}
+
+std::string DbStatus::detail() {
+    return t_detail.message + t_detail.context;
+}
+
+DbError DbStatus::classify(const std::string& message) {
+    if (message == "Not connected") {
+        return DbError::NotConnected;
+    }
+    if (message == "Invalid user data" || startsWith(message, "Query failed")) {
+        return DbError::InvalidArgument;
+    }
+    if (message == "User not found") {
+        return DbError::NotFound;
+    }
+    if (message == "User already exists") {
+        return DbError::AlreadyExists;
+    }
+    if (startsWith(message, "User id outside")) {
+        return DbError::OutOfRange;
+    }
+    if (startsWith(message, "Unsupported")) {
+        return DbError::Unsupported;
+    }
+    return DbError::Unknown;
+}
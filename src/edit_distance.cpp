@@ -0,0 +1,112 @@
+#include "edit_distance.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+EditDistanceMatcher::EditDistanceMatcher(const std::string& pattern) : pattern_(pattern) {
+    if (pattern_.size() <= kMaxBitParallelLength) {
+        for (size_t i = 0; i < pattern_.size(); ++i) {
+            match_masks_[static_cast<unsigned char>(pattern_[i])] |= uint64_t{1} << i;
+        }
+    }
+}
+
+int EditDistanceMatcher::distance(const std::string& text, int maxDistance) const {
+    const int lengthGap = std::abs(static_cast<int>(text.size()) - static_cast<int>(pattern_.size()));
+    if (lengthGap > maxDistance) {
+        return maxDistance + 1;
+    }
+    if (pattern_.empty()) {
+        return static_cast<int>(text.size());
+    }
+    if (pattern_.size() <= kMaxBitParallelLength) {
+        return bitParallel(text, maxDistance);
+    }
+    return banded(text, maxDistance);
+}
+
+int EditDistanceMatcher::reference(const std::string& a, const std::string& b) {
+    std::vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        row[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); ++j) {
+            int above = row[j];
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+int EditDistanceMatcher::bitParallel(const std::string& text, int maxDistance) const {
+    const size_t m = pattern_.size();
+    const uint64_t mask = m == 64 ? ~uint64_t{0} : (uint64_t{1} << m) - 1;
+    const uint64_t last = uint64_t{1} << (m - 1);
+
+    // Vertical deltas of the current column: +1 in pv, -1 in mv
+    uint64_t pv = mask;
+    uint64_t mv = 0;
+    int score = static_cast<int>(m);
+
+    for (size_t j = 0; j < text.size(); ++j) {
+        const uint64_t eq = match_masks_[static_cast<unsigned char>(text[j])];
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & last) {
+            ++score;
+        } else if (mh & last) {
+            --score;
+        }
+
+        // Row 0 is D[0][j] = j, so every column starts with a +1 step
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = (mh | ~(xv | ph)) & mask;
+        mv = ph & xv & mask;
+
+        // The score falls by at most one per remaining text byte
+        const int remaining = static_cast<int>(text.size() - j - 1);
+        if (score - remaining > maxDistance) {
+            return maxDistance + 1;
+        }
+    }
+    return score;
+}
+
+int EditDistanceMatcher::banded(const std::string& text, int maxDistance) const {
+    const int rows = static_cast<int>(pattern_.size());
+    const int cols = static_cast<int>(text.size());
+    const int band = std::min(maxDistance, std::max(rows, cols));
+    const int outside = band + 1;
+
+    std::vector<int> previous(cols + 1, outside);
+    std::vector<int> current(cols + 1, outside);
+    for (int j = 0; j <= std::min(cols, band); ++j) {
+        previous[j] = j;
+    }
+
+    for (int i = 1; i <= rows; ++i) {
+        const int from = std::max(1, i - band);
+        const int to = std::min(cols, i + band);
+        // Only the cell left of the band can hold a stale value from two rows back
+        current[from - 1] = from == 1 && i <= band ? i : outside;
+        int best = current[from - 1];
+        for (int j = from; j <= to; ++j) {
+            const int substitute = previous[j - 1] + (pattern_[i - 1] == text[j - 1] ? 0 : 1);
+            current[j] = std::min({substitute, previous[j] + 1, current[j - 1] + 1, outside});
+            best = std::min(best, current[j]);
+        }
+        if (best > maxDistance) {
+            return maxDistance + 1;
+        }
+        previous.swap(current);
+    }
+    return std::min(previous[cols], outside);
+}
@@ -0,0 +1,136 @@
+#include "expression_evaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+template <typename Op>
+void compareColumns(const double* left, const double* right, uint8_t* selected, size_t rows, Op op) {
+    for (size_t i = 0; i < rows; ++i) {
+        selected[i] = op(left[i], right[i]);
+    }
+}
+
+} // namespace
+
+void ExpressionEvaluator::evaluate(const QueryExpression& expression, const Batch& batch, std::vector<double>& out) {
+    const size_t depth = depthOf(expression, QueryParser::kMaxNesting);
+    if (depth > QueryParser::kMaxNesting) {
+        throw std::invalid_argument("Expression nested too deeply");
+    }
+    if (scratch_.size() < depth) {
+        scratch_.resize(depth);
+    }
+    for (std::vector<double>& column : scratch_) {
+        if (column.size() < batch.rows) {
+            column.resize(batch.rows);
+        }
+    }
+    out.resize(batch.rows);
+    evaluateInto(expression, batch, out.data(), 0);
+}
+
+void ExpressionEvaluator::compare(const QueryPredicate& predicate, const Batch& batch,
+                                  std::vector<uint8_t>& selected) {
+    evaluate(predicate.operands[0], batch, left_);
+    evaluate(predicate.operands[1], batch, right_);
+    selected.resize(batch.rows);
+
+    // One loop per operator keeps the comparison out of the row loop
+    const double* left = left_.data();
+    const double* right = right_.data();
+    uint8_t* out = selected.data();
+    switch (predicate.op) {
+    case CompareOp::Equal:
+        compareColumns(left, right, out, batch.rows, [](double a, double b) { return a == b; });
+        break;
+    case CompareOp::NotEqual:
+        compareColumns(left, right, out, batch.rows, [](double a, double b) { return a != b; });
+        break;
+    case CompareOp::Less:
+        compareColumns(left, right, out, batch.rows, [](double a, double b) { return a < b; });
+        break;
+    case CompareOp::LessEqual:
+        compareColumns(left, right, out, batch.rows, [](double a, double b) { return a <= b; });
+        break;
+    case CompareOp::Greater:
+        compareColumns(left, right, out, batch.rows, [](double a, double b) { return a > b; });
+        break;
+    case CompareOp::GreaterEqual:
+        compareColumns(left, right, out, batch.rows, [](double a, double b) { return a >= b; });
+        break;
+    }
+}
+
+void ExpressionEvaluator::formatInto(std::string& out, double value) {
+    char buffer[32];
+    int length = 0;
+    if (std::nearbyint(value) == value && std::fabs(value) < 1e15) {
+        length = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+    } else {
+        // 17 significant digits always read back; most values need fewer
+        for (int precision = 15; precision <= 17; ++precision) {
+            length = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            if (std::strtod(buffer, nullptr) == value) {
+                break;
+            }
+        }
+    }
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+void ExpressionEvaluator::evaluateInto(const QueryExpression& expression, const Batch& batch, double* out,
+                                       size_t depth) {
+    switch (expression.kind) {
+    case ExpressionKind::Number:
+        std::fill(out, out + batch.rows, expression.value);
+        return;
+    case ExpressionKind::Id:
+        std::copy(batch.ids, batch.ids + batch.rows, out);
+        return;
+    case ExpressionKind::Age:
+        std::copy(batch.ages, batch.ages + batch.rows, out);
+        return;
+    case ExpressionKind::SquareRoot:
+        evaluateInto(expression.operands[0], batch, out, depth + 1);
+        calculator_.squareRoot(out, out, batch.rows);
+        return;
+    default:
+        break;
+    }
+
+    // The left operand is built in place; deeper levels use deeper scratch columns
+    double* right = scratch_[depth].data();
+    evaluateInto(expression.operands[0], batch, out, depth + 1);
+    evaluateInto(expression.operands[1], batch, right, depth + 1);
+    switch (expression.kind) {
+    case ExpressionKind::Add:
+        calculator_.add(out, right, out, batch.rows);
+        break;
+    case ExpressionKind::Subtract:
+        calculator_.subtract(out, right, out, batch.rows);
+        break;
+    case ExpressionKind::Multiply:
+        calculator_.multiply(out, right, out, batch.rows);
+        break;
+    case ExpressionKind::Divide:
+        calculator_.divide(out, right, out, batch.rows);
+        break;
+    default:
+        break;
+    }
+}
+
+size_t ExpressionEvaluator::depthOf(const QueryExpression& expression, size_t limit) {
+    if (limit == 0 || expression.operands.empty()) {
+        return expression.operands.empty() ? 0 : 1;
+    }
+    size_t depth = 0;
+    for (const QueryExpression& operand : expression.operands) {
+        depth = std::max(depth, depthOf(operand, limit - 1) + 1);
+    }
+    return depth;
+}
@@ -0,0 +1,134 @@
+#include "hedge_policy.h"
+#include <algorithm>
+
+namespace {
+
+// New samples between percentile recomputations
+constexpr size_t kRefreshInterval = 64;
+// Longest an idle executor worker sleeps between checks
+constexpr std::chrono::milliseconds kIdlePoll{100};
+
+} // namespace
+
+HedgePolicy::HedgePolicy(const HedgeOptions& options)
+    : options_(options), delay_(options.initialDelay) {
+    options_.windowSize = std::max<size_t>(options_.windowSize, 1);
+    samples_.reserve(options_.windowSize);
+}
+
+HedgePolicy::Clock::duration HedgePolicy::hedgeDelay() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return delay_;
+}
+
+void HedgePolicy::recordLatency(Clock::duration latency) {
+    const int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.size() < options_.windowSize) {
+        samples_.push_back(micros);
+    } else {
+        samples_[next_sample_] = micros;
+        next_sample_ = (next_sample_ + 1) % options_.windowSize;
+    }
+
+    if (samples_.size() < options_.minSamples) {
+        return;
+    }
+    if (++samples_since_refresh_ < kRefreshInterval && samples_.size() > options_.minSamples) {
+        return;
+    }
+    samples_since_refresh_ = 0;
+
+    std::vector<int64_t> sorted(samples_);
+    size_t rank = static_cast<size_t>(options_.percentile * static_cast<double>(sorted.size() - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    delay_ = std::max<Clock::duration>(std::chrono::microseconds(sorted[rank]), options_.minDelay);
+}
+
+void HedgePolicy::onRead() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++reads_;
+    tokens_ = std::min(tokens_ + options_.budgetRatio, options_.maxBurst);
+}
+
+bool HedgePolicy::tryHedge() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tokens_ < 1.0) {
+        return false;
+    }
+    tokens_ -= 1.0;
+    ++hedges_;
+    return true;
+}
+
+void HedgePolicy::recordHedgeWin() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++hedge_wins_;
+}
+
+uint64_t HedgePolicy::getReads() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reads_;
+}
+
+uint64_t HedgePolicy::getHedges() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hedges_;
+}
+
+uint64_t HedgePolicy::getHedgeWins() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hedge_wins_;
+}
+
+HedgeExecutor::HedgeExecutor(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    idle_ = threads;
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this] { run(); });
+    }
+}
+
+HedgeExecutor::~HedgeExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+bool HedgeExecutor::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Every pending task already has an idle worker on its way to it
+        if (stopping_ || tasks_.size() >= idle_) {
+            return false;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+    return true;
+}
+
+void HedgeExecutor::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        while (tasks_.empty() && !stopping_) {
+            wake_.wait_for(lock, kIdlePoll);
+        }
+        if (tasks_.empty()) {
+            return;
+        }
+        std::function<void()> task = std::move(tasks_.front());
+        tasks_.pop_front();
+        --idle_;
+        lock.unlock();
+        task();
+        lock.lock();
+        ++idle_;
+    }
+}
@@ -0,0 +1,129 @@
+#include "huge_page_allocator.h"
+#include <atomic>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<bool> g_explicit_huge_pages{false};
+std::atomic<uint64_t> g_mapped_bytes{0};
+std::atomic<uint64_t> g_explicit_mappings{0};
+std::atomic<uint64_t> g_transparent_mappings{0};
+std::atomic<uint64_t> g_bound_mappings{0};
+
+size_t roundToHugePages(size_t bytes) {
+    return (bytes + HugePageMemory::kHugePageSize - 1) & ~(HugePageMemory::kHugePageSize - 1);
+}
+
+#ifdef __linux__
+// From <numaif.h>, spelled out to avoid a libnuma dependency
+constexpr int kMpolBind = 2;
+
+bool bindToNode(void* address, size_t length, int numaNode) {
+    if (numaNode < 0 || numaNode >= 64) {
+        return false;
+    }
+    unsigned long mask = 1UL << numaNode;
+    return syscall(SYS_mbind, address, length, kMpolBind, &mask, sizeof(mask) * 8 + 1, 0) == 0;
+}
+#endif
+
+} // namespace
+
+void* HugePageMemory::allocate(size_t bytes, int numaNode) {
+#ifdef __linux__
+    if (bytes >= kLargeThreshold) {
+        const size_t length = roundToHugePages(bytes);
+        void* address = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+        if (g_explicit_huge_pages.load(std::memory_order_relaxed)) {
+            address = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (address != MAP_FAILED) {
+                g_explicit_mappings.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+#endif
+        if (address == MAP_FAILED) {
+            // Over-map by one huge page and trim both ends, so the range
+            // starts on a 2 MB boundary the kernel can back with huge pages
+            const size_t padded = length + kHugePageSize;
+            void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+            const uintptr_t aligned = (start + kHugePageSize - 1) & ~static_cast<uintptr_t>(kHugePageSize - 1);
+            if (aligned > start) {
+                munmap(raw, aligned - start);
+            }
+            const size_t tail = padded - (aligned - start) - length;
+            if (tail > 0) {
+                munmap(reinterpret_cast<void*>(aligned + length), tail);
+            }
+            address = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+            if (madvise(address, length, MADV_HUGEPAGE) == 0) {
+                g_transparent_mappings.fetch_add(1, std::memory_order_relaxed);
+            }
+#endif
+        }
+
+        // Placement must be set before the first touch faults pages in
+        if (bindToNode(address, length, numaNode)) {
+            g_bound_mappings.fetch_add(1, std::memory_order_relaxed);
+        }
+        g_mapped_bytes.fetch_add(length, std::memory_order_relaxed);
+        return address;
+    }
+#else
+    (void)numaNode;
+#endif
+    return ::operator new(bytes);
+}
+
+void HugePageMemory::deallocate(void* pointer, size_t bytes) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    if (bytes >= kLargeThreshold) {
+        const size_t length = roundToHugePages(bytes);
+        munmap(pointer, length);
+        g_mapped_bytes.fetch_sub(length, std::memory_order_relaxed);
+        return;
+    }
+#endif
+    (void)bytes;
+    ::operator delete(pointer);
+}
+
+void HugePageMemory::setExplicitHugePages(bool enabled) {
+    g_explicit_huge_pages.store(enabled, std::memory_order_relaxed);
+}
+
+int HugePageMemory::currentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return -1;
+}
+
+HugePageMemory::Stats HugePageMemory::getStats() {
+    Stats stats;
+    stats.mappedBytes = g_mapped_bytes.load(std::memory_order_relaxed);
+    stats.explicitMappings = g_explicit_mappings.load(std::memory_order_relaxed);
+    stats.transparentMappings = g_transparent_mappings.load(std::memory_order_relaxed);
+    stats.boundMappings = g_bound_mappings.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,72 @@
+#include "hyperloglog.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision_(precision) {
+    if (precision < kMinPrecision || precision > kMaxPrecision) {
+        throw std::invalid_argument("Invalid HyperLogLog precision");
+    }
+    registers_.assign(size_t{1} << precision, 0);
+}
+
+void HyperLogLog::addHash(uint64_t hash) {
+    const size_t index = static_cast<size_t>(hash >> (64 - precision_));
+    const uint64_t rest = hash << precision_;
+    // Rank of the first set bit after the index bits, capped when none is set
+    const uint8_t rank = rest == 0 ? static_cast<uint8_t>(64 - precision_ + 1)
+                                   : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    registers_[index] = std::max(registers_[index], rank);
+}
+
+bool HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision_ != precision_) {
+        return false;
+    }
+    for (size_t i = 0; i < registers_.size(); ++i) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+    return true;
+}
+
+uint64_t HyperLogLog::estimate() const {
+    const double m = static_cast<double>(registers_.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t value : registers_) {
+        sum += std::ldexp(1.0, -static_cast<int>(value));
+        zeros += value == 0;
+    }
+
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return static_cast<uint64_t>(std::llround(estimate));
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+double HyperLogLog::standardError() const {
+    return 1.04 / std::sqrt(static_cast<double>(registers_.size()));
+}
+
+uint64_t HyperLogLog::hash(const char* data, size_t length) {
+    // FNV-1a over the bytes, then the MurmurHash3 finalizer so that short,
+    // similar strings still spread over every register and rank
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < length; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 0x100000001B3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
@@ -0,0 +1,73 @@
+#include "id_allocator.h"
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Threads rarely use more than a couple of allocators; older blocks are dropped
+constexpr size_t kMaxThreadBlocks = 8;
+
+struct Block {
+    uint64_t owner = 0;
+    int next = 0;
+    int end = 0;
+};
+
+std::atomic<uint64_t> g_next_instance{1};
+thread_local std::vector<Block> t_blocks;
+
+Block& threadBlock(uint64_t owner) {
+    for (Block& block : t_blocks) {
+        if (block.owner == owner) {
+            return block;
+        }
+    }
+    if (t_blocks.size() >= kMaxThreadBlocks) {
+        t_blocks.erase(t_blocks.begin());
+    }
+    t_blocks.emplace_back();
+    t_blocks.back().owner = owner;
+    return t_blocks.back();
+}
+
+} // namespace
+
+IdAllocator::IdAllocator(int firstId, int blockSize)
+    : instance_(g_next_instance.fetch_add(1, std::memory_order_relaxed)),
+      block_size_(blockSize),
+      next_(firstId),
+      floor_(firstId) {
+    if (blockSize < 1) {
+        throw std::invalid_argument("IdAllocator block size must be positive");
+    }
+}
+
+int IdAllocator::allocate() {
+    Block& block = threadBlock(instance_);
+    while (true) {
+        const int floor = floor_.load(std::memory_order_acquire);
+        if (block.next < floor) {
+            block.next = std::min(floor, block.end);
+        }
+        if (block.next == block.end) {
+            block.next = next_.fetch_add(block_size_, std::memory_order_acq_rel);
+            block.end = block.next + block_size_;
+        }
+        const int userId = block.next++;
+        // A reservation that raised the floor meanwhile may cover userId
+        if (userId >= floor_.load(std::memory_order_acquire)) {
+            return userId;
+        }
+    }
+}
+
+void IdAllocator::reserveThrough(int userId) {
+    // Raise the counter first, so a block carved after the floor moves is above it
+    for (std::atomic<int>* bound : {&next_, &floor_}) {
+        int current = bound->load(std::memory_order_acquire);
+        while (current <= userId && !bound->compare_exchange_weak(current, userId + 1, std::memory_order_acq_rel)) {
+        }
+    }
+}
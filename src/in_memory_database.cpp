@@ -0,0 +1,856 @@
+#include "in_memory_database.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Rows gathered per prefetch round in getUsers
+constexpr size_t kPrefetchGroup = 16;
+
+// Tombstones an explicit id may leave behind before ids turn sparse,
+// on top of one per live row
+constexpr size_t kDenseSlack = 64;
+
+// True if evaluating predicate computes expressions row by row
+bool comparesRows(const QueryPredicate& predicate) {
+    if (predicate.kind == PredicateKind::Compare) {
+        return true;
+    }
+    return std::any_of(predicate.children.begin(), predicate.children.end(), comparesRows);
+}
+
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+} // namespace
+
+InMemoryDatabase::InMemoryDatabase(int firstId, int idStride, int numaNode)
+    : names_(HugePageAllocator<std::string>(numaNode)),
+      ages_(HugePageAllocator<int>(numaNode)),
+      live_(HugePageAllocator<uint8_t>(numaNode)),
+      first_id_(firstId),
+      id_stride_(idStride),
+      ids_(HugePageAllocator<int>(numaNode)) {
+    if (firstId < 1 || idStride < 1) {
+        throw std::invalid_argument("Invalid id range");
+    }
+}
+
+bool InMemoryDatabase::connect(const std::string& connectionString) {
+    (void)connectionString;
+    connected_ = true;
+    return true;
+}
+
+void InMemoryDatabase::disconnect() {
+    connected_ = false;
+}
+
+bool InMemoryDatabase::isConnected() const {
+    return connected_;
+}
+
+bool InMemoryDatabase::insertUser(const std::string& name, int age) {
+    return report(tryInsertUser(name, age));
+}
+
+bool InMemoryDatabase::insertUserWithId(int userId, const std::string& name, int age) {
+    return report(tryInsertUserWithId(userId, name, age));
+}
+
+int InMemoryDatabase::insertUserReturningId(const std::string& name, int age) {
+    int userId = -1;
+    return report(tryInsertUserReturningId(name, age, userId)) ? userId : -1;
+}
+
+DbStatus InMemoryDatabase::tryInsertUser(const std::string& name, int age) {
+    int userId = -1;
+    return tryInsertUserReturningId(name, age, userId);
+}
+
+DbStatus InMemoryDatabase::tryInsertUserReturningId(const std::string& name, int age, int& userId) {
+    if (!connected_) {
+        return fail(DbError::NotConnected, "Not connected");
+    }
+    if (name.empty() || age < 0) {
+        return fail(DbError::InvalidArgument, "Invalid user data");
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    userId = nextId();
+    commitInsert(userId, name, age);
+    return DbStatus();
+}
+
+DbStatus InMemoryDatabase::tryInsertUserWithId(int userId, const std::string& name, int age) {
+    if (!connected_) {
+        return fail(DbError::NotConnected, "Not connected");
+    }
+    if (name.empty() || age < 0) {
+        return fail(DbError::InvalidArgument, "Invalid user data");
+    }
+    if (userId < first_id_ || (userId - first_id_) % id_stride_ != 0) {
+        return fail(DbError::OutOfRange, "User id outside this database's range");
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (isLive(userId)) {
+        lock.unlock();
+        return fail(DbError::AlreadyExists, "User already exists");
+    }
+    commitInsert(userId, name, age);
+    return DbStatus();
+}
+
+std::string InMemoryDatabase::getUserName(int userId) {
+    if (!checkConnected()) {
+        return "";
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!isLive(userId)) {
+        return "";
+    }
+    return names_[slotOf(userId)];
+}
+
+int InMemoryDatabase::getUserAge(int userId) {
+    if (!checkConnected()) {
+        return -1;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!isLive(userId)) {
+        return -1;
+    }
+    return ages_[slotOf(userId)];
+}
+
+bool InMemoryDatabase::updateUser(int userId, const std::string& name, int age) {
+    return report(tryUpdateUser(userId, name, age));
+}
+
+bool InMemoryDatabase::deleteUser(int userId) {
+    return report(tryDeleteUser(userId));
+}
+
+DbStatus InMemoryDatabase::tryUpdateUser(int userId, const std::string& name, int age) {
+    if (!connected_) {
+        return fail(DbError::NotConnected, "Not connected");
+    }
+    if (name.empty() || age < 0) {
+        return fail(DbError::InvalidArgument, "Invalid user data");
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!isLive(userId)) {
+        lock.unlock();
+        return fail(DbError::NotFound, "User not found");
+    }
+    commitUpdate(slotOf(userId), name, age);
+    return DbStatus();
+}
+
+DbStatus InMemoryDatabase::tryDeleteUser(int userId) {
+    if (!connected_) {
+        return fail(DbError::NotConnected, "Not connected");
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!isLive(userId)) {
+        lock.unlock();
+        return fail(DbError::NotFound, "User not found");
+    }
+    commitDelete(slotOf(userId));
+    return DbStatus();
+}
+
+DbStatus InMemoryDatabase::tryGetUser(int userId, UserRecord& out) {
+    out = UserRecord();
+    out.id = userId;
+    if (!connected_) {
+        return fail(DbError::NotConnected, "Not connected");
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!isLive(userId)) {
+        lock.unlock();
+        return fail(DbError::NotFound, "User not found");
+    }
+    const size_t slot = slotOf(userId);
+    out.name = names_[slot];
+    out.age = ages_[slot];
+    return DbStatus();
+}
+
+std::vector<UserRecord> InMemoryDatabase::getUsers(const std::vector<int>& userIds) {
+    std::vector<UserRecord> records(userIds.size());
+    for (size_t i = 0; i < userIds.size(); ++i) {
+        records[i].id = userIds[i];
+    }
+    if (!checkConnected()) {
+        return records;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const size_t rows = live_.size();
+
+    // Group prefetching: issue every miss of a group before consuming any of
+    // them, first for the column entries, then for out-of-line name bytes
+    size_t slots[kPrefetchGroup];
+    for (size_t base = 0; base < userIds.size(); base += kPrefetchGroup) {
+        const size_t end = std::min(userIds.size(), base + kPrefetchGroup);
+
+        for (size_t i = base; i < end; ++i) {
+            const size_t slot = slots[i - base] = slotOf(userIds[i]);
+            if (slot < rows) {
+                prefetch(&live_[slot]);
+                prefetch(&ages_[slot]);
+                prefetch(&names_[slot]);
+            }
+        }
+
+        for (size_t i = base; i < end; ++i) {
+            const size_t slot = slots[i - base];
+            if (slot < rows && live_[slot]) {
+                prefetch(names_[slot].data());
+            }
+        }
+
+        for (size_t i = base; i < end; ++i) {
+            const size_t slot = slots[i - base];
+            if (slot < rows && live_[slot]) {
+                records[i].name = names_[slot];
+                records[i].age = ages_[slot];
+            }
+        }
+    }
+    return records;
+}
+
+bool InMemoryDatabase::applyMutations(const std::vector<UserMutation>& mutations) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    // One exclusive section for the whole batch; failures keep the last reason
+    DbError failure = DbError::None;
+    const char* reason = "";
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (const UserMutation& mutation : mutations) {
+            if (mutation.type != MutationType::Delete && (mutation.name.empty() || mutation.age < 0)) {
+                failure = DbError::InvalidArgument;
+                reason = "Invalid user data";
+                continue;
+            }
+            if (mutation.type == MutationType::Insert) {
+                commitInsert(nextId(), mutation.name, mutation.age);
+                continue;
+            }
+            if (!isLive(mutation.userId)) {
+                failure = DbError::NotFound;
+                reason = "User not found";
+                continue;
+            }
+            if (mutation.type == MutationType::Update) {
+                commitUpdate(slotOf(mutation.userId), mutation.name, mutation.age);
+            } else {
+                commitDelete(slotOf(mutation.userId));
+            }
+        }
+    }
+
+    if (failure != DbError::None) {
+        return report(fail(failure, reason));
+    }
+    return true;
+}
+
+std::vector<UserRecord> InMemoryDatabase::listUsers(int afterId, size_t limit) {
+    std::vector<UserRecord> page;
+    if (!checkConnected() || limit == 0) {
+        return page;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    page.reserve(std::min(limit, static_cast<size_t>(live_count_)));
+    auto emit = [&page, this](size_t slot) {
+        UserRecord record;
+        record.id = idOf(slot);
+        record.name = names_[slot];
+        record.age = ages_[slot];
+        page.push_back(std::move(record));
+    };
+
+    if (sparse_) {
+        for (auto entry = slots_.upper_bound(afterId); entry != slots_.end() && page.size() < limit; ++entry) {
+            if (live_[entry->second]) {
+                emit(entry->second);
+            }
+        }
+        return page;
+    }
+
+    // Slots are in id order, so the cursor maps straight to the first slot
+    size_t slot = 0;
+    if (afterId >= first_id_) {
+        slot = static_cast<size_t>((afterId - first_id_) / id_stride_) + 1;
+    }
+    for (; slot < live_.size() && page.size() < limit; ++slot) {
+        if (live_[slot]) {
+            emit(slot);
+        }
+    }
+    return page;
+}
+
+std::vector<std::string> InMemoryDatabase::getAllUserNames() {
+    std::vector<std::string> names;
+    if (!checkConnected()) {
+        return names;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    names.reserve(live_count_);
+    for (size_t slot : liveSlots()) {
+        names.push_back(names_[slot]);
+    }
+    return names;
+}
+
+int InMemoryDatabase::getUserCount() {
+    if (!checkConnected()) {
+        return -1;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return live_count_;
+}
+
+bool InMemoryDatabase::executeQuery(const std::string& query, std::vector<std::string>& results) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    ParsedQuery parsed;
+    std::string error;
+    if (!QueryParser::parse(query, parsed, error)) {
+        return report(fail(DbError::Unsupported, "Unsupported query: ", query));
+    }
+
+    try {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return runQuery(parsed, results);
+    } catch (const std::invalid_argument& e) {
+        results.clear();
+        return report(fail(DbError::InvalidArgument, "Query failed: ", e.what()));
+    }
+}
+
+bool InMemoryDatabase::runQuery(const ParsedQuery& parsed, std::vector<std::string>& results) const {
+    results.clear();
+    if (parsed.projection == QueryProjection::CountDistinctName) {
+        HyperLogLog sketch;
+        distinctNames(parsed, sketch);
+        results.push_back(std::to_string(sketch.estimate()));
+        return true;
+    }
+    if (parsed.projection == QueryProjection::Count) {
+        // Counting needs only the bitmap's cardinality, never the rows
+        const uint64_t count = parsed.hasWhere ? evaluate(parsed.where).cardinality() : live_count_;
+        results.push_back(std::to_string(count));
+        return true;
+    }
+
+    std::vector<size_t> slots = selectSlots(parsed);
+    results.reserve(slots.size());
+    if (parsed.projection == QueryProjection::Columns) {
+        projectColumns(parsed.columns, slots, results);
+        return true;
+    }
+    for (size_t slot : slots) {
+        if (parsed.projection == QueryProjection::Name) {
+            results.push_back(names_[slot]);
+        } else {
+            results.push_back(std::to_string(idOf(slot)) + "," + names_[slot] + "," +
+                              std::to_string(ages_[slot]));
+        }
+    }
+    return true;
+}
+
+bool InMemoryDatabase::mergeDistinctNames(const std::string& query, HyperLogLog& sketch) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    ParsedQuery parsed;
+    std::string error;
+    if (!QueryParser::parse(query, parsed, error) || parsed.projection != QueryProjection::CountDistinctName) {
+        return report(fail(DbError::Unsupported, "Unsupported query: ", query));
+    }
+
+    try {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (!distinctNames(parsed, sketch)) {
+            return report(fail(DbError::InvalidArgument, "Sketch precision mismatch"));
+        }
+    } catch (const std::invalid_argument& e) {
+        return report(fail(DbError::InvalidArgument, "Query failed: ", e.what()));
+    }
+    return true;
+}
+
+int64_t InMemoryDatabase::estimateDistinctNames() {
+    if (!checkConnected()) {
+        return -1;
+    }
+
+    HyperLogLog sketch;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    mergeNameSketches(sketch);
+    return static_cast<int64_t>(sketch.estimate());
+}
+
+std::string InMemoryDatabase::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void InMemoryDatabase::clearError() {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_.clear();
+}
+
+size_t InMemoryDatabase::slotOf(int userId) const {
+    if (sparse_) {
+        auto entry = slots_.find(userId);
+        return entry == slots_.end() ? live_.size() : entry->second;
+    }
+    if (userId < first_id_ || (userId - first_id_) % id_stride_ != 0) {
+        return live_.size();
+    }
+    return std::min(static_cast<size_t>((userId - first_id_) / id_stride_), live_.size());
+}
+
+int InMemoryDatabase::idOf(size_t slot) const {
+    return sparse_ ? ids_[slot] : first_id_ + static_cast<int>(slot) * id_stride_;
+}
+
+int InMemoryDatabase::nextId() const {
+    return sparse_ ? next_id_ : idOf(live_.size());
+}
+
+std::vector<size_t> InMemoryDatabase::liveSlots() const {
+    std::vector<size_t> slots;
+    slots.reserve(live_count_);
+    if (sparse_) {
+        for (const auto& entry : slots_) {
+            if (live_[entry.second]) {
+                slots.push_back(entry.second);
+            }
+        }
+        return slots;
+    }
+    for (size_t slot = 0; slot < live_.size(); ++slot) {
+        if (live_[slot]) {
+            slots.push_back(slot);
+        }
+    }
+    return slots;
+}
+
+void InMemoryDatabase::makeSparse() {
+    next_id_ = idOf(live_.size());
+    ids_.resize(live_.size());
+    for (size_t slot = 0; slot < live_.size(); ++slot) {
+        ids_[slot] = idOf(slot);
+        slots_.emplace_hint(slots_.end(), ids_[slot], slot);
+    }
+    sparse_ = true;
+}
+
+size_t InMemoryDatabase::compact() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const size_t dead = live_.size() - static_cast<size_t>(live_count_);
+    if (dead < kDenseSlack + 2 * static_cast<size_t>(live_count_)) {
+        return 0;
+    }
+
+    const std::vector<size_t> keep = liveSlots();
+    Column<std::string> names(names_.get_allocator());
+    Column<int> ages(ages_.get_allocator());
+    Column<uint8_t> live(live_.get_allocator());
+    Column<int> ids(ids_.get_allocator());
+    names.reserve(keep.size());
+    ages.reserve(keep.size());
+    live.assign(keep.size(), 1);
+    ids.reserve(keep.size());
+    std::map<int, size_t> slots;
+    for (size_t slot : keep) {
+        slots.emplace_hint(slots.end(), idOf(slot), ids.size());
+        ids.push_back(idOf(slot));
+        names.push_back(std::move(names_[slot]));
+        ages.push_back(ages_[slot]);
+    }
+
+    next_id_ = nextId();
+    sparse_ = true;
+    names_.swap(names);
+    ages_.swap(ages);
+    live_.swap(live);
+    ids_.swap(ids);
+    slots_.swap(slots);
+    // Sketch segments are slot ranges; with no readers they can simply go
+    name_sketches_.clear();
+    return dead;
+}
+
+void InMemoryDatabase::setChangeStream(std::shared_ptr<ChangeStream> stream) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    changes_ = std::move(stream);
+}
+
+std::shared_ptr<NameIndex> InMemoryDatabase::enableNameIndex() {
+    auto index = std::make_shared<NameIndex>();
+    addView(index);
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    name_index_ = index;
+    return index;
+}
+
+std::shared_ptr<AgeIndex> InMemoryDatabase::enableAgeIndex() {
+    auto index = std::make_shared<AgeIndex>();
+    addView(index);
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    age_index_ = index;
+    return index;
+}
+
+void InMemoryDatabase::addView(std::shared_ptr<MaterializedView> view) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (size_t slot = 0; slot < live_.size(); ++slot) {
+        if (live_[slot]) {
+            view->onInsert(idOf(slot), names_[slot], ages_[slot]);
+        }
+    }
+    views_.push_back(std::move(view));
+}
+
+std::vector<size_t> InMemoryDatabase::selectSlots(const ParsedQuery& query) const {
+    std::vector<size_t> slots;
+    if (query.hasWhere) {
+        const RoaringBitmap ids = evaluate(query.where);
+        slots.reserve(ids.cardinality());
+        ids.forEach([&slots, this](uint32_t userId) { slots.push_back(slotOf(static_cast<int>(userId))); });
+        return slots;
+    }
+    return liveSlots();
+}
+
+RoaringBitmap InMemoryDatabase::evaluate(const QueryPredicate& predicate, const RoaringBitmap* within) const {
+    RoaringBitmap ids;
+    switch (predicate.kind) {
+    case PredicateKind::NameLike:
+        if (name_index_) {
+            for (int userId : name_index_->findLike(predicate.text)) {
+                ids.add(static_cast<uint32_t>(userId));
+            }
+            break;
+        }
+        for (size_t slot = 0; slot < live_.size(); ++slot) {
+            if (live_[slot] && NameIndex::likeMatch(names_[slot], predicate.text)) {
+                ids.add(static_cast<uint32_t>(idOf(slot)));
+            }
+        }
+        break;
+    case PredicateKind::AgeRange:
+        if (age_index_) {
+            return age_index_->findRange(predicate.low, predicate.high);
+        }
+        for (size_t slot = 0; slot < live_.size(); ++slot) {
+            if (live_[slot] && ages_[slot] >= predicate.low && ages_[slot] <= predicate.high) {
+                ids.add(static_cast<uint32_t>(idOf(slot)));
+            }
+        }
+        break;
+    case PredicateKind::Compare: {
+        // Only candidate rows are evaluated, so a row another operand ruled
+        // out cannot fail the query with, say, a zero divisor
+        std::vector<size_t> slots;
+        if (within != nullptr) {
+            slots.reserve(within->cardinality());
+            within->forEach([&slots, this](uint32_t userId) { slots.push_back(slotOf(static_cast<int>(userId))); });
+        } else {
+            slots = liveSlots();
+        }
+        ExpressionEvaluator evaluator;
+        ExpressionBatch batch;
+        std::vector<uint8_t> selected;
+        for (size_t start = 0; start < slots.size(); start += ExpressionEvaluator::kBatchRows) {
+            const size_t rows = std::min(ExpressionEvaluator::kBatchRows, slots.size() - start);
+            evaluator.compare(predicate, loadBatch(slots.data() + start, rows, batch), selected);
+            for (size_t row = 0; row < rows; ++row) {
+                if (selected[row]) {
+                    ids.add(static_cast<uint32_t>(idOf(slots[start + row])));
+                }
+            }
+        }
+        break;
+    }
+    case PredicateKind::And: {
+        // Bitmap-only operands go first and expression comparisons last, each
+        // over the ids that survived so far. Negated operands are subtracted,
+        // so they only need the live set when nothing else seeded the result
+        std::vector<const QueryPredicate*> order;
+        for (bool rowWise : {false, true}) {
+            for (bool negated : {false, true}) {
+                for (const QueryPredicate& child : predicate.children) {
+                    if ((child.kind == PredicateKind::Not) == negated && comparesRows(child) == rowWise) {
+                        order.push_back(&child);
+                    }
+                }
+            }
+        }
+
+        bool seeded = false;
+        for (const QueryPredicate* child : order) {
+            if (child->kind == PredicateKind::Not) {
+                if (!seeded) {
+                    ids = within != nullptr ? *within : liveIds();
+                    seeded = true;
+                }
+                ids -= evaluate(child->children[0], &ids);
+            } else if (seeded) {
+                ids &= evaluate(*child, &ids);
+            } else {
+                ids = evaluate(*child, within);
+                seeded = true;
+            }
+            if (ids.empty()) {
+                return ids;
+            }
+        }
+        break;
+    }
+    case PredicateKind::Or:
+        for (const QueryPredicate& child : predicate.children) {
+            ids |= evaluate(child, within);
+        }
+        break;
+    case PredicateKind::Not:
+        ids = within != nullptr ? *within : liveIds();
+        ids -= evaluate(predicate.children[0], &ids);
+        break;
+    }
+    return ids;
+}
+
+ExpressionEvaluator::Batch InMemoryDatabase::loadBatch(const size_t* slots, size_t rows,
+                                                      ExpressionBatch& batch) const {
+    batch.ids.resize(rows);
+    batch.ages.resize(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        batch.ids[row] = idOf(slots[row]);
+        batch.ages[row] = ages_[slots[row]];
+    }
+
+    ExpressionEvaluator::Batch view;
+    view.ids = batch.ids.data();
+    view.ages = batch.ages.data();
+    view.rows = rows;
+    return view;
+}
+
+void InMemoryDatabase::projectColumns(const std::vector<QueryColumn>& columns, const std::vector<size_t>& slots,
+                                      std::vector<std::string>& results) const {
+    ExpressionEvaluator evaluator;
+    ExpressionBatch batch;
+    std::vector<std::vector<double>> values(columns.size());
+    for (size_t start = 0; start < slots.size(); start += ExpressionEvaluator::kBatchRows) {
+        const size_t rows = std::min(ExpressionEvaluator::kBatchRows, slots.size() - start);
+        const ExpressionEvaluator::Batch view = loadBatch(slots.data() + start, rows, batch);
+        for (size_t column = 0; column < columns.size(); ++column) {
+            if (!columns[column].isName) {
+                evaluator.evaluate(columns[column].expression, view, values[column]);
+            }
+        }
+
+        for (size_t row = 0; row < rows; ++row) {
+            std::string line;
+            for (size_t column = 0; column < columns.size(); ++column) {
+                if (column > 0) {
+                    line.push_back(',');
+                }
+                if (columns[column].isName) {
+                    line += names_[slots[start + row]];
+                } else {
+                    ExpressionEvaluator::formatInto(line, values[column][row]);
+                }
+            }
+            results.push_back(std::move(line));
+        }
+    }
+}
+
+RoaringBitmap InMemoryDatabase::liveIds() const {
+    RoaringBitmap ids;
+    for (size_t slot = 0; slot < live_.size(); ++slot) {
+        if (live_[slot]) {
+            ids.add(static_cast<uint32_t>(idOf(slot)));
+        }
+    }
+    return ids;
+}
+
+bool InMemoryDatabase::distinctNames(const ParsedQuery& query, HyperLogLog& sketch) const {
+    if (!query.hasWhere) {
+        if (sketch.precision() != HyperLogLog::kDefaultPrecision) {
+            return false;
+        }
+        mergeNameSketches(sketch);
+        return true;
+    }
+
+    // Filtered counts hash the selected names into the caller's sketch directly
+    evaluate(query.where).forEach([&sketch, this](uint32_t userId) {
+        sketch.add(names_[slotOf(static_cast<int>(userId))]);
+    });
+    return true;
+}
+
+void InMemoryDatabase::mergeNameSketches(HyperLogLog& sketch) const {
+    std::lock_guard<std::mutex> lock(sketch_mutex_);
+    const size_t segments = (live_.size() + kSketchSegmentRows - 1) / kSketchSegmentRows;
+    if (name_sketches_.size() < segments) {
+        name_sketches_.resize(segments);
+    }
+
+    for (size_t segment = 0; segment < segments; ++segment) {
+        NameSketch& entry = name_sketches_[segment];
+        if (!entry.valid) {
+            entry.sketch.clear();
+            const size_t end = std::min(live_.size(), (segment + 1) * kSketchSegmentRows);
+            for (size_t slot = segment * kSketchSegmentRows; slot < end; ++slot) {
+                if (live_[slot]) {
+                    entry.sketch.add(names_[slot]);
+                }
+            }
+            entry.valid = true;
+        }
+        sketch.merge(entry.sketch);
+    }
+}
+
+bool InMemoryDatabase::isLive(int userId) const {
+    size_t slot = slotOf(userId);
+    return slot < live_.size() && live_[slot];
+}
+
+void InMemoryDatabase::commitInsert(int userId, const std::string& name, int age) {
+    size_t slot = 0;
+    if (!sparse_) {
+        // Skipped slots become tombstones; later sequential inserts continue past them
+        slot = static_cast<size_t>((userId - first_id_) / id_stride_);
+        if (slot > live_.size() && slot >= kDenseSlack + 2 * static_cast<size_t>(live_count_)) {
+            makeSparse();
+        }
+    }
+    if (sparse_) {
+        // A deleted id gets its old slot back; a new one takes the next slot
+        auto entry = slots_.emplace(userId, live_.size()).first;
+        slot = entry->second;
+        next_id_ = std::max(next_id_, userId + id_stride_);
+    }
+    if (slot >= live_.size()) {
+        names_.resize(slot + 1);
+        ages_.resize(slot + 1, 0);
+        live_.resize(slot + 1, 0);
+        if (sparse_) {
+            ids_.resize(slot + 1);
+        }
+    }
+    if (sparse_) {
+        ids_[slot] = userId;
+    }
+    names_[slot] = name;
+    ages_[slot] = age;
+    live_[slot] = 1;
+    ++live_count_;
+
+    const size_t segment = slot / kSketchSegmentRows;
+    if (segment < name_sketches_.size() && name_sketches_[segment].valid) {
+        name_sketches_[segment].sketch.add(name);
+    }
+
+    for (const auto& view : views_) {
+        view->onInsert(userId, name, age);
+    }
+    if (changes_) {
+        changes_->publish(ChangeType::Insert, userId, name, age);
+    }
+}
+
+void InMemoryDatabase::commitUpdate(size_t slot, const std::string& name, int age) {
+    int userId = idOf(slot);
+    if (name != names_[slot]) {
+        invalidateNameSketch(slot);
+    }
+    for (const auto& view : views_) {
+        view->onUpdate(userId, names_[slot], ages_[slot], name, age);
+    }
+    names_[slot] = name;
+    ages_[slot] = age;
+    if (changes_) {
+        changes_->publish(ChangeType::Update, userId, name, age);
+    }
+}
+
+void InMemoryDatabase::commitDelete(size_t slot) {
+    int userId = idOf(slot);
+    invalidateNameSketch(slot);
+    for (const auto& view : views_) {
+        view->onDelete(userId, names_[slot], ages_[slot]);
+    }
+    if (changes_) {
+        changes_->publish(ChangeType::Delete, userId, names_[slot], ages_[slot]);
+    }
+    live_[slot] = 0;
+    std::string().swap(names_[slot]);
+    --live_count_;
+}
+
+void InMemoryDatabase::invalidateNameSketch(size_t slot) {
+    const size_t segment = slot / kSketchSegmentRows;
+    if (segment < name_sketches_.size()) {
+        name_sketches_[segment].valid = false;
+    }
+}
+
+bool InMemoryDatabase::checkConnected() {
+    if (connected_) {
+        return true;
+    }
+    return report(fail(DbError::NotConnected, "Not connected"));
+}
+
+DbStatus InMemoryDatabase::fail(DbError code, const char* message, const std::string& context) {
+    // Typed callers read the thread-local detail; nothing shared is written
+    return DbStatus::fail(code, message, context);
+}
+
+bool InMemoryDatabase::report(DbStatus status) {
+    if (status.ok()) {
+        return true;
+    }
+    std::string detail = DbStatus::detail();
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_.swap(detail);
+    return false;
+}
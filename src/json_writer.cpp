@@ -0,0 +1,329 @@
+#include "json_writer.h"
+#include "user_info_formatter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+bool needsEscape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+void escapeChar(std::string& out, unsigned char c) {
+    switch (c) {
+    case '"':
+        out.append("\\\"", 2);
+        break;
+    case '\\':
+        out.append("\\\\", 2);
+        break;
+    case '\b':
+        out.append("\\b", 2);
+        break;
+    case '\f':
+        out.append("\\f", 2);
+        break;
+    case '\n':
+        out.append("\\n", 2);
+        break;
+    case '\r':
+        out.append("\\r", 2);
+        break;
+    case '\t':
+        out.append("\\t", 2);
+        break;
+    default: {
+        const char unicode[6] = {'\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xF]};
+        out.append(unicode, sizeof(unicode));
+        break;
+    }
+    }
+}
+
+} // namespace
+
+JsonWriter::JsonWriter(size_t initialCapacity) {
+    buffer_.reserve(initialCapacity);
+}
+
+void JsonWriter::beginObject() {
+    open('{');
+}
+
+void JsonWriter::endObject() {
+    close('}');
+}
+
+void JsonWriter::beginArray() {
+    open('[');
+}
+
+void JsonWriter::endArray() {
+    close(']');
+}
+
+void JsonWriter::key(const std::string& name) {
+    beforeValue();
+    buffer_.push_back('"');
+    escape(buffer_, name.data(), name.size());
+    buffer_.append("\":", 2);
+    after_key_ = true;
+}
+
+void JsonWriter::value(const std::string& text) {
+    value(text.data(), text.size());
+}
+
+void JsonWriter::value(const char* text) {
+    value(text, std::strlen(text));
+}
+
+void JsonWriter::value(const char* text, size_t length) {
+    beforeValue();
+    buffer_.push_back('"');
+    escape(buffer_, text, length);
+    buffer_.push_back('"');
+}
+
+void JsonWriter::value(int number) {
+    beforeValue();
+    char digits[16];
+    char* end = UserInfoFormatter::writeInt(digits, number);
+    buffer_.append(digits, static_cast<size_t>(end - digits));
+}
+
+void JsonWriter::value(bool flag) {
+    beforeValue();
+    if (flag) {
+        buffer_.append("true", 4);
+    } else {
+        buffer_.append("false", 5);
+    }
+}
+
+void JsonWriter::nullValue() {
+    beforeValue();
+    buffer_.append("null", 4);
+}
+
+void JsonWriter::writeUser(const UserRecord& record) {
+    beginObject();
+    key("id");
+    value(record.id);
+    key("name");
+    value(record.name);
+    key("age");
+    value(record.age);
+    endObject();
+}
+
+void JsonWriter::writeUsers(const std::vector<UserRecord>& records) {
+    beginArray();
+    for (const UserRecord& record : records) {
+        if (!record.name.empty()) {
+            writeUser(record);
+        }
+    }
+    endArray();
+}
+
+bool JsonWriter::writeRows(const std::string& query, const std::vector<std::string>& rows) {
+    ParsedQuery parsed;
+    std::string error;
+    if (!QueryParser::parse(query, parsed, error)) {
+        return false;
+    }
+
+    beginArray();
+    for (const std::string& row : rows) {
+        switch (parsed.projection) {
+        case QueryProjection::Star: {
+            // id,name,age: the name is everything between the outer commas
+            const size_t first = row.find(',');
+            const size_t last = row.rfind(',');
+            if (first == std::string::npos || first == last) {
+                nullValue();
+                break;
+            }
+            beginObject();
+            key("id");
+            number(row.data(), first);
+            key("name");
+            value(row.data() + first + 1, last - first - 1);
+            key("age");
+            number(row.data() + last + 1, row.size() - last - 1);
+            endObject();
+            break;
+        }
+        case QueryProjection::Name:
+            beginObject();
+            key("name");
+            value(row);
+            endObject();
+            break;
+        case QueryProjection::Count:
+        case QueryProjection::CountDistinctName:
+            beginObject();
+            key("count");
+            number(row.data(), row.size());
+            endObject();
+            break;
+        case QueryProjection::Columns:
+            writeColumns(parsed.columns, row);
+            break;
+        }
+    }
+    endArray();
+    return true;
+}
+
+void JsonWriter::writeColumns(const std::vector<QueryColumn>& columns, const std::string& row) {
+    // Numbers never hold a comma, so numeric fields are split off from both
+    // ends and the text between the outer NAME columns is left for names
+    std::vector<std::pair<size_t, size_t>> fields(columns.size());  // offset, length
+    size_t begin = 0;
+    size_t end = row.size();
+    size_t low = 0;
+    size_t high = columns.size();
+    while (low < high && !columns[low].isName) {
+        size_t comma = row.find(',', begin);
+        if (comma == std::string::npos || comma > end) {
+            comma = end;
+        }
+        fields[low++] = {begin, comma - begin};
+        begin = std::min(comma + 1, end);
+    }
+    while (high > low && !columns[high - 1].isName) {
+        const size_t comma = end > begin ? row.rfind(',', end - 1) : std::string::npos;
+        const size_t start = comma == std::string::npos || comma < begin ? begin : comma + 1;
+        fields[--high] = {start, end - start};
+        end = start > begin ? start - 1 : begin;
+    }
+    for (size_t column = low; column < high; ++column) {
+        size_t comma = column + 1 < high ? row.find(',', begin) : std::string::npos;
+        if (comma == std::string::npos || comma > end) {
+            comma = end;
+        }
+        fields[column] = {begin, comma - begin};
+        begin = std::min(comma + 1, end);
+    }
+
+    beginArray();
+    for (size_t column = 0; column < columns.size(); ++column) {
+        const char* text = row.data() + fields[column].first;
+        if (columns[column].isName) {
+            value(text, fields[column].second);
+        } else {
+            number(text, fields[column].second);
+        }
+    }
+    endArray();
+}
+
+void JsonWriter::number(const char* text, size_t length) {
+    // The field is a slice of the row, so it is copied out to be terminated
+    char copy[64];
+    bool finite = length > 0 && length < sizeof(copy);
+    if (finite) {
+        std::memcpy(copy, text, length);
+        copy[length] = '\0';
+        char* parsed = nullptr;
+        const double number = std::strtod(copy, &parsed);
+        finite = parsed == copy + length && std::isfinite(number);
+    }
+    if (!finite) {
+        nullValue();
+        return;
+    }
+    beforeValue();
+    buffer_.append(text, length);
+}
+
+std::string JsonWriter::take() {
+    std::string out;
+    out.swap(buffer_);
+    has_items_.clear();
+    after_key_ = false;
+    return out;
+}
+
+void JsonWriter::clear() {
+    buffer_.clear();
+    has_items_.clear();
+    after_key_ = false;
+}
+
+void JsonWriter::escape(std::string& out, const char* data, size_t length) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // Copy clean 16-byte runs whole; stop at the first byte needing an escape
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i controlMax = _mm_set1_epi8(0x1F);
+    while (i + 16 <= length) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        const __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, controlMax), controlMax);
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        const int mask = _mm_movemask_epi8(_mm_or_si128(control, special));
+        if (mask == 0) {
+            out.append(data + i, 16);
+            i += 16;
+            continue;
+        }
+        const size_t clean = static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        out.append(data + i, clean);
+        escapeChar(out, bytes[i + clean]);
+        i += clean + 1;
+    }
+#endif
+
+    while (i < length) {
+        size_t run = i;
+        while (run < length && !needsEscape(bytes[run])) {
+            ++run;
+        }
+        out.append(data + i, run - i);
+        if (run < length) {
+            escapeChar(out, bytes[run]);
+            ++run;
+        }
+        i = run;
+    }
+}
+
+void JsonWriter::beforeValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!has_items_.empty()) {
+        if (has_items_.back()) {
+            buffer_.push_back(',');
+        }
+        has_items_.back() = 1;
+    }
+}
+
+void JsonWriter::open(char bracket) {
+    beforeValue();
+    buffer_.push_back(bracket);
+    has_items_.push_back(0);
+}
+
+void JsonWriter::close(char bracket) {
+    buffer_.push_back(bracket);
+    if (!has_items_.empty()) {
+        has_items_.pop_back();
+    }
+}
@@ -0,0 +1,86 @@
+#include "materialized_view.h"
+#include <stdexcept>
+
+void MaterializedView::onUpdate(int userId, const std::string& oldName, int oldAge,
+                                const std::string& newName, int newAge) {
+    onDelete(userId, oldName, oldAge);
+    onInsert(userId, newName, newAge);
+}
+
+AgeBucketCountView::AgeBucketCountView(int bucketWidth, size_t bucketCount)
+    : bucket_width_(bucketWidth), counts_(bucketCount) {
+    if (bucketWidth <= 0 || bucketCount == 0) {
+        throw std::invalid_argument("Invalid age buckets");
+    }
+}
+
+void AgeBucketCountView::onInsert(int userId, const std::string& name, int age) {
+    (void)userId;
+    (void)name;
+    counts_[bucketOf(age)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AgeBucketCountView::onDelete(int userId, const std::string& name, int age) {
+    (void)userId;
+    (void)name;
+    counts_[bucketOf(age)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void AgeBucketCountView::onUpdate(int userId, const std::string& oldName, int oldAge,
+                                  const std::string& newName, int newAge) {
+    // Renames and moves within a bucket leave the counts untouched
+    if (bucketOf(oldAge) != bucketOf(newAge)) {
+        MaterializedView::onUpdate(userId, oldName, oldAge, newName, newAge);
+    }
+}
+
+size_t AgeBucketCountView::bucketOf(int age) const {
+    if (age < 0) {
+        return 0;
+    }
+    size_t bucket = static_cast<size_t>(age / bucket_width_);
+    return bucket < counts_.size() ? bucket : counts_.size() - 1;
+}
+
+int64_t AgeBucketCountView::getCount(size_t bucket) const {
+    if (bucket >= counts_.size()) {
+        return 0;
+    }
+    return counts_[bucket].load(std::memory_order_relaxed);
+}
+
+std::vector<int64_t> AgeBucketCountView::getCounts() const {
+    std::vector<int64_t> counts;
+    counts.reserve(counts_.size());
+    for (const auto& count : counts_) {
+        counts.push_back(count.load(std::memory_order_relaxed));
+    }
+    return counts;
+}
+
+void AgeStatsView::onInsert(int userId, const std::string& name, int age) {
+    (void)userId;
+    (void)name;
+    count_.fetch_add(1, std::memory_order_relaxed);
+    age_sum_.fetch_add(age, std::memory_order_relaxed);
+}
+
+void AgeStatsView::onDelete(int userId, const std::string& name, int age) {
+    (void)userId;
+    (void)name;
+    count_.fetch_sub(1, std::memory_order_relaxed);
+    age_sum_.fetch_sub(age, std::memory_order_relaxed);
+}
+
+void AgeStatsView::onUpdate(int userId, const std::string& oldName, int oldAge,
+                            const std::string& newName, int newAge) {
+    (void)userId;
+    (void)oldName;
+    (void)newName;
+    age_sum_.fetch_add(static_cast<int64_t>(newAge) - oldAge, std::memory_order_relaxed);
+}
+
+double AgeStatsView::getAverageAge() const {
+    int64_t count = count_.load(std::memory_order_relaxed);
+    return count == 0 ? 0.0 : static_cast<double>(age_sum_.load(std::memory_order_relaxed)) / count;
+}
@@ -0,0 +1,381 @@
+#include "name_index.h"
+#include "edit_distance.h"
+#include "pool_allocator.h"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+void insertSorted(std::vector<int>& ids, int userId) {
+    auto it = std::lower_bound(ids.begin(), ids.end(), userId);
+    if (it == ids.end() || *it != userId) {
+        ids.insert(it, userId);
+    }
+}
+
+void eraseSorted(std::vector<int>& ids, int userId) {
+    auto it = std::lower_bound(ids.begin(), ids.end(), userId);
+    if (it != ids.end() && *it == userId) {
+        ids.erase(it);
+    }
+}
+
+size_t commonPrefix(const std::string& a, size_t aFrom, const std::string& b) {
+    size_t length = 0;
+    while (aFrom + length < a.size() && length < b.size() && a[aFrom + length] == b[length]) {
+        ++length;
+    }
+    return length;
+}
+
+} // namespace
+
+/**
+ * Radix tree node; label is the edge from the parent
+ */
+struct NameIndex::Node {
+    std::string label;
+    std::vector<Node*> children;  // ordered by first label byte
+    std::vector<int> ids;         // users whose whole name ends here
+
+    static void* operator new(size_t bytes) { return SlabPool::allocate(bytes); }
+    static void operator delete(void* pointer, size_t bytes) { SlabPool::deallocate(pointer, bytes); }
+
+    ~Node() {
+        for (Node* child : children) {
+            delete child;
+        }
+    }
+
+    std::vector<Node*>::iterator childFor(char first) {
+        return std::lower_bound(children.begin(), children.end(), first,
+                                [](const Node* child, char c) { return child->label[0] < c; });
+    }
+
+    Node* findChild(char first) const {
+        auto it = std::lower_bound(children.begin(), children.end(), first,
+                                   [](const Node* child, char c) { return child->label[0] < c; });
+        return it != children.end() && (*it)->label[0] == first ? *it : nullptr;
+    }
+
+    void collect(std::vector<int>& out) const {
+        out.insert(out.end(), ids.begin(), ids.end());
+        for (const Node* child : children) {
+            child->collect(out);
+        }
+    }
+};
+
+NameIndex::NameIndex() : root_(new Node) {
+}
+
+NameIndex::~NameIndex() {
+    delete root_;
+}
+
+void NameIndex::onInsert(int userId, const std::string& name, int age) {
+    (void)age;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    insertName(userId, name);
+}
+
+void NameIndex::onDelete(int userId, const std::string& name, int age) {
+    (void)age;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    removeName(userId, name);
+}
+
+void NameIndex::onUpdate(int userId, const std::string& oldName, int oldAge,
+                         const std::string& newName, int newAge) {
+    (void)oldAge;
+    (void)newAge;
+    if (oldName == newName) {
+        return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    removeName(userId, oldName);
+    insertName(userId, newName);
+}
+
+std::vector<int> NameIndex::findPrefix(const std::string& prefix) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return prefixLocked(prefix);
+}
+
+std::vector<int> NameIndex::findSubstring(const std::string& text) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return substringLocked(text);
+}
+
+std::vector<int> NameIndex::findLike(const std::string& pattern) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    // Candidates from the literal prefix, else from the longest literal run
+    const size_t firstWildcard = pattern.find_first_of("%_");
+    std::vector<int> candidates;
+    if (firstWildcard == std::string::npos) {
+        candidates = prefixLocked(pattern);
+    } else if (firstWildcard > 0) {
+        candidates = prefixLocked(pattern.substr(0, firstWildcard));
+    } else {
+        std::string longest;
+        size_t start = 0;
+        while (start < pattern.size()) {
+            size_t end = pattern.find_first_of("%_", start);
+            if (end == std::string::npos) {
+                end = pattern.size();
+            }
+            if (end - start > longest.size()) {
+                longest = pattern.substr(start, end - start);
+            }
+            start = end + 1;
+        }
+        candidates = substringLocked(longest);
+    }
+
+    std::vector<int> matches;
+    for (int userId : candidates) {
+        if (likeMatch(names_.at(userId), pattern)) {
+            matches.push_back(userId);
+        }
+    }
+    return matches;
+}
+
+std::vector<NameMatch> NameIndex::findSimilar(const std::string& name, int maxDistance) const {
+    std::vector<NameMatch> matches;
+    if (maxDistance < 0) {
+        return matches;
+    }
+    const EditDistanceMatcher matcher(name);
+    const std::vector<uint32_t> trigrams = trigramsOf(name);
+    const long required = static_cast<long>(trigrams.size()) - 3L * maxDistance;
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto verify = [&](int userId, const std::string& candidate) {
+        int distance = matcher.distance(candidate, maxDistance);
+        if (distance <= maxDistance) {
+            matches.push_back({userId, distance});
+        }
+    };
+
+    if (required <= 0) {
+        // The count filter cannot exclude anything; the matcher still
+        // rejects on length before running the kernel
+        for (const auto& entry : names_) {
+            verify(entry.first, entry.second);
+        }
+    } else {
+        std::unordered_map<int, int> shared;
+        for (uint32_t trigram : trigrams) {
+            auto it = postings_.find(trigram);
+            if (it != postings_.end()) {
+                for (int userId : it->second) {
+                    ++shared[userId];
+                }
+            }
+        }
+        for (const auto& entry : shared) {
+            if (entry.second >= required) {
+                verify(entry.first, names_.at(entry.first));
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const NameMatch& a, const NameMatch& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.userId < b.userId;
+    });
+    return matches;
+}
+
+bool NameIndex::likeMatch(const std::string& text, const std::string& pattern) {
+    // Greedy wildcard matching; backtracks only to the most recent %
+    size_t t = 0;
+    size_t p = 0;
+    size_t starPattern = std::string::npos;
+    size_t starText = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '_' || pattern[p] == text[t])) {
+            ++t;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '%') {
+            starPattern = p++;
+            starText = t;
+        } else if (starPattern != std::string::npos) {
+            p = starPattern + 1;
+            t = ++starText;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '%') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+size_t NameIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.size();
+}
+
+void NameIndex::insertName(int userId, const std::string& name) {
+    names_[userId] = name;
+    for (uint32_t trigram : trigramsOf(name)) {
+        insertSorted(postings_[trigram], userId);
+    }
+
+    Node* node = root_;
+    size_t position = 0;
+    while (position < name.size()) {
+        auto it = node->childFor(name[position]);
+        if (it == node->children.end() || (*it)->label[0] != name[position]) {
+            Node* leaf = new Node;
+            leaf->label = name.substr(position);
+            leaf->ids.push_back(userId);
+            node->children.insert(it, leaf);
+            return;
+        }
+
+        Node* child = *it;
+        const size_t shared = commonPrefix(name, position, child->label);
+        if (shared < child->label.size()) {
+            // Split the edge where the new name diverges
+            Node* middle = new Node;
+            middle->label = child->label.substr(0, shared);
+            child->label.erase(0, shared);
+            middle->children.push_back(child);
+            *it = middle;
+            child = middle;
+        }
+        node = child;
+        position += shared;
+    }
+    insertSorted(node->ids, userId);
+}
+
+void NameIndex::removeName(int userId, const std::string& name) {
+    names_.erase(userId);
+    for (uint32_t trigram : trigramsOf(name)) {
+        auto it = postings_.find(trigram);
+        if (it != postings_.end()) {
+            eraseSorted(it->second, userId);
+            if (it->second.empty()) {
+                postings_.erase(it);
+            }
+        }
+    }
+
+    std::vector<Node*> path{root_};
+    size_t position = 0;
+    while (position < name.size()) {
+        Node* child = path.back()->findChild(name[position]);
+        if (child == nullptr || name.compare(position, child->label.size(), child->label) != 0) {
+            return;
+        }
+        path.push_back(child);
+        position += child->label.size();
+    }
+    eraseSorted(path.back()->ids, userId);
+
+    // Drop empty leaves, then merge pass-through nodes into their only child
+    for (size_t depth = path.size() - 1; depth > 0; --depth) {
+        Node* node = path[depth];
+        Node* parent = path[depth - 1];
+        if (!node->ids.empty()) {
+            break;
+        }
+        if (node->children.empty()) {
+            parent->children.erase(parent->childFor(node->label[0]));
+            delete node;
+            continue;
+        }
+        if (node->children.size() == 1) {
+            Node* only = node->children[0];
+            node->label += only->label;
+            node->ids.swap(only->ids);
+            node->children = std::move(only->children);
+            only->children.clear();
+            delete only;
+        }
+        break;
+    }
+}
+
+std::vector<int> NameIndex::prefixLocked(const std::string& prefix) const {
+    const Node* node = root_;
+    size_t position = 0;
+    while (position < prefix.size()) {
+        const Node* child = node->findChild(prefix[position]);
+        if (child == nullptr) {
+            return {};
+        }
+        const size_t shared = commonPrefix(prefix, position, child->label);
+        if (shared < child->label.size() && position + shared < prefix.size()) {
+            return {};
+        }
+        node = child;
+        position += shared;
+    }
+
+    std::vector<int> ids;
+    node->collect(ids);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::vector<int> NameIndex::substringLocked(const std::string& text) const {
+    std::vector<int> matches;
+    if (text.size() < 3) {
+        for (const auto& entry : names_) {
+            if (entry.second.find(text) != std::string::npos) {
+                matches.push_back(entry.first);
+            }
+        }
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    std::vector<const std::vector<int>*> lists;
+    for (uint32_t trigram : trigramsOf(text)) {
+        auto it = postings_.find(trigram);
+        if (it == postings_.end()) {
+            return matches;
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+    std::vector<int> candidates = *lists[0];
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        std::vector<int> narrowed;
+        std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(narrowed));
+        candidates.swap(narrowed);
+    }
+
+    // Shared trigrams do not imply adjacency, so confirm each candidate
+    for (int userId : candidates) {
+        if (names_.at(userId).find(text) != std::string::npos) {
+            matches.push_back(userId);
+        }
+    }
+    return matches;
+}
+
+uint32_t NameIndex::trigramAt(const std::string& text, size_t position) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(text[position])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(text[position + 1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[position + 2]));
+}
+
+std::vector<uint32_t> NameIndex::trigramsOf(const std::string& text) {
+    std::vector<uint32_t> trigrams;
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        trigrams.push_back(trigramAt(text, i));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
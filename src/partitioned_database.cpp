@@ -0,0 +1,524 @@
+#include "partitioned_database.h"
+#include "mpsc_queue.h"
+#include "router_support.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Empty polls before a worker parks on its condition variable
+constexpr unsigned kSpinLimit = 64;
+// Upper bound on a parked worker's sleep, guards against a missed wakeup
+constexpr std::chrono::milliseconds kParkTimeout(10);
+
+void pinToCore(size_t index) {
+#ifdef __linux__
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores == 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+} // namespace
+
+struct PartitionedDatabase::Partition {
+    MpscQueue<Task> queue;
+    std::atomic<bool> sleeping{false};
+    bool stopping = false;  // only touched by the worker thread
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+};
+
+template <typename R, typename Fn>
+R PartitionedDatabase::call(size_t partition, Fn fn) {
+    std::promise<R> promise;
+    std::future<R> reply = promise.get_future();
+    submit(partition, [&promise, &fn](InMemoryDatabase& db) {
+        promise.set_value(fn(db));
+    });
+    return reply.get();
+}
+
+template <typename Fn>
+DbStatus PartitionedDatabase::callTyped(size_t partition, Fn fn) {
+    // The worker records the detail in its own thread-local storage, so it
+    // is copied out there and recorded again on the calling thread
+    std::string detail;
+    const DbStatus status = call<DbStatus>(partition, [&fn, &detail](InMemoryDatabase& db) {
+        const DbStatus result = fn(db);
+        if (!result.ok()) {
+            detail = DbStatus::detail();
+        }
+        return result;
+    });
+    return status.ok() ? status : DbStatus::fail(status.code(), "", detail);
+}
+
+template <typename R, typename Fn>
+std::vector<R> PartitionedDatabase::broadcast(Fn fn) {
+    std::vector<std::promise<R>> promises(partitions_.size());
+    for (size_t partition = 0; partition < partitions_.size(); ++partition) {
+        submit(partition, [&promises, &fn, partition](InMemoryDatabase& db) {
+            promises[partition].set_value(fn(db));
+        });
+    }
+
+    std::vector<R> replies;
+    replies.reserve(promises.size());
+    for (auto& promise : promises) {
+        replies.push_back(promise.get_future().get());
+    }
+    return replies;
+}
+
+PartitionedDatabase::PartitionedDatabase(size_t partitions) {
+    if (partitions == 0) {
+        partitions = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    partitions_.reserve(partitions);
+    for (size_t index = 0; index < partitions; ++index) {
+        partitions_.push_back(std::make_unique<Partition>());
+    }
+
+    for (size_t index = 0; index < partitions; ++index) {
+        Partition& part = *partitions_[index];
+        part.worker = std::thread([&part, index, partitions]() {
+            pinToCore(index);
+
+            // Built on the worker and bound to its NUMA node, so the
+            // partition's columns are local to the core that owns them
+            InMemoryDatabase db(static_cast<int>(index) + 1, static_cast<int>(partitions),
+                                HugePageMemory::currentNumaNode());
+            db.connect("partition");
+
+            Task task;
+            unsigned idle = 0;
+            while (!part.stopping) {
+                if (part.queue.pop(task)) {
+                    task(db);
+                    task = nullptr;
+                    idle = 0;
+                    continue;
+                }
+                if (++idle < kSpinLimit) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(part.mutex);
+                part.sleeping.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (part.queue.empty()) {
+                    part.wake.wait_for(lock, kParkTimeout);
+                }
+                part.sleeping.store(false);
+                idle = 0;
+            }
+        });
+    }
+}
+
+PartitionedDatabase::~PartitionedDatabase() {
+    for (size_t index = 0; index < partitions_.size(); ++index) {
+        Partition* target = partitions_[index].get();
+        submit(index, [target](InMemoryDatabase&) {
+            target->stopping = true;
+        });
+    }
+    for (auto& part : partitions_) {
+        part->worker.join();
+    }
+}
+
+bool PartitionedDatabase::connect(const std::string& connectionString) {
+    (void)connectionString;
+    connected_ = true;
+    return true;
+}
+
+void PartitionedDatabase::disconnect() {
+    connected_ = false;
+}
+
+bool PartitionedDatabase::isConnected() const {
+    return connected_;
+}
+
+bool PartitionedDatabase::insertUser(const std::string& name, int age) {
+    return insertUserReturningId(name, age) > 0;
+}
+
+int PartitionedDatabase::insertUserReturningId(const std::string& name, int age) {
+    if (!checkConnected()) {
+        return -1;
+    }
+
+    size_t partition = next_insert_++ % partitions_.size();
+    return call<int>(partition, [&](InMemoryDatabase& db) {
+        int userId = db.insertUserReturningId(name, age);
+        if (userId < 0) {
+            setError(db.getLastError());
+        }
+        return userId;
+    });
+}
+
+bool PartitionedDatabase::insertUserWithId(int userId, const std::string& name, int age) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    return call<bool>(partitionOf(userId), [&](InMemoryDatabase& db) {
+        bool inserted = db.insertUserWithId(userId, name, age);
+        if (!inserted) {
+            setError(db.getLastError());
+        }
+        return inserted;
+    });
+}
+
+std::string PartitionedDatabase::getUserName(int userId) {
+    if (!checkConnected()) {
+        return "";
+    }
+
+    return call<std::string>(partitionOf(userId), [userId](InMemoryDatabase& db) {
+        return db.getUserName(userId);
+    });
+}
+
+int PartitionedDatabase::getUserAge(int userId) {
+    if (!checkConnected()) {
+        return -1;
+    }
+
+    return call<int>(partitionOf(userId), [userId](InMemoryDatabase& db) {
+        return db.getUserAge(userId);
+    });
+}
+
+bool PartitionedDatabase::updateUser(int userId, const std::string& name, int age) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    return call<bool>(partitionOf(userId), [&](InMemoryDatabase& db) {
+        bool updated = db.updateUser(userId, name, age);
+        if (!updated) {
+            setError(db.getLastError());
+        }
+        return updated;
+    });
+}
+
+bool PartitionedDatabase::deleteUser(int userId) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    return call<bool>(partitionOf(userId), [&](InMemoryDatabase& db) {
+        bool deleted = db.deleteUser(userId);
+        if (!deleted) {
+            setError(db.getLastError());
+        }
+        return deleted;
+    });
+}
+
+DbStatus PartitionedDatabase::tryInsertUser(const std::string& name, int age) {
+    if (!connected_) {
+        return DbStatus::fail(DbError::NotConnected, "Not connected");
+    }
+
+    size_t partition = next_insert_++ % partitions_.size();
+    return callTyped(partition, [&](InMemoryDatabase& db) {
+        return db.tryInsertUser(name, age);
+    });
+}
+
+DbStatus PartitionedDatabase::tryInsertUserWithId(int userId, const std::string& name, int age) {
+    if (!connected_) {
+        return DbStatus::fail(DbError::NotConnected, "Not connected");
+    }
+
+    return callTyped(partitionOf(userId), [&](InMemoryDatabase& db) {
+        return db.tryInsertUserWithId(userId, name, age);
+    });
+}
+
+DbStatus PartitionedDatabase::tryUpdateUser(int userId, const std::string& name, int age) {
+    if (!connected_) {
+        return DbStatus::fail(DbError::NotConnected, "Not connected");
+    }
+
+    return callTyped(partitionOf(userId), [&](InMemoryDatabase& db) {
+        return db.tryUpdateUser(userId, name, age);
+    });
+}
+
+DbStatus PartitionedDatabase::tryDeleteUser(int userId) {
+    if (!connected_) {
+        return DbStatus::fail(DbError::NotConnected, "Not connected");
+    }
+
+    return callTyped(partitionOf(userId), [userId](InMemoryDatabase& db) {
+        return db.tryDeleteUser(userId);
+    });
+}
+
+DbStatus PartitionedDatabase::tryGetUser(int userId, UserRecord& out) {
+    if (!connected_) {
+        out = UserRecord();
+        out.id = userId;
+        return DbStatus::fail(DbError::NotConnected, "Not connected");
+    }
+
+    return callTyped(partitionOf(userId), [userId, &out](InMemoryDatabase& db) {
+        return db.tryGetUser(userId, out);
+    });
+}
+
+std::vector<UserRecord> PartitionedDatabase::getUsers(const std::vector<int>& userIds) {
+    std::vector<UserRecord> records(userIds.size());
+    for (size_t i = 0; i < userIds.size(); ++i) {
+        records[i].id = userIds[i];
+    }
+    if (!checkConnected()) {
+        return records;
+    }
+
+    // One message per partition carrying that partition's share of the batch
+    const size_t count = partitions_.size();
+    std::vector<std::vector<int>> ids(count);
+    std::vector<std::vector<size_t>> positions(count);
+    for (size_t i = 0; i < userIds.size(); ++i) {
+        size_t partition = partitionOf(userIds[i]);
+        ids[partition].push_back(userIds[i]);
+        positions[partition].push_back(i);
+    }
+
+    std::vector<std::promise<void>> done(count);
+    for (size_t partition = 0; partition < count; ++partition) {
+        if (ids[partition].empty()) {
+            continue;
+        }
+        submit(partition, [&, partition](InMemoryDatabase& db) {
+            std::vector<UserRecord> found = db.getUsers(ids[partition]);
+            for (size_t k = 0; k < found.size(); ++k) {
+                records[positions[partition][k]] = std::move(found[k]);
+            }
+            done[partition].set_value();
+        });
+    }
+    for (size_t partition = 0; partition < count; ++partition) {
+        if (!ids[partition].empty()) {
+            done[partition].get_future().wait();
+        }
+    }
+    return records;
+}
+
+std::vector<UserRecord> PartitionedDatabase::listUsers(int afterId, size_t limit) {
+    if (!checkConnected() || limit == 0) {
+        return {};
+    }
+
+    // Each partition seeks its own id order; the first limit overall are
+    // among the first limit of some partition
+    std::vector<std::vector<UserRecord>> pages = broadcast<std::vector<UserRecord>>(
+        [afterId, limit](InMemoryDatabase& db) { return db.listUsers(afterId, limit); });
+    return RouterSupport::mergePages(pages, limit);
+}
+
+std::vector<std::string> PartitionedDatabase::getAllUserNames() {
+    std::vector<std::string> names;
+    if (!checkConnected()) {
+        return names;
+    }
+
+    for (auto& part : broadcast<std::vector<std::string>>([](InMemoryDatabase& db) {
+             return db.getAllUserNames();
+         })) {
+        names.insert(names.end(), std::make_move_iterator(part.begin()),
+                     std::make_move_iterator(part.end()));
+    }
+    return names;
+}
+
+int PartitionedDatabase::getUserCount() {
+    if (!checkConnected()) {
+        return -1;
+    }
+
+    int total = 0;
+    for (int count : broadcast<int>([](InMemoryDatabase& db) { return db.getUserCount(); })) {
+        total += count;
+    }
+    return total;
+}
+
+bool PartitionedDatabase::executeQuery(const std::string& query, std::vector<std::string>& results) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    // Distinct counts cannot be summed; they go through mergeDistinctNames
+    QueryProjection projection = QueryProjection::Star;
+    const bool parsed = RouterSupport::projectionOf(query, projection);
+    if (parsed && projection == QueryProjection::CountDistinctName) {
+        results.clear();
+        HyperLogLog sketch;
+        if (!mergeDistinctNames(query, sketch)) {
+            return false;
+        }
+        results.push_back(std::to_string(sketch.estimate()));
+        return true;
+    }
+
+    struct Reply {
+        bool ok = false;
+        std::vector<std::string> rows;
+    };
+    std::vector<Reply> replies = broadcast<Reply>([&query, this](InMemoryDatabase& db) {
+        Reply reply;
+        reply.ok = db.executeQuery(query, reply.rows);
+        if (!reply.ok) {
+            setError(db.getLastError());
+        }
+        return reply;
+    });
+
+    results.clear();
+    for (const Reply& reply : replies) {
+        if (!reply.ok) {
+            results.clear();
+            return false;
+        }
+    }
+
+    // Aggregates are combined; row results are concatenated partition by partition
+    if (parsed && projection == QueryProjection::Count) {
+        long long total = 0;
+        for (const Reply& reply : replies) {
+            for (const std::string& row : reply.rows) {
+                total += std::stoll(row);
+            }
+        }
+        results.push_back(std::to_string(total));
+        return true;
+    }
+    for (Reply& reply : replies) {
+        results.insert(results.end(), std::make_move_iterator(reply.rows.begin()),
+                       std::make_move_iterator(reply.rows.end()));
+    }
+    return true;
+}
+
+bool PartitionedDatabase::mergeDistinctNames(const std::string& query, HyperLogLog& sketch) {
+    if (!checkConnected()) {
+        return false;
+    }
+
+    struct Reply {
+        bool ok = false;
+        HyperLogLog sketch;
+    };
+    const int precision = sketch.precision();
+    std::vector<Reply> replies = broadcast<Reply>([&query, precision, this](InMemoryDatabase& db) {
+        Reply reply{false, HyperLogLog(precision)};
+        reply.ok = db.mergeDistinctNames(query, reply.sketch);
+        if (!reply.ok) {
+            setError(db.getLastError());
+        }
+        return reply;
+    });
+
+    for (const Reply& reply : replies) {
+        if (!reply.ok) {
+            return false;
+        }
+    }
+    for (const Reply& reply : replies) {
+        sketch.merge(reply.sketch);
+    }
+    return true;
+}
+
+int64_t PartitionedDatabase::estimateDistinctNames() {
+    HyperLogLog sketch;
+    if (!mergeDistinctNames("SELECT COUNT(DISTINCT NAME) FROM USERS", sketch)) {
+        return -1;
+    }
+    return static_cast<int64_t>(sketch.estimate());
+}
+
+std::string PartitionedDatabase::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void PartitionedDatabase::clearError() {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_.clear();
+}
+
+void PartitionedDatabase::setChangeStream(std::shared_ptr<ChangeStream> stream) {
+    broadcast<bool>([&stream](InMemoryDatabase& db) {
+        db.setChangeStream(stream);
+        return true;
+    });
+}
+
+void PartitionedDatabase::addView(std::shared_ptr<MaterializedView> view) {
+    broadcast<bool>([&view](InMemoryDatabase& db) {
+        db.addView(view);
+        return true;
+    });
+}
+
+size_t PartitionedDatabase::partitionOf(int userId) const {
+    if (userId < 1) {
+        return 0;
+    }
+    return static_cast<size_t>(userId - 1) % partitions_.size();
+}
+
+void PartitionedDatabase::submit(size_t partition, Task task) {
+    Partition& part = *partitions_[partition];
+    part.queue.push(std::move(task));
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (part.sleeping.load()) {
+        std::lock_guard<std::mutex> lock(part.mutex);
+        part.wake.notify_one();
+    }
+}
+
+bool PartitionedDatabase::checkConnected() {
+    if (connected_) {
+        return true;
+    }
+    setError("Not connected");
+    return false;
+}
+
+void PartitionedDatabase::setError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = message;
+}
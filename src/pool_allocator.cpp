@@ -0,0 +1,232 @@
+#include "pool_allocator.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace {
+
+constexpr size_t kClassCount = SlabPool::kMaxBlockSize / SlabPool::kGranularity;
+
+size_t classOf(size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / SlabPool::kGranularity;
+}
+
+size_t blockSizeOf(size_t index) {
+    return (index + 1) * SlabPool::kGranularity;
+}
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+/**
+ * Central free lists and slabs; shared by every thread
+ * Free blocks are chained through their own first word, so returning
+ * blocks never allocates and release() cannot throw.
+ */
+struct CentralPool {
+    struct SizeClass {
+        std::mutex mutex;
+        FreeBlock* free = nullptr;
+        size_t freeCount = 0;
+        std::vector<std::unique_ptr<char[]>> slabs;
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> reservedBytes{0};
+    };
+
+    std::array<SizeClass, kClassCount> classes;
+
+    // Moves up to `count` free blocks of class `index` onto `head`; returns how many
+    size_t fetch(size_t index, size_t count, FreeBlock*& head) {
+        SizeClass& sizeClass = classes[index];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        if (sizeClass.freeCount < count) {
+            carveSlab(index, sizeClass);
+        }
+        size_t moved = 0;
+        while (moved < count && sizeClass.free != nullptr) {
+            FreeBlock* block = sizeClass.free;
+            sizeClass.free = block->next;
+            block->next = head;
+            head = block;
+            ++moved;
+        }
+        sizeClass.freeCount -= moved;
+        return moved;
+    }
+
+    // Splices a whole list of blocks in under one lock acquisition
+    void release(size_t index, FreeBlock* head) noexcept {
+        FreeBlock* tail = head;
+        size_t count = 1;
+        while (tail->next != nullptr) {
+            tail = tail->next;
+            ++count;
+        }
+        SizeClass& sizeClass = classes[index];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        tail->next = sizeClass.free;
+        sizeClass.free = head;
+        sizeClass.freeCount += count;
+    }
+
+    void carveSlab(size_t index, SizeClass& sizeClass) {
+        const size_t blockSize = blockSizeOf(index);
+        std::unique_ptr<char[]> slab(new char[SlabPool::kSlabSize]);
+        // Room for the slab is made before it is threaded onto the free list, so the
+        // push_back below cannot throw; doubling keeps the total copying linear
+        if (sizeClass.slabs.size() == sizeClass.slabs.capacity()) {
+            sizeClass.slabs.reserve(std::max<size_t>(8, 2 * sizeClass.slabs.capacity()));
+        }
+        for (size_t offset = 0; offset + blockSize <= SlabPool::kSlabSize; offset += blockSize) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab.get() + offset);
+            block->next = sizeClass.free;
+            sizeClass.free = block;
+            ++sizeClass.freeCount;
+        }
+        sizeClass.slabs.push_back(std::move(slab));
+        sizeClass.reservedBytes.fetch_add(SlabPool::kSlabSize, std::memory_order_relaxed);
+    }
+};
+
+CentralPool& centralPool() {
+    // Intentionally leaked so thread caches can drain into it during shutdown
+    static CentralPool* pool = new CentralPool;
+    return *pool;
+}
+
+/**
+ * Per-thread free lists with locally accumulated counters
+ */
+class ThreadCache {
+public:
+    ~ThreadCache() {
+        for (size_t index = 0; index < kClassCount; ++index) {
+            publishCounters(index);
+            if (lists_[index].head != nullptr) {
+                centralPool().release(index, lists_[index].head);
+            }
+        }
+    }
+
+    void* allocate(size_t index) {
+        List& list = lists_[index];
+        if (list.head == nullptr) {
+            publishCounters(index);
+            list.count += centralPool().fetch(index, SlabPool::kBatchSize, list.head);
+            if (list.head == nullptr) {
+                throw std::bad_alloc();
+            }
+        }
+        FreeBlock* block = list.head;
+        list.head = block->next;
+        --list.count;
+        ++list.allocations;
+        return block;
+    }
+
+    void deallocate(size_t index, void* pointer) noexcept {
+        List& list = lists_[index];
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        block->next = list.head;
+        list.head = block;
+        ++list.count;
+        ++list.frees;
+
+        // Keep one batch locally, hand the surplus back in bulk
+        if (list.count >= 2 * SlabPool::kBatchSize) {
+            FreeBlock* surplus = list.head;
+            FreeBlock* last = surplus;
+            for (size_t i = 1; i < SlabPool::kBatchSize; ++i) {
+                last = last->next;
+            }
+            list.head = last->next;
+            last->next = nullptr;
+            list.count -= SlabPool::kBatchSize;
+            publishCounters(index);
+            centralPool().release(index, surplus);
+        }
+    }
+
+private:
+    struct List {
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+    };
+
+    void publishCounters(size_t index) noexcept {
+        List& list = lists_[index];
+        CentralPool::SizeClass& sizeClass = centralPool().classes[index];
+        if (list.allocations != 0) {
+            sizeClass.allocations.fetch_add(list.allocations, std::memory_order_relaxed);
+            list.allocations = 0;
+        }
+        if (list.frees != 0) {
+            sizeClass.frees.fetch_add(list.frees, std::memory_order_relaxed);
+            list.frees = 0;
+        }
+    }
+
+    std::array<List, kClassCount> lists_;
+};
+
+ThreadCache& threadCache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+} // namespace
+
+double SlabPool::ClassStats::fragmentation() const {
+    if (reservedBytes == 0) {
+        return 0.0;
+    }
+    return 1.0 - static_cast<double>(inUseBytes()) / static_cast<double>(reservedBytes);
+}
+
+void* SlabPool::allocate(size_t bytes) {
+    if (bytes > kMaxBlockSize) {
+        return ::operator new(bytes);
+    }
+    return threadCache().allocate(classOf(bytes));
+}
+
+void SlabPool::deallocate(void* pointer, size_t bytes) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    if (bytes > kMaxBlockSize) {
+        ::operator delete(pointer);
+        return;
+    }
+    threadCache().deallocate(classOf(bytes), pointer);
+}
+
+std::vector<SlabPool::ClassStats> SlabPool::getStats() {
+    std::vector<ClassStats> stats;
+    stats.reserve(kClassCount);
+    for (size_t index = 0; index < kClassCount; ++index) {
+        stats.push_back(getStats(blockSizeOf(index)));
+    }
+    return stats;
+}
+
+SlabPool::ClassStats SlabPool::getStats(size_t bytes) {
+    ClassStats stats;
+    if (bytes == 0 || bytes > kMaxBlockSize) {
+        return stats;
+    }
+    size_t index = classOf(bytes);
+    const CentralPool::SizeClass& sizeClass = centralPool().classes[index];
+    stats.blockSize = blockSizeOf(index);
+    stats.allocations = sizeClass.allocations.load(std::memory_order_relaxed);
+    stats.frees = sizeClass.frees.load(std::memory_order_relaxed);
+    stats.reservedBytes = sizeClass.reservedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,506 @@
+#include "query_parser.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+enum class TokenType {
+    Word,
+    String,
+    Number,
+    Symbol,
+    End,
+};
+
+struct Token {
+    TokenType type = TokenType::End;
+    std::string text;  // words uppercased, strings unquoted
+};
+
+bool tokenize(const std::string& query, std::vector<Token>& tokens, std::string& error) {
+    size_t i = 0;
+    while (i < query.size()) {
+        const unsigned char c = static_cast<unsigned char>(query[i]);
+        if (std::isspace(c)) {
+            ++i;
+            continue;
+        }
+
+        Token token;
+        if (std::isalpha(c) || c == '_') {
+            token.type = TokenType::Word;
+            while (i < query.size() && (std::isalnum(static_cast<unsigned char>(query[i])) || query[i] == '_')) {
+                token.text.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(query[i]))));
+                ++i;
+            }
+        } else if (std::isdigit(c)) {
+            token.type = TokenType::Number;
+            while (i < query.size() && std::isdigit(static_cast<unsigned char>(query[i]))) {
+                token.text.push_back(query[i++]);
+            }
+        } else if (c == '\'') {
+            token.type = TokenType::String;
+            ++i;
+            while (true) {
+                if (i >= query.size()) {
+                    error = "Unterminated string literal";
+                    return false;
+                }
+                if (query[i] == '\'') {
+                    if (i + 1 < query.size() && query[i + 1] == '\'') {
+                        token.text.push_back('\'');
+                        i += 2;
+                        continue;
+                    }
+                    ++i;
+                    break;
+                }
+                token.text.push_back(query[i++]);
+            }
+        } else {
+            token.type = TokenType::Symbol;
+            token.text.push_back(static_cast<char>(c));
+            ++i;
+            // Two-character comparison operators
+            if (i < query.size() && (c == '<' || c == '>' || c == '!') &&
+                (query[i] == '=' || (c == '<' && query[i] == '>'))) {
+                token.text.push_back(query[i++]);
+            }
+        }
+        tokens.push_back(std::move(token));
+    }
+    tokens.push_back(Token());
+    return true;
+}
+
+class Parser {
+public:
+    Parser(const std::vector<Token>& tokens, std::string& error) : tokens_(tokens), error_(error) {}
+
+    bool parseQuery(ParsedQuery& out) {
+        if (!expectWord("SELECT") || !parseProjection(out) || !expectWord("FROM") || !expectWord("USERS")) {
+            return false;
+        }
+        if (acceptWord("WHERE")) {
+            out.hasWhere = true;
+            if (!parsePredicate(out.where)) {
+                return false;
+            }
+        }
+        while (acceptSymbol(";")) {
+        }
+        if (peek().type != TokenType::End) {
+            return fail("Unexpected '" + peek().text + "'");
+        }
+        return true;
+    }
+
+private:
+    bool parseProjection(ParsedQuery& out) {
+        if (acceptSymbol("*")) {
+            out.projection = QueryProjection::Star;
+            return true;
+        }
+        if (acceptWord("COUNT")) {
+            if (!expectSymbol("(")) {
+                return false;
+            }
+            if (acceptWord("DISTINCT")) {
+                out.projection = QueryProjection::CountDistinctName;
+                return expectWord("NAME") && expectSymbol(")");
+            }
+            out.projection = QueryProjection::Count;
+            return expectSymbol("*") && expectSymbol(")");
+        }
+
+        do {
+            QueryColumn column;
+            size_t height = 0;
+            if (acceptWord("NAME")) {
+                column.isName = true;
+            } else if (!parseExpression(column.expression, height)) {
+                return false;
+            }
+            out.columns.push_back(std::move(column));
+        } while (acceptSymbol(","));
+
+        if (out.columns.size() == 1 && out.columns[0].isName) {
+            out.columns.clear();
+            out.projection = QueryProjection::Name;
+        } else {
+            out.projection = QueryProjection::Columns;
+        }
+        return true;
+    }
+
+    bool parsePredicate(QueryPredicate& predicate) {
+        return parseChain(predicate, "OR", PredicateKind::Or, &Parser::parseTerm);
+    }
+
+    bool parseTerm(QueryPredicate& predicate) {
+        return parseChain(predicate, "AND", PredicateKind::And, &Parser::parseFactor);
+    }
+
+    // operand { keyword operand }, flattened into one node of the given kind
+    bool parseChain(QueryPredicate& predicate, const char* keyword, PredicateKind kind,
+                    bool (Parser::*operand)(QueryPredicate&)) {
+        QueryPredicate first;
+        if (!(this->*operand)(first)) {
+            return false;
+        }
+        if (!acceptWord(keyword)) {
+            predicate = std::move(first);
+            return true;
+        }
+        predicate = QueryPredicate();
+        predicate.kind = kind;
+        predicate.children.push_back(std::move(first));
+        do {
+            QueryPredicate rest;
+            if (!(this->*operand)(rest)) {
+                return false;
+            }
+            predicate.children.push_back(std::move(rest));
+        } while (acceptWord(keyword));
+        return true;
+    }
+
+    bool parseFactor(QueryPredicate& predicate) {
+        Nesting nesting(*this);
+        if (!nesting.ok()) {
+            return tooDeep();
+        }
+        if (acceptWord("NOT")) {
+            QueryPredicate operand;
+            if (!parseFactor(operand)) {
+                return false;
+            }
+            predicate = QueryPredicate();
+            predicate.kind = PredicateKind::Not;
+            predicate.children.push_back(std::move(operand));
+            return true;
+        }
+        if (acceptSymbol("(")) {
+            // A parenthesized condition, or the left operand of a comparison
+            // such as (AGE + 1) * 2 > 60; the latter is retried from '('
+            const size_t open = position_ - 1;
+            if (parsePredicate(predicate) && acceptSymbol(")")) {
+                return true;
+            }
+            if (too_deep_) {
+                return false;
+            }
+            position_ = open;
+        }
+        if (acceptWord("NAME")) {
+            if (!expectWord("LIKE")) {
+                return false;
+            }
+            if (peek().type != TokenType::String) {
+                return fail("LIKE needs a quoted pattern");
+            }
+            predicate = QueryPredicate();
+            predicate.kind = PredicateKind::NameLike;
+            predicate.text = next().text;
+            return true;
+        }
+        return parseComparison(predicate);
+    }
+
+    bool parseComparison(QueryPredicate& predicate) {
+        QueryExpression left;
+        size_t height = 0;
+        if (!parseExpression(left, height)) {
+            return false;
+        }
+
+        if (acceptWord("BETWEEN")) {
+            QueryExpression low;
+            QueryExpression high;
+            if (!parseExpression(low, height) || !expectWord("AND") || !parseExpression(high, height)) {
+                return false;
+            }
+            QueryPredicate lower = comparison(left, CompareOp::GreaterEqual, std::move(low));
+            QueryPredicate upper = comparison(std::move(left), CompareOp::LessEqual, std::move(high));
+            if (lower.kind == PredicateKind::AgeRange && upper.kind == PredicateKind::AgeRange) {
+                predicate = std::move(lower);
+                predicate.high = upper.high;
+                return true;
+            }
+            predicate = QueryPredicate();
+            predicate.kind = PredicateKind::And;
+            predicate.children.push_back(std::move(lower));
+            predicate.children.push_back(std::move(upper));
+            return true;
+        }
+
+        if (peek().type != TokenType::Symbol) {
+            return fail("Expected a comparison operator");
+        }
+        const std::string symbol = next().text;
+        CompareOp op = CompareOp::Equal;
+        if (symbol == "=") {
+            op = CompareOp::Equal;
+        } else if (symbol == "!=" || symbol == "<>") {
+            op = CompareOp::NotEqual;
+        } else if (symbol == "<") {
+            op = CompareOp::Less;
+        } else if (symbol == "<=") {
+            op = CompareOp::LessEqual;
+        } else if (symbol == ">") {
+            op = CompareOp::Greater;
+        } else if (symbol == ">=") {
+            op = CompareOp::GreaterEqual;
+        } else {
+            return fail("Unsupported operator '" + symbol + "'");
+        }
+
+        QueryExpression right;
+        if (!parseExpression(right, height)) {
+            return false;
+        }
+        predicate = comparison(std::move(left), op, std::move(right));
+        return true;
+    }
+
+    // AGE against a literal becomes an index-friendly AgeRange, anything else a Compare
+    static QueryPredicate comparison(QueryExpression left, CompareOp op, QueryExpression right) {
+        QueryPredicate predicate;
+        if (left.kind == ExpressionKind::Age && right.kind == ExpressionKind::Number) {
+            // Literals are bounded well inside int, so value +/- 1 cannot overflow
+            const int value = static_cast<int>(right.value);
+            predicate.kind = PredicateKind::AgeRange;
+            switch (op) {
+            case CompareOp::Equal:
+                predicate.low = predicate.high = value;
+                break;
+            case CompareOp::NotEqual: {
+                QueryPredicate equal = predicate;
+                equal.low = equal.high = value;
+                predicate.kind = PredicateKind::Not;
+                predicate.children.push_back(std::move(equal));
+                break;
+            }
+            case CompareOp::Less:
+                predicate.high = value - 1;
+                break;
+            case CompareOp::LessEqual:
+                predicate.high = value;
+                break;
+            case CompareOp::Greater:
+                predicate.low = value + 1;
+                break;
+            case CompareOp::GreaterEqual:
+                predicate.low = value;
+                break;
+            }
+            return predicate;
+        }
+        predicate.kind = PredicateKind::Compare;
+        predicate.op = op;
+        predicate.operands.push_back(std::move(left));
+        predicate.operands.push_back(std::move(right));
+        return predicate;
+    }
+
+    // height counts operator levels below the root, as the evaluator does
+    bool parseExpression(QueryExpression& expression, size_t& height) {
+        if (!parseProduct(expression, height)) {
+            return false;
+        }
+        while (true) {
+            ExpressionKind kind;
+            if (acceptSymbol("+")) {
+                kind = ExpressionKind::Add;
+            } else if (acceptSymbol("-")) {
+                kind = ExpressionKind::Subtract;
+            } else {
+                return true;
+            }
+            QueryExpression right;
+            size_t rightHeight = 0;
+            if (!parseProduct(right, rightHeight) || !combine(kind, expression, height, std::move(right), rightHeight)) {
+                return false;
+            }
+        }
+    }
+
+    bool parseProduct(QueryExpression& expression, size_t& height) {
+        if (!parseUnary(expression, height)) {
+            return false;
+        }
+        while (true) {
+            ExpressionKind kind;
+            if (acceptSymbol("*")) {
+                kind = ExpressionKind::Multiply;
+            } else if (acceptSymbol("/")) {
+                kind = ExpressionKind::Divide;
+            } else {
+                return true;
+            }
+            QueryExpression right;
+            size_t rightHeight = 0;
+            if (!parseUnary(right, rightHeight) || !combine(kind, expression, height, std::move(right), rightHeight)) {
+                return false;
+            }
+        }
+    }
+
+    bool parseUnary(QueryExpression& expression, size_t& height) {
+        Nesting nesting(*this);
+        if (!nesting.ok()) {
+            return tooDeep();
+        }
+        height = 0;
+        if (acceptSymbol("-")) {
+            QueryExpression operand;
+            if (!parseUnary(operand, height)) {
+                return false;
+            }
+            if (operand.kind == ExpressionKind::Number) {
+                expression = std::move(operand);
+                expression.value = -expression.value;
+                return true;
+            }
+            expression = QueryExpression();
+            return combine(ExpressionKind::Subtract, expression, height, std::move(operand), height);
+        }
+        expression = QueryExpression();
+        if (acceptSymbol("(")) {
+            return parseExpression(expression, height) && expectSymbol(")");
+        }
+        if (acceptWord("ID")) {
+            expression.kind = ExpressionKind::Id;
+            return true;
+        }
+        if (acceptWord("AGE")) {
+            expression.kind = ExpressionKind::Age;
+            return true;
+        }
+        if (acceptWord("SQRT")) {
+            QueryExpression operand;
+            if (!expectSymbol("(") || !parseExpression(operand, height) || !expectSymbol(")")) {
+                return false;
+            }
+            if (++height > QueryParser::kMaxNesting) {
+                return tooDeep();
+            }
+            expression.kind = ExpressionKind::SquareRoot;
+            expression.operands.push_back(std::move(operand));
+            return true;
+        }
+        if (peek().type == TokenType::Number) {
+            int value = 0;
+            if (!parseNumber(value)) {
+                return false;
+            }
+            expression.value = value;
+            return true;
+        }
+        return fail(peek().type == TokenType::End ? "Unexpected end of query"
+                                                  : "Unexpected '" + peek().text + "'");
+    }
+
+    // Replaces left with (left kind right), refusing trees the evaluator would not take
+    bool combine(ExpressionKind kind, QueryExpression& left, size_t& height, QueryExpression right,
+                 size_t rightHeight) {
+        height = std::max(height, rightHeight) + 1;
+        if (height > QueryParser::kMaxNesting) {
+            return tooDeep();
+        }
+        QueryExpression expression;
+        expression.kind = kind;
+        expression.operands.push_back(std::move(left));
+        expression.operands.push_back(std::move(right));
+        left = std::move(expression);
+        return true;
+    }
+
+    bool parseNumber(int& value) {
+        if (peek().type != TokenType::Number) {
+            return fail("Expected a number");
+        }
+        const std::string& digits = next().text;
+        if (digits.size() > 9) {
+            return fail("Number out of range");
+        }
+        value = std::stoi(digits);
+        return true;
+    }
+
+    const Token& peek() const { return tokens_[position_]; }
+
+    const Token& next() {
+        const Token& token = tokens_[position_];
+        if (token.type != TokenType::End) {
+            ++position_;
+        }
+        return token;
+    }
+
+    bool acceptWord(const char* word) {
+        if (peek().type == TokenType::Word && peek().text == word) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    bool acceptSymbol(const char* symbol) {
+        if (peek().type == TokenType::Symbol && peek().text == symbol) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    bool expectWord(const char* word) {
+        return acceptWord(word) || fail(std::string("Expected ") + word);
+    }
+
+    bool expectSymbol(const char* symbol) {
+        return acceptSymbol(symbol) || fail(std::string("Expected '") + symbol + "'");
+    }
+
+    bool fail(const std::string& message) {
+        if (!too_deep_) {
+            error_ = message;
+        }
+        return false;
+    }
+
+    bool tooDeep() {
+        fail("Query nested too deeply");
+        too_deep_ = true;
+        return false;
+    }
+
+    // One level of NOT, parenthesis or unary recursion, held for its scope
+    class Nesting {
+    public:
+        explicit Nesting(Parser& parser) : parser_(parser) { ++parser_.nesting_; }
+        ~Nesting() { --parser_.nesting_; }
+        bool ok() const { return parser_.nesting_ <= QueryParser::kMaxNesting; }
+
+    private:
+        Parser& parser_;
+    };
+
+    const std::vector<Token>& tokens_;
+    std::string& error_;
+    size_t position_ = 0;
+    size_t nesting_ = 0;
+    bool too_deep_ = false;  // sticky, so backtracking neither retries nor rewrites the error
+};
+
+} // namespace
+
+bool QueryParser::parse(const std::string& query, ParsedQuery& out, std::string& error) {
+    std::vector<Token> tokens;
+    if (!tokenize(query, tokens, error)) {
+        return false;
+    }
+    out = ParsedQuery();
+    Parser parser(tokens, error);
+    return parser.parseQuery(out);
+}
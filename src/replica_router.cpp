@@ -0,0 +1,137 @@
+#include "replica_router.h"
+#include "database_interface.h"
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+std::atomic<uint64_t> nextRouterId{1};
+
+// Per-thread end of the last write, keyed by router id
+std::unordered_map<uint64_t, ReplicaRouter::Clock::time_point>& lastWrites() {
+    thread_local std::unordered_map<uint64_t, ReplicaRouter::Clock::time_point> writes;
+    return writes;
+}
+
+} // namespace
+
+ReplicaRouter::Lease::Lease(DatabaseInterface* target, std::atomic<int>* outstanding,
+                            ReplicaRouter* writer)
+    : target_(target), outstanding_(outstanding), writer_(writer) {
+}
+
+ReplicaRouter::Lease::Lease(Lease&& other) noexcept
+    : target_(other.target_), outstanding_(other.outstanding_), writer_(other.writer_) {
+    other.target_ = nullptr;
+    other.outstanding_ = nullptr;
+    other.writer_ = nullptr;
+}
+
+ReplicaRouter::Lease& ReplicaRouter::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        target_ = other.target_;
+        outstanding_ = other.outstanding_;
+        writer_ = other.writer_;
+        other.target_ = nullptr;
+        other.outstanding_ = nullptr;
+        other.writer_ = nullptr;
+    }
+    return *this;
+}
+
+ReplicaRouter::Lease::~Lease() {
+    release();
+}
+
+void ReplicaRouter::Lease::release() {
+    if (outstanding_ != nullptr) {
+        outstanding_->fetch_sub(1, std::memory_order_relaxed);
+        outstanding_ = nullptr;
+    }
+    if (writer_ != nullptr) {
+        writer_->markWrite();
+        writer_ = nullptr;
+    }
+    target_ = nullptr;
+}
+
+ReplicaRouter::ReplicaRouter(std::shared_ptr<DatabaseInterface> primary,
+                             std::vector<std::shared_ptr<DatabaseInterface>> replicas,
+                             const ReplicaOptions& options)
+    : primary_(std::move(primary)),
+      replicas_(std::move(replicas)),
+      outstanding_(new std::atomic<int>[replicas_.size()]),
+      options_(options),
+      router_id_(nextRouterId.fetch_add(1, std::memory_order_relaxed)) {
+    if (!primary_) {
+        throw std::invalid_argument("Replica router needs a primary");
+    }
+    for (size_t i = 0; i < replicas_.size(); ++i) {
+        if (!replicas_[i]) {
+            throw std::invalid_argument("Replica router replica is null");
+        }
+        outstanding_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+ReplicaRouter::Lease ReplicaRouter::routeRead(const DatabaseInterface* avoid) {
+    if (!replicas_.empty() && !callerIsSticky()) {
+        // Least outstanding requests; the scan start rotates to break ties
+        const size_t count = replicas_.size();
+        const size_t start = rotation_.fetch_add(1, std::memory_order_relaxed);
+        size_t best = count;
+        int bestLoad = 0;
+        for (size_t k = 0; k < count; ++k) {
+            size_t i = (start + k) % count;
+            int load = outstanding_[i].load(std::memory_order_relaxed);
+            if ((best == count || load < bestLoad) && replicas_[i].get() != avoid &&
+                replicas_[i]->isConnected()) {
+                best = i;
+                bestLoad = load;
+            }
+        }
+        if (best != count) {
+            outstanding_[best].fetch_add(1, std::memory_order_relaxed);
+            replica_reads_.fetch_add(1, std::memory_order_relaxed);
+            return Lease(replicas_[best].get(), &outstanding_[best], nullptr);
+        }
+    }
+    primary_reads_.fetch_add(1, std::memory_order_relaxed);
+    return Lease(primary_.get(), nullptr, nullptr);
+}
+
+ReplicaRouter::Lease ReplicaRouter::routeWrite() {
+    return Lease(primary_.get(), nullptr, this);
+}
+
+size_t ReplicaRouter::connectReplicas(const std::string& connectionString) {
+    size_t connected = 0;
+    for (const auto& replica : replicas_) {
+        if (replica->connect(connectionString)) {
+            ++connected;
+        }
+    }
+    return connected;
+}
+
+int ReplicaRouter::getOutstanding(size_t replica) const {
+    return replica < replicas_.size() ? outstanding_[replica].load(std::memory_order_relaxed) : 0;
+}
+
+bool ReplicaRouter::callerIsSticky() const {
+    auto& writes = lastWrites();
+    auto it = writes.find(router_id_);
+    if (it == writes.end()) {
+        return false;
+    }
+    if (Clock::now() - it->second < options_.stickyWindow) {
+        return true;
+    }
+    writes.erase(it);
+    return false;
+}
+
+void ReplicaRouter::markWrite() {
+    lastWrites()[router_id_] = Clock::now();
+}
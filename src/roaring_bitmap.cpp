@@ -0,0 +1,380 @@
+#include "roaring_bitmap.h"
+#include <algorithm>
+#include <iterator>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t kWords = 65536 / 64;
+
+enum class WordOp {
+    And,
+    Or,
+    AndNot,
+};
+
+template <WordOp Op>
+uint32_t combineWords(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= kWords; i += 2) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i r;
+        if (Op == WordOp::And) {
+            r = _mm_and_si128(x, y);
+        } else if (Op == WordOp::Or) {
+            r = _mm_or_si128(x, y);
+        } else {
+            r = _mm_andnot_si128(y, x);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), r);
+    }
+#endif
+    for (; i < kWords; ++i) {
+        out[i] = Op == WordOp::And ? a[i] & b[i] : Op == WordOp::Or ? a[i] | b[i] : a[i] & ~b[i];
+    }
+
+    uint32_t count = 0;
+    for (size_t w = 0; w < kWords; ++w) {
+        count += static_cast<uint32_t>(__builtin_popcountll(out[w]));
+    }
+    return count;
+}
+
+bool testBit(const std::vector<uint64_t>& words, uint16_t low) {
+    return (words[low >> 6] >> (low & 63)) & 1;
+}
+
+// Container helpers; "normalized" means dense exactly when above kArrayMax
+
+template <typename Container>
+void makeDense(Container& container) {
+    container.words.assign(kWords, 0);
+    for (uint16_t low : container.array) {
+        container.words[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    std::vector<uint16_t>().swap(container.array);
+}
+
+template <typename Container>
+void makeSparse(Container& container) {
+    container.array.clear();
+    container.array.reserve(container.cardinality);
+    for (size_t i = 0; i < kWords; ++i) {
+        uint64_t word = container.words[i];
+        while (word != 0) {
+            container.array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    std::vector<uint64_t>().swap(container.words);
+}
+
+template <typename Container>
+void normalize(Container& container) {
+    if (container.dense() && container.cardinality <= RoaringBitmap::kArrayMax) {
+        makeSparse(container);
+    } else if (!container.dense() && container.cardinality > RoaringBitmap::kArrayMax) {
+        makeDense(container);
+    }
+}
+
+template <typename Container>
+Container intersect(const Container& a, const Container& b) {
+    Container out;
+    out.key = a.key;
+    if (a.dense() && b.dense()) {
+        out.words.resize(kWords);
+        out.cardinality = combineWords<WordOp::And>(a.words.data(), b.words.data(), out.words.data());
+    } else if (a.dense() || b.dense()) {
+        const Container& sparse = a.dense() ? b : a;
+        const Container& dense = a.dense() ? a : b;
+        for (uint16_t low : sparse.array) {
+            if (testBit(dense.words, low)) {
+                out.array.push_back(low);
+            }
+        }
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+    } else {
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(out.array));
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+    }
+    normalize(out);
+    return out;
+}
+
+template <typename Container>
+Container unite(const Container& a, const Container& b) {
+    Container out;
+    out.key = a.key;
+    if (a.dense() && b.dense()) {
+        out.words.resize(kWords);
+        out.cardinality = combineWords<WordOp::Or>(a.words.data(), b.words.data(), out.words.data());
+    } else if (a.dense() || b.dense()) {
+        const Container& sparse = a.dense() ? b : a;
+        out = a.dense() ? a : b;
+        out.key = a.key;
+        for (uint16_t low : sparse.array) {
+            uint64_t& word = out.words[low >> 6];
+            const uint64_t bit = uint64_t{1} << (low & 63);
+            out.cardinality += (word & bit) == 0;
+            word |= bit;
+        }
+    } else {
+        out.array.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(out.array));
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+    }
+    normalize(out);
+    return out;
+}
+
+template <typename Container>
+Container subtract(const Container& a, const Container& b) {
+    Container out;
+    out.key = a.key;
+    if (a.dense() && b.dense()) {
+        out.words.resize(kWords);
+        out.cardinality = combineWords<WordOp::AndNot>(a.words.data(), b.words.data(), out.words.data());
+    } else if (a.dense()) {
+        out = a;
+        for (uint16_t low : b.array) {
+            uint64_t& word = out.words[low >> 6];
+            const uint64_t bit = uint64_t{1} << (low & 63);
+            out.cardinality -= (word & bit) != 0;
+            word &= ~bit;
+        }
+    } else if (b.dense()) {
+        for (uint16_t low : a.array) {
+            if (!testBit(b.words, low)) {
+                out.array.push_back(low);
+            }
+        }
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+    } else {
+        std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                            std::back_inserter(out.array));
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+    }
+    normalize(out);
+    return out;
+}
+
+template <typename Container>
+uint32_t intersectCount(const Container& a, const Container& b) {
+    uint32_t count = 0;
+    if (a.dense() && b.dense()) {
+        for (size_t i = 0; i < kWords; ++i) {
+            count += static_cast<uint32_t>(__builtin_popcountll(a.words[i] & b.words[i]));
+        }
+    } else if (a.dense() || b.dense()) {
+        const Container& sparse = a.dense() ? b : a;
+        const Container& dense = a.dense() ? a : b;
+        for (uint16_t low : sparse.array) {
+            count += testBit(dense.words, low);
+        }
+    } else {
+        auto x = a.array.begin();
+        auto y = b.array.begin();
+        while (x != a.array.end() && y != b.array.end()) {
+            if (*x < *y) {
+                ++x;
+            } else if (*y < *x) {
+                ++y;
+            } else {
+                ++count;
+                ++x;
+                ++y;
+            }
+        }
+    }
+    return count;
+}
+
+// Merges two key-sorted container lists; onBoth handles shared keys and
+// keepLeft/keepRight say whether unmatched containers survive
+template <typename Container, typename Both>
+std::vector<Container> mergeContainers(const std::vector<Container>& left, const std::vector<Container>& right,
+                                       bool keepLeft, bool keepRight, Both onBoth) {
+    std::vector<Container> out;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < left.size() || j < right.size()) {
+        if (j == right.size() || (i < left.size() && left[i].key < right[j].key)) {
+            if (keepLeft) {
+                out.push_back(left[i]);
+            }
+            ++i;
+        } else if (i == left.size() || right[j].key < left[i].key) {
+            if (keepRight) {
+                out.push_back(right[j]);
+            }
+            ++j;
+        } else {
+            Container merged = onBoth(left[i], right[j]);
+            if (merged.cardinality > 0) {
+                out.push_back(std::move(merged));
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+void RoaringBitmap::add(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& container, uint16_t k) { return container.key < k; });
+    if (it == containers_.end() || it->key != key) {
+        it = containers_.insert(it, Container());
+        it->key = key;
+    }
+
+    Container& container = *it;
+    if (container.dense()) {
+        uint64_t& word = container.words[low >> 6];
+        const uint64_t bit = uint64_t{1} << (low & 63);
+        container.cardinality += (word & bit) == 0;
+        word |= bit;
+        return;
+    }
+
+    // Ascending inserts, the common case when building from a scan, append
+    if (container.array.empty() || container.array.back() < low) {
+        container.array.push_back(low);
+    } else {
+        auto at = std::lower_bound(container.array.begin(), container.array.end(), low);
+        if (*at == low) {
+            return;
+        }
+        container.array.insert(at, low);
+    }
+    ++container.cardinality;
+    normalize(container);
+}
+
+void RoaringBitmap::remove(uint32_t value) {
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    Container* container = find(static_cast<uint16_t>(value >> 16));
+    if (container == nullptr) {
+        return;
+    }
+
+    if (container->dense()) {
+        uint64_t& word = container->words[low >> 6];
+        const uint64_t bit = uint64_t{1} << (low & 63);
+        if ((word & bit) == 0) {
+            return;
+        }
+        word &= ~bit;
+    } else {
+        auto at = std::lower_bound(container->array.begin(), container->array.end(), low);
+        if (at == container->array.end() || *at != low) {
+            return;
+        }
+        container->array.erase(at);
+    }
+
+    if (--container->cardinality == 0) {
+        containers_.erase(containers_.begin() + (container - containers_.data()));
+        return;
+    }
+    normalize(*container);
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    const Container* container = find(static_cast<uint16_t>(value >> 16));
+    if (container == nullptr) {
+        return false;
+    }
+    if (container->dense()) {
+        return testBit(container->words, low);
+    }
+    return std::binary_search(container->array.begin(), container->array.end(), low);
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const Container& container : containers_) {
+        total += container.cardinality;
+    }
+    return total;
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other) {
+    containers_ = mergeContainers(containers_, other.containers_, false, false,
+                                  [](const Container& a, const Container& b) { return intersect(a, b); });
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other) {
+    containers_ = mergeContainers(containers_, other.containers_, true, true,
+                                  [](const Container& a, const Container& b) { return unite(a, b); });
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator-=(const RoaringBitmap& other) {
+    containers_ = mergeContainers(containers_, other.containers_, true, false,
+                                  [](const Container& a, const Container& b) { return subtract(a, b); });
+    return *this;
+}
+
+uint64_t RoaringBitmap::andCardinality(const RoaringBitmap& other) const {
+    uint64_t total = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < containers_.size() && j < other.containers_.size()) {
+        if (containers_[i].key < other.containers_[j].key) {
+            ++i;
+        } else if (other.containers_[j].key < containers_[i].key) {
+            ++j;
+        } else {
+            total += intersectCount(containers_[i++], other.containers_[j++]);
+        }
+    }
+    return total;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap& other) const {
+    // Normalized containers have one representation per value set
+    if (containers_.size() != other.containers_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < containers_.size(); ++i) {
+        const Container& a = containers_[i];
+        const Container& b = other.containers_[i];
+        if (a.key != b.key || a.cardinality != b.cardinality || a.array != b.array || a.words != b.words) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint32_t> RoaringBitmap::toVector() const {
+    std::vector<uint32_t> values;
+    values.reserve(cardinality());
+    forEach([&values](uint32_t value) { values.push_back(value); });
+    return values;
+}
+
+RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) {
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& container, uint16_t k) { return container.key < k; });
+    return it != containers_.end() && it->key == key ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) const {
+    return const_cast<RoaringBitmap*>(this)->find(key);
+}
@@ -0,0 +1,30 @@
+#include "router_support.h"
+
+bool RouterSupport::projectionOf(const std::string& query, QueryProjection& projection) {
+    ParsedQuery parsed;
+    std::string error;
+    if (!QueryParser::parse(query, parsed, error)) {
+        return false;
+    }
+    projection = parsed.projection;
+    return true;
+}
+
+std::vector<UserRecord> RouterSupport::mergePages(std::vector<std::vector<UserRecord>>& pages, size_t limit) {
+    std::vector<UserRecord> page;
+    std::vector<size_t> next(pages.size(), 0);
+    while (page.size() < limit) {
+        size_t best = pages.size();
+        for (size_t i = 0; i < pages.size(); ++i) {
+            if (next[i] < pages[i].size() &&
+                (best == pages.size() || pages[i][next[i]].id < pages[best][next[best]].id)) {
+                best = i;
+            }
+        }
+        if (best == pages.size()) {
+            break;
+        }
+        page.push_back(std::move(pages[best][next[best]++]));
+    }
+    return page;
+}
@@ -0,0 +1,431 @@
+#include "sharded_database.h"
+#include "hyperloglog.h"
+#include "router_support.h"
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+namespace {
+
+// Users per listUsers page while migrating users to a new backend
+constexpr size_t kMigrationBatch = 1024;
+
+// Generated ids tried per insert; a clash needs a concurrent insertUserWithId
+constexpr int kInsertAttempts = 4;
+
+// Runs fn on every backend concurrently and returns the replies in backend order
+template <typename R, typename Fn>
+std::vector<R> fanOut(const std::vector<std::shared_ptr<DatabaseInterface>>& backends, Fn fn) {
+    std::vector<std::future<R>> pending;
+    pending.reserve(backends.size());
+    for (const auto& backend : backends) {
+        DatabaseInterface* target = backend.get();
+        pending.push_back(std::async(std::launch::async, [target, &fn]() { return fn(*target); }));
+    }
+    std::vector<R> replies;
+    replies.reserve(pending.size());
+    for (auto& reply : pending) {
+        replies.push_back(reply.get());
+    }
+    return replies;
+}
+
+} // namespace
+
+ShardedDatabase::ShardedDatabase(std::vector<std::shared_ptr<DatabaseInterface>> backends)
+    : backends_(std::move(backends)) {
+    if (backends_.empty()) {
+        throw std::invalid_argument("ShardedDatabase needs at least one backend");
+    }
+    for (const auto& backend : backends_) {
+        if (!backend) {
+            throw std::invalid_argument("ShardedDatabase backend is null");
+        }
+    }
+}
+
+int32_t ShardedDatabase::jumpHash(uint64_t key, int32_t buckets) {
+    int64_t bucket = -1;
+    int64_t jump = 0;
+    while (jump < buckets) {
+        bucket = jump;
+        key = key * 2862933555777941757ULL + 1;
+        jump = static_cast<int64_t>((bucket + 1) *
+                                    (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+    }
+    return static_cast<int32_t>(bucket);
+}
+
+bool ShardedDatabase::connect(const std::string& connectionString) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    bool connected = true;
+    for (const auto& backend : backends_) {
+        if (!backend->connect(connectionString)) {
+            captureError(*backend);
+            connected = false;
+        }
+    }
+    return connected;
+}
+
+void ShardedDatabase::disconnect() {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    for (const auto& backend : backends_) {
+        backend->disconnect();
+    }
+}
+
+bool ShardedDatabase::isConnected() const {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return std::all_of(backends_.begin(), backends_.end(),
+                       [](const std::shared_ptr<DatabaseInterface>& backend) {
+                           return backend->isConnected();
+                       });
+}
+
+bool ShardedDatabase::insertUser(const std::string& name, int age) {
+    return insertUserReturningId(name, age) > 0;
+}
+
+int ShardedDatabase::insertUserReturningId(const std::string& name, int age) {
+    int userId = -1;
+    if (!insertAllocated(name, age, userId).ok()) {
+        const std::string detail = DbStatus::detail();
+        setError(detail.empty() ? "Backend operation failed" : detail);
+        return -1;
+    }
+    return userId;
+}
+
+DbStatus ShardedDatabase::insertAllocated(const std::string& name, int age, int& userId) {
+    // A generated id can clash with one an overlapping insertUserWithId
+    // reserved and took; the floor has moved past it, so the next id is free
+    DbStatus status;
+    for (int attempt = 0; attempt < kInsertAttempts; ++attempt) {
+        userId = ids_.allocate();
+        std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+        status = route(userId).tryInsertUserWithId(userId, name, age);
+        if (status.code() != DbError::AlreadyExists) {
+            break;
+        }
+    }
+    return status;
+}
+
+bool ShardedDatabase::insertUserWithId(int userId, const std::string& name, int age) {
+    // Keep generated ids clear of explicitly chosen ones
+    ids_.reserveThrough(userId);
+    return insertRouted(userId, name, age);
+}
+
+bool ShardedDatabase::insertRouted(int userId, const std::string& name, int age) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    DatabaseInterface& backend = route(userId);
+    if (!backend.insertUserWithId(userId, name, age)) {
+        captureError(backend);
+        return false;
+    }
+    return true;
+}
+
+std::string ShardedDatabase::getUserName(int userId) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return route(userId).getUserName(userId);
+}
+
+int ShardedDatabase::getUserAge(int userId) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return route(userId).getUserAge(userId);
+}
+
+bool ShardedDatabase::updateUser(int userId, const std::string& name, int age) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    DatabaseInterface& backend = route(userId);
+    if (!backend.updateUser(userId, name, age)) {
+        captureError(backend);
+        return false;
+    }
+    return true;
+}
+
+bool ShardedDatabase::deleteUser(int userId) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    DatabaseInterface& backend = route(userId);
+    if (!backend.deleteUser(userId)) {
+        captureError(backend);
+        return false;
+    }
+    return true;
+}
+
+DbStatus ShardedDatabase::tryInsertUser(const std::string& name, int age) {
+    int userId = -1;
+    return insertAllocated(name, age, userId);
+}
+
+DbStatus ShardedDatabase::tryInsertUserWithId(int userId, const std::string& name, int age) {
+    ids_.reserveThrough(userId);
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return route(userId).tryInsertUserWithId(userId, name, age);
+}
+
+DbStatus ShardedDatabase::tryUpdateUser(int userId, const std::string& name, int age) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return route(userId).tryUpdateUser(userId, name, age);
+}
+
+DbStatus ShardedDatabase::tryDeleteUser(int userId) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return route(userId).tryDeleteUser(userId);
+}
+
+DbStatus ShardedDatabase::tryGetUser(int userId, UserRecord& out) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return route(userId).tryGetUser(userId, out);
+}
+
+std::vector<UserRecord> ShardedDatabase::getUsers(const std::vector<int>& userIds) {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    const size_t count = backends_.size();
+
+    // One batch per backend, issued concurrently, scattered back into place
+    std::vector<std::vector<int>> ids(count);
+    std::vector<std::vector<size_t>> positions(count);
+    for (size_t i = 0; i < userIds.size(); ++i) {
+        size_t backend = backendIndex(userIds[i]);
+        ids[backend].push_back(userIds[i]);
+        positions[backend].push_back(i);
+    }
+
+    std::vector<std::future<std::vector<UserRecord>>> pending(count);
+    for (size_t backend = 0; backend < count; ++backend) {
+        if (!ids[backend].empty()) {
+            DatabaseInterface* target = backends_[backend].get();
+            const std::vector<int>* batch = &ids[backend];
+            pending[backend] = std::async(std::launch::async, [target, batch]() {
+                return target->getUsers(*batch);
+            });
+        }
+    }
+
+    std::vector<UserRecord> records(userIds.size());
+    for (size_t backend = 0; backend < count; ++backend) {
+        if (ids[backend].empty()) {
+            continue;
+        }
+        std::vector<UserRecord> found = pending[backend].get();
+        for (size_t k = 0; k < found.size() && k < positions[backend].size(); ++k) {
+            records[positions[backend][k]] = std::move(found[k]);
+        }
+    }
+    return records;
+}
+
+std::vector<UserRecord> ShardedDatabase::listUsers(int afterId, size_t limit) {
+    if (limit == 0) {
+        return {};
+    }
+
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    std::vector<std::vector<UserRecord>> pages = fanOut<std::vector<UserRecord>>(
+        backends_, [afterId, limit](DatabaseInterface& backend) { return backend.listUsers(afterId, limit); });
+    return RouterSupport::mergePages(pages, limit);
+}
+
+std::vector<std::string> ShardedDatabase::getAllUserNames() {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    std::vector<std::string> names;
+    for (auto& part : fanOut<std::vector<std::string>>(backends_, [](DatabaseInterface& backend) {
+             return backend.getAllUserNames();
+         })) {
+        names.insert(names.end(), std::make_move_iterator(part.begin()),
+                     std::make_move_iterator(part.end()));
+    }
+    return names;
+}
+
+int ShardedDatabase::getUserCount() {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    int total = 0;
+    for (int count : fanOut<int>(backends_, [](DatabaseInterface& backend) {
+             return backend.getUserCount();
+         })) {
+        if (count < 0) {
+            return -1;
+        }
+        total += count;
+    }
+    return total;
+}
+
+bool ShardedDatabase::executeQuery(const std::string& query, std::vector<std::string>& results) {
+    // Distinct counts cannot be summed; they go through mergeDistinctNames
+    QueryProjection projection = QueryProjection::Star;
+    const bool parsed = RouterSupport::projectionOf(query, projection);
+    if (parsed && projection == QueryProjection::CountDistinctName) {
+        results.clear();
+        HyperLogLog sketch;
+        if (!mergeDistinctNames(query, sketch)) {
+            return false;
+        }
+        results.push_back(std::to_string(sketch.estimate()));
+        return true;
+    }
+
+    struct Reply {
+        bool ok = false;
+        std::vector<std::string> rows;
+        std::string error;
+    };
+
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    std::vector<Reply> replies = fanOut<Reply>(backends_, [&query](DatabaseInterface& backend) {
+        Reply reply;
+        reply.ok = backend.executeQuery(query, reply.rows);
+        if (!reply.ok) {
+            reply.error = backend.getLastError();
+        }
+        return reply;
+    });
+
+    results.clear();
+    for (const Reply& reply : replies) {
+        if (!reply.ok) {
+            setError(reply.error);
+            return false;
+        }
+    }
+
+    if (parsed && projection == QueryProjection::Count) {
+        long long total = 0;
+        for (const Reply& reply : replies) {
+            for (const std::string& row : reply.rows) {
+                total += std::stoll(row);
+            }
+        }
+        results.push_back(std::to_string(total));
+        return true;
+    }
+    for (Reply& reply : replies) {
+        results.insert(results.end(), std::make_move_iterator(reply.rows.begin()),
+                       std::make_move_iterator(reply.rows.end()));
+    }
+    return true;
+}
+
+bool ShardedDatabase::mergeDistinctNames(const std::string& query, HyperLogLog& sketch) {
+    struct Reply {
+        bool ok = false;
+        HyperLogLog sketch;
+        std::string error;
+    };
+
+    const int precision = sketch.precision();
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    std::vector<Reply> replies = fanOut<Reply>(backends_, [&query, precision](DatabaseInterface& backend) {
+        Reply reply{false, HyperLogLog(precision), ""};
+        reply.ok = backend.mergeDistinctNames(query, reply.sketch);
+        if (!reply.ok) {
+            reply.error = backend.getLastError();
+        }
+        return reply;
+    });
+
+    for (const Reply& reply : replies) {
+        if (!reply.ok) {
+            setError(reply.error.empty() ? "Backend cannot merge distinct-name sketches" : reply.error);
+            return false;
+        }
+    }
+    for (const Reply& reply : replies) {
+        sketch.merge(reply.sketch);
+    }
+    return true;
+}
+
+std::string ShardedDatabase::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void ShardedDatabase::clearError() {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_.clear();
+}
+
+bool ShardedDatabase::addBackend(std::shared_ptr<DatabaseInterface> backend) {
+    if (!backend || !backend->isConnected()) {
+        setError("New backend is not connected");
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(backends_mutex_);
+    const int32_t oldCount = static_cast<int32_t>(backends_.size());
+
+    // Copy first, so a failure can be undone without losing users. Each
+    // backend's own users are paged through; jump hash only ever moves keys
+    // into the new bucket
+    std::vector<std::vector<int>> copied(oldCount);
+    for (int32_t source = 0; source < oldCount; ++source) {
+        int afterId = 0;
+        while (true) {
+            std::vector<UserRecord> page = backends_[source]->listUsers(afterId, kMigrationBatch);
+            if (page.empty()) {
+                break;
+            }
+            afterId = page.back().id;
+            for (const UserRecord& record : page) {
+                if (jumpHash(static_cast<uint64_t>(static_cast<uint32_t>(record.id)), oldCount + 1) != oldCount) {
+                    continue;
+                }
+                if (!backend->insertUserWithId(record.id, record.name, record.age)) {
+                    captureError(*backend);
+                    for (const auto& ids : copied) {
+                        for (int userId : ids) {
+                            backend->deleteUser(userId);
+                        }
+                    }
+                    return false;
+                }
+                copied[source].push_back(record.id);
+            }
+        }
+    }
+
+    for (int32_t source = 0; source < oldCount; ++source) {
+        for (int userId : copied[source]) {
+            backends_[source]->deleteUser(userId);
+        }
+    }
+    backends_.push_back(std::move(backend));
+    return true;
+}
+
+size_t ShardedDatabase::getBackendCount() const {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return backends_.size();
+}
+
+size_t ShardedDatabase::backendOf(int userId) const {
+    std::shared_lock<std::shared_mutex> lock(backends_mutex_);
+    return backendIndex(userId);
+}
+
+size_t ShardedDatabase::backendIndex(int userId) const {
+    return static_cast<size_t>(jumpHash(static_cast<uint64_t>(static_cast<uint32_t>(userId)),
+                                        static_cast<int32_t>(backends_.size())));
+}
+
+DatabaseInterface& ShardedDatabase::route(int userId) const {
+    return *backends_[backendIndex(userId)];
+}
+
+void ShardedDatabase::setError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = message;
+}
+
+void ShardedDatabase::captureError(DatabaseInterface& backend) {
+    std::string message = backend.getLastError();
+    setError(message.empty() ? "Backend operation failed" : message);
+}
@@ -0,0 +1,733 @@
+#include "tiered_database.h"
+#include "hyperloglog.h"
+#include "router_support.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint8_t kMaxHeat = 255;
+
+// Numbers the instances of this process for their segment file names
+std::atomic<uint64_t> next_instance{1};
+
+// Hot ids fetched per listUsers call while ranking rows in a sweep
+constexpr size_t kSweepPage = 4096;
+
+// Segment payload, before compression (integers little-endian):
+//   u32 row count | per row: u32 id | u32 age | u32 name length | name bytes
+void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+bool readU32(const std::vector<uint8_t>& in, size_t& offset, uint32_t& value) {
+    if (in.size() - offset < 4) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[offset + i]) << (8 * i);
+    }
+    offset += 4;
+    return true;
+}
+
+std::vector<uint8_t> encodeRows(const std::vector<UserRecord>& rows) {
+    std::vector<uint8_t> out;
+    appendU32(out, static_cast<uint32_t>(rows.size()));
+    for (const UserRecord& row : rows) {
+        appendU32(out, static_cast<uint32_t>(row.id));
+        appendU32(out, static_cast<uint32_t>(row.age));
+        appendU32(out, static_cast<uint32_t>(row.name.size()));
+        out.insert(out.end(), row.name.begin(), row.name.end());
+    }
+    return out;
+}
+
+bool decodeRows(const std::vector<uint8_t>& in, std::vector<UserRecord>& rows) {
+    size_t offset = 0;
+    uint32_t count = 0;
+    if (!readU32(in, offset, count)) {
+        return false;
+    }
+    rows.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t id = 0;
+        uint32_t age = 0;
+        uint32_t length = 0;
+        if (!readU32(in, offset, id) || !readU32(in, offset, age) || !readU32(in, offset, length) ||
+            in.size() - offset < length) {
+            return false;
+        }
+        UserRecord row;
+        row.id = static_cast<int>(id);
+        row.age = static_cast<int>(age);
+        row.name.assign(reinterpret_cast<const char*>(in.data() + offset), length);
+        offset += length;
+        rows.push_back(std::move(row));
+    }
+    return true;
+}
+
+} // namespace
+
+template <typename Fn>
+bool TieredDatabase::forEachColdSegment(Fn fn) const {
+    std::vector<UserRecord> rows;
+    for (const auto& entry : segments_) {
+        if (!loadSegment(entry.first, rows)) {
+            report(DbError::Unknown);
+            return false;
+        }
+        // The file still holds the rows promoted or deleted since it was written
+        const std::vector<int>& ids = entry.second.ids;
+        rows.erase(std::remove_if(rows.begin(), rows.end(),
+                                  [&ids](const UserRecord& row) {
+                                      return !std::binary_search(ids.begin(), ids.end(), row.id);
+                                  }),
+                   rows.end());
+        if (!fn(rows)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+bool TieredDatabase::forEachColdEngine(Fn fn) const {
+    return forEachColdSegment([&fn](std::vector<UserRecord>& rows) {
+        InMemoryDatabase engine;
+        engine.connect("cold");
+        for (const UserRecord& row : rows) {
+            engine.insertUserWithId(row.id, row.name, row.age);
+        }
+        return fn(engine);
+    });
+}
+
+double TierStats::hitRatio() const {
+    const uint64_t reads = hotHits + coldHits;
+    return reads == 0 ? 1.0 : static_cast<double>(hotHits) / static_cast<double>(reads);
+}
+
+TieredDatabase::TieredDatabase(const TieringOptions& options)
+    : options_(options), codec_(BlockCodec::kDefaultBlockSize, 1) {
+    if (options_.directory.empty()) {
+        throw std::invalid_argument("TieredDatabase needs a segment directory");
+    }
+    options_.segmentRows = std::max<size_t>(options_.segmentRows, 1);
+    segment_prefix_ = (std::filesystem::path(options_.directory) /
+                       ("segment-" + std::to_string(::getpid()) + "-" +
+                        std::to_string(next_instance.fetch_add(1, std::memory_order_relaxed)) + "-"))
+                          .string();
+    if (options_.sweepInterval.count() > 0) {
+        sweeper_ = std::thread([this]() { run(); });
+    }
+}
+
+TieredDatabase::~TieredDatabase() {
+    if (sweeper_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(sweep_mutex_);
+            stopping_ = true;
+        }
+        sweep_wake_.notify_one();
+        sweeper_.join();
+    }
+
+    std::error_code ignored;
+    for (const auto& entry : segments_) {
+        std::filesystem::remove(entry.second.path, ignored);
+    }
+}
+
+bool TieredDatabase::connect(const std::string& connectionString) {
+    std::error_code error;
+    std::filesystem::create_directories(options_.directory, error);
+    if (error) {
+        setError("Cannot create segment directory: " + error.message());
+        return false;
+    }
+    if (!hot_.connect(connectionString)) {
+        captureError();
+        return false;
+    }
+    return true;
+}
+
+void TieredDatabase::disconnect() {
+    hot_.disconnect();
+}
+
+bool TieredDatabase::isConnected() const {
+    return hot_.isConnected();
+}
+
+bool TieredDatabase::insertUser(const std::string& name, int age) {
+    return report(tryInsertUser(name, age));
+}
+
+int TieredDatabase::insertUserReturningId(const std::string& name, int age) {
+    int userId = -1;
+    return report(insertHot(name, age, userId)) ? userId : -1;
+}
+
+bool TieredDatabase::insertUserWithId(int userId, const std::string& name, int age) {
+    return report(tryInsertUserWithId(userId, name, age));
+}
+
+std::string TieredDatabase::getUserName(int userId) {
+    UserRecord record;
+    return findUser(userId, record) ? record.name : "";
+}
+
+int TieredDatabase::getUserAge(int userId) {
+    UserRecord record;
+    return findUser(userId, record) ? record.age : -1;
+}
+
+bool TieredDatabase::findUser(int userId, UserRecord& out) {
+    const DbStatus status = readUser(userId, out);
+    if (status.code() == DbError::Unknown) {
+        // Only a cold tier failure is worth a getLastError entry for a read
+        report(status);
+    }
+    return status.ok();
+}
+
+bool TieredDatabase::updateUser(int userId, const std::string& name, int age) {
+    return report(tryUpdateUser(userId, name, age));
+}
+
+bool TieredDatabase::deleteUser(int userId) {
+    return report(tryDeleteUser(userId));
+}
+
+DbStatus TieredDatabase::tryInsertUser(const std::string& name, int age) {
+    int userId = -1;
+    return insertHot(name, age, userId);
+}
+
+DbStatus TieredDatabase::insertHot(const std::string& name, int age, int& userId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const DbStatus status = hot_.tryInsertUserReturningId(name, age, userId);
+    if (status.ok()) {
+        // New rows get one sweep's grace before they can be demoted
+        setHeat(userId, 1);
+    }
+    return status;
+}
+
+DbStatus TieredDatabase::tryInsertUserWithId(int userId, const std::string& name, int age) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (segmentOf(userId) != 0) {
+        return DbStatus::fail(DbError::AlreadyExists, "User already exists");
+    }
+    const DbStatus status = hot_.tryInsertUserWithId(userId, name, age);
+    if (status.ok()) {
+        setHeat(userId, 1);
+    }
+    return status;
+}
+
+DbStatus TieredDatabase::tryGetUser(int userId, UserRecord& out) {
+    return readUser(userId, out);
+}
+
+DbStatus TieredDatabase::readUser(int userId, UserRecord& out) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const DbStatus status = hot_.tryGetUser(userId, out);
+        if (status.ok()) {
+            touch(userId);
+            hot_hits_.fetch_add(1, std::memory_order_relaxed);
+            return status;
+        }
+        if (status.code() != DbError::NotFound || segmentOf(userId) == 0) {
+            return status;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const DbStatus status = promote(userId, out);
+    if (status.ok()) {
+        cold_hits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return status;
+}
+
+DbStatus TieredDatabase::tryUpdateUser(int userId, const std::string& name, int age) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    UserRecord promoted;
+    if (segmentOf(userId) != 0) {
+        const DbStatus status = promote(userId, promoted);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    const DbStatus status = hot_.tryUpdateUser(userId, name, age);
+    if (status.ok()) {
+        touch(userId);
+    }
+    return status;
+}
+
+DbStatus TieredDatabase::tryDeleteUser(int userId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const uint32_t segment = segmentOf(userId);
+    if (segment == 0) {
+        const DbStatus status = hot_.tryDeleteUser(userId);
+        if (status.ok()) {
+            heat_.erase(userId);
+        }
+        return status;
+    }
+    if (!hot_.isConnected()) {
+        return DbStatus::fail(DbError::NotConnected, "Not connected");
+    }
+    // A cold delete only unmaps the row; its bytes go when the segment empties
+    dropColdRow(segment, userId);
+    return DbError::None;
+}
+
+std::vector<UserRecord> TieredDatabase::listUsers(int afterId, size_t limit) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<UserRecord> hot = hot_.listUsers(afterId, limit);
+    if (!hot_.isConnected() || limit == 0) {
+        return hot;
+    }
+
+    // Each segment offers its first `limit` ids past afterId; the page's are among them
+    std::vector<int> coldIds;
+    for (const auto& entry : segments_) {
+        const std::vector<int>& ids = entry.second.ids;
+        auto first = std::upper_bound(ids.begin(), ids.end(), afterId);
+        coldIds.insert(coldIds.end(), first, first + std::min<ptrdiff_t>(limit, ids.end() - first));
+    }
+    std::sort(coldIds.begin(), coldIds.end());
+    if (coldIds.size() > limit) {
+        coldIds.resize(limit);
+    }
+    std::vector<UserRecord> cold;
+    if (!coldRecords(coldIds, cold)) {
+        report(DbError::Unknown);
+        return {};
+    }
+
+    std::vector<std::vector<UserRecord>> pages;
+    pages.push_back(std::move(hot));
+    pages.push_back(std::move(cold));
+    return RouterSupport::mergePages(pages, limit);
+}
+
+std::vector<std::string> TieredDatabase::getAllUserNames() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<std::string> names = hot_.getAllUserNames();
+    if (!hot_.isConnected()) {
+        return names;
+    }
+
+    const bool scanned = forEachColdSegment([&names](std::vector<UserRecord>& rows) {
+        for (UserRecord& row : rows) {
+            names.push_back(std::move(row.name));
+        }
+        return true;
+    });
+    return scanned ? names : std::vector<std::string>();
+}
+
+int TieredDatabase::getUserCount() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const int hot = hot_.getUserCount();
+    return hot < 0 ? hot : hot + static_cast<int>(cold_rows_);
+}
+
+bool TieredDatabase::executeQuery(const std::string& query, std::vector<std::string>& results) {
+    // Distinct counts cannot be summed; they go through mergeDistinctNames
+    ParsedQuery parsedQuery;
+    std::string parseError;
+    const bool parsed = QueryParser::parse(query, parsedQuery, parseError);
+    const QueryProjection projection = parsedQuery.projection;
+    if (parsed && projection == QueryProjection::CountDistinctName) {
+        results.clear();
+        HyperLogLog sketch;
+        if (!mergeDistinctNames(query, sketch)) {
+            return false;
+        }
+        results.push_back(std::to_string(sketch.estimate()));
+        return true;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (parsed && projection == QueryProjection::Count && !parsedQuery.hasWhere) {
+        // Every cold row is in the id map; no segment needs reading
+        const int hot = hot_.getUserCount();
+        if (hot < 0) {
+            captureError();
+            return false;
+        }
+        results.assign(1, std::to_string(static_cast<size_t>(hot) + cold_rows_));
+        return true;
+    }
+    if (!hot_.executeQuery(query, results)) {
+        captureError();
+        return false;
+    }
+
+    // Counts add up; row results are hot rows followed by cold ones, segment by segment
+    const bool counting = parsed && projection == QueryProjection::Count;
+    long long count = counting ? std::stoll(results[0]) : 0;
+    const bool scanned = forEachColdEngine([&](InMemoryDatabase& segment) {
+        std::vector<std::string> part;
+        if (!segment.executeQuery(query, part)) {
+            setError(segment.getLastError());
+            return false;
+        }
+        if (counting) {
+            count += std::stoll(part[0]);
+        } else {
+            results.insert(results.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        }
+        return true;
+    });
+    if (!scanned) {
+        results.clear();
+        return false;
+    }
+    if (counting) {
+        results[0] = std::to_string(count);
+    }
+    return true;
+}
+
+bool TieredDatabase::mergeDistinctNames(const std::string& query, HyperLogLog& sketch) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!hot_.mergeDistinctNames(query, sketch)) {
+        captureError();
+        return false;
+    }
+    return forEachColdEngine([this, &query, &sketch](InMemoryDatabase& segment) {
+        if (!segment.mergeDistinctNames(query, sketch)) {
+            setError(segment.getLastError());
+            return false;
+        }
+        return true;
+    });
+}
+
+std::string TieredDatabase::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void TieredDatabase::clearError() {
+    hot_.clearError();
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_.clear();
+}
+
+int TieredDatabase::sweep() {
+    std::lock_guard<std::mutex> sweeping(sweep_run_mutex_);
+    std::vector<int> demoting;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (!hot_.isConnected()) {
+            setError("Not connected");
+            return -1;
+        }
+        rank(demoting);
+    }
+
+    // Compression and file writes hold no lock, so reads and writes go on
+    std::vector<PendingSegment> written;
+    if (!writeSegments(demoting, written)) {
+        return -1;
+    }
+
+    size_t moved = 0;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        moved = install(written);
+    }
+    // Demotions leave tombstones in the hot columns; the engine drops them once they dominate
+    hot_.compact();
+    demotions_.fetch_add(moved, std::memory_order_relaxed);
+    return static_cast<int>(moved);
+}
+
+void TieredDatabase::rank(std::vector<int>& demoting) {
+    // Rank every hot row, halving counts as they are read
+    std::vector<std::pair<uint8_t, int>> warm;
+    int afterId = 0;
+    while (true) {
+        std::vector<UserRecord> page = hot_.listUsers(afterId, kSweepPage);
+        if (page.empty()) {
+            break;
+        }
+        for (const UserRecord& record : page) {
+            auto entry = heat_.find(record.id);
+            const uint8_t heat = entry == heat_.end() ? 0 : entry->second.load(std::memory_order_relaxed);
+            if (heat == 0) {
+                demoting.push_back(record.id);
+                continue;
+            }
+            warm.emplace_back(heat, record.id);
+            entry->second.store(static_cast<uint8_t>(heat / 2), std::memory_order_relaxed);
+        }
+        afterId = page.back().id;
+    }
+
+    // Over capacity: the least-read survivors follow, ties going to lower ids
+    if (options_.maxHotRows > 0 && warm.size() > options_.maxHotRows) {
+        const size_t excess = warm.size() - options_.maxHotRows;
+        std::nth_element(warm.begin(), warm.begin() + excess, warm.end());
+        for (size_t i = 0; i < excess; ++i) {
+            demoting.push_back(warm[i].second);
+        }
+    }
+}
+
+TierStats TieredDatabase::getStats() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    TierStats stats;
+    stats.hotRows = static_cast<size_t>(std::max(0, hot_.getUserCount()));
+    stats.coldRows = cold_rows_;
+    stats.coldSegments = segments_.size();
+    for (const auto& entry : segments_) {
+        stats.coldBytes += entry.second.bytes;
+    }
+    stats.hotHits = hot_hits_.load(std::memory_order_relaxed);
+    stats.coldHits = cold_hits_.load(std::memory_order_relaxed);
+    stats.promotions = promotions_.load(std::memory_order_relaxed);
+    stats.demotions = demotions_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void TieredDatabase::touch(int userId) {
+    auto entry = heat_.find(userId);
+    if (entry == heat_.end()) {
+        return;
+    }
+    const uint8_t heat = entry->second.load(std::memory_order_relaxed);
+    if (heat < kMaxHeat) {
+        entry->second.store(static_cast<uint8_t>(heat + 1), std::memory_order_relaxed);
+    }
+}
+
+void TieredDatabase::setHeat(int userId, uint8_t heat) {
+    heat_[userId].store(heat, std::memory_order_relaxed);
+}
+
+DbStatus TieredDatabase::promote(int userId, UserRecord& out) {
+    const uint32_t segment = segmentOf(userId);
+    if (segment == 0) {
+        // Another thread promoted it between our locks
+        return hot_.tryGetUser(userId, out);
+    }
+
+    if (cached_segment_ != segment) {
+        cached_segment_ = 0;
+        if (!loadSegment(segment, cached_rows_)) {
+            return DbError::Unknown;
+        }
+        cached_segment_ = segment;
+    }
+    auto found = std::lower_bound(cached_rows_.begin(), cached_rows_.end(), userId,
+                                  [](const UserRecord& record, int id) { return record.id < id; });
+    if (found == cached_rows_.end() || found->id != userId) {
+        return DbStatus::fail(DbError::Unknown, "Cold segment is missing a user");
+    }
+
+    out = *found;
+    const DbStatus status = hot_.tryInsertUserWithId(userId, out.name, out.age);
+    if (!status.ok()) {
+        return status;
+    }
+    setHeat(userId, 1);
+    dropColdRow(segment, userId);
+    promotions_.fetch_add(1, std::memory_order_relaxed);
+    return status;
+}
+
+bool TieredDatabase::writeSegments(std::vector<int>& userIds, std::vector<PendingSegment>& written) {
+    // Segments are written in id order so promotion can binary search them
+    std::sort(userIds.begin(), userIds.end());
+    for (size_t start = 0; start < userIds.size(); start += options_.segmentRows) {
+        const size_t end = std::min(userIds.size(), start + options_.segmentRows);
+        PendingSegment pending;
+        pending.rows = hot_.getUsers(std::vector<int>(userIds.begin() + start, userIds.begin() + end));
+        pending.rows.erase(std::remove_if(pending.rows.begin(), pending.rows.end(),
+                                          [](const UserRecord& row) { return row.name.empty(); }),
+                           pending.rows.end());
+        if (pending.rows.empty()) {
+            continue;
+        }
+
+        pending.number = next_segment_++;
+        pending.segment.path = segment_prefix_ + std::to_string(pending.number) + ".lzb";
+        const std::vector<uint8_t> framed = codec_.compress(encodeRows(pending.rows));
+        std::ofstream file(pending.segment.path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(framed.data()), static_cast<std::streamsize>(framed.size()));
+        file.close();
+        if (!file) {
+            std::error_code ignored;
+            std::filesystem::remove(pending.segment.path, ignored);
+            for (const PendingSegment& done : written) {
+                std::filesystem::remove(done.segment.path, ignored);
+            }
+            setError("Cannot write cold segment " + pending.segment.path);
+            return false;
+        }
+        pending.segment.bytes = framed.size();
+        written.push_back(std::move(pending));
+    }
+    return true;
+}
+
+size_t TieredDatabase::install(std::vector<PendingSegment>& written) {
+    // The files are durable before any row leaves memory. A row updated or
+    // deleted since it was copied stays where it is
+    size_t moved = 0;
+    for (PendingSegment& pending : written) {
+        std::vector<int> ids;
+        ids.reserve(pending.rows.size());
+        for (const UserRecord& row : pending.rows) {
+            ids.push_back(row.id);
+        }
+        const std::vector<UserRecord> current = hot_.getUsers(ids);
+        for (size_t i = 0; i < pending.rows.size(); ++i) {
+            const UserRecord& row = pending.rows[i];
+            if (current[i].name != row.name || current[i].age != row.age) {
+                continue;
+            }
+            hot_.deleteUser(row.id);
+            heat_.erase(row.id);
+            pending.segment.ids.push_back(row.id);
+        }
+
+        if (pending.segment.ids.empty()) {
+            std::error_code ignored;
+            std::filesystem::remove(pending.segment.path, ignored);
+            continue;
+        }
+        pending.segment.ids.shrink_to_fit();
+        moved += pending.segment.ids.size();
+        cold_rows_ += pending.segment.ids.size();
+        segments_[pending.number] = std::move(pending.segment);
+    }
+    return moved;
+}
+
+uint32_t TieredDatabase::segmentOf(int userId) const {
+    // Segments cover id ranges, so most are ruled out by their first and last ids
+    for (const auto& entry : segments_) {
+        const std::vector<int>& ids = entry.second.ids;
+        if (userId >= ids.front() && userId <= ids.back() && std::binary_search(ids.begin(), ids.end(), userId)) {
+            return entry.first;
+        }
+    }
+    return 0;
+}
+
+void TieredDatabase::dropColdRow(uint32_t number, int userId) {
+    auto segment = segments_.find(number);
+    std::vector<int>& ids = segment->second.ids;
+    ids.erase(std::lower_bound(ids.begin(), ids.end(), userId));
+    --cold_rows_;
+    if (!ids.empty()) {
+        return;
+    }
+    std::error_code ignored;
+    std::filesystem::remove(segment->second.path, ignored);
+    if (cached_segment_ == segment->first) {
+        cached_segment_ = 0;
+        cached_rows_.clear();
+    }
+    segments_.erase(segment);
+}
+
+bool TieredDatabase::loadSegment(uint32_t segment, std::vector<UserRecord>& rows) const {
+    auto entry = segments_.find(segment);
+    if (entry == segments_.end()) {
+        DbStatus::fail(DbError::Unknown, "Unknown cold segment");
+        return false;
+    }
+
+    std::ifstream file(entry->second.path, std::ios::binary);
+    std::vector<uint8_t> framed((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    try {
+        if (file.bad() || !decodeRows(codec_.decompress(framed), rows)) {
+            throw std::runtime_error("bad payload");
+        }
+    } catch (const std::runtime_error&) {
+        DbStatus::fail(DbError::Unknown, "Cold segment unreadable: ", entry->second.path);
+        return false;
+    }
+    return true;
+}
+
+bool TieredDatabase::coldRecords(const std::vector<int>& userIds, std::vector<UserRecord>& out) const {
+    // One decode per segment, however many of the ids it holds
+    std::map<uint32_t, std::vector<int>> bySegment;
+    for (int userId : userIds) {
+        bySegment[segmentOf(userId)].push_back(userId);
+    }
+
+    out.clear();
+    out.reserve(userIds.size());
+    std::vector<UserRecord> rows;
+    for (const auto& entry : bySegment) {
+        if (!loadSegment(entry.first, rows)) {
+            return false;
+        }
+        for (int userId : entry.second) {
+            auto found = std::lower_bound(rows.begin(), rows.end(), userId,
+                                          [](const UserRecord& record, int id) { return record.id < id; });
+            if (found != rows.end() && found->id == userId) {
+                out.push_back(std::move(*found));
+            }
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const UserRecord& a, const UserRecord& b) { return a.id < b.id; });
+    return true;
+}
+
+void TieredDatabase::run() {
+    std::unique_lock<std::mutex> lock(sweep_mutex_);
+    while (true) {
+        sweep_wake_.wait_until(lock, std::chrono::steady_clock::now() + options_.sweepInterval,
+                               [this]() { return stopping_; });
+        if (stopping_) {
+            return;
+        }
+
+        lock.unlock();
+        if (isConnected()) {
+            sweep();
+        }
+        lock.lock();
+    }
+}
+
+void TieredDatabase::setError(const std::string& message) const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = message;
+}
+
+void TieredDatabase::captureError() const {
+    setError(hot_.getLastError());
+}
+
+bool TieredDatabase::report(DbStatus status) const {
+    if (!status.ok()) {
+        setError(DbStatus::detail());
+    }
+    return status.ok();
+}
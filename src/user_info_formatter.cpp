@@ -0,0 +1,91 @@
+#include "user_info_formatter.h"
+#include <cstring>
+
+namespace {
+
+constexpr char kNamePrefix[] = "Name: ";
+constexpr char kAgePrefix[] = ", Age: ";
+constexpr size_t kNamePrefixLength = sizeof(kNamePrefix) - 1;
+constexpr size_t kAgePrefixLength = sizeof(kAgePrefix) - 1;
+
+// "00" "01" ... "99": one table lookup emits two digits
+constexpr char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+uint32_t magnitude(int value) {
+    return value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+}
+
+} // namespace
+
+size_t UserInfoFormatter::digitCount(uint32_t value) {
+    size_t digits = 1;
+    while (value >= 100) {
+        value /= 100;
+        digits += 2;
+    }
+    return digits + (value >= 10 ? 1 : 0);
+}
+
+char* UserInfoFormatter::writeInt(char* dest, int value) {
+    if (value < 0) {
+        *dest++ = '-';
+    }
+    uint32_t remaining = magnitude(value);
+    char* end = dest + digitCount(remaining);
+
+    // Fill from the right, two digits per step
+    char* cursor = end;
+    while (remaining >= 100) {
+        const uint32_t pair = (remaining % 100) * 2;
+        remaining /= 100;
+        *--cursor = kDigitPairs[pair + 1];
+        *--cursor = kDigitPairs[pair];
+    }
+    if (remaining >= 10) {
+        *--cursor = kDigitPairs[remaining * 2 + 1];
+        *--cursor = kDigitPairs[remaining * 2];
+    } else {
+        *--cursor = static_cast<char>('0' + remaining);
+    }
+    return end;
+}
+
+size_t UserInfoFormatter::formattedLength(size_t nameLength, int age) {
+    return kNamePrefixLength + nameLength + kAgePrefixLength + (age < 0 ? 1 : 0) +
+           digitCount(magnitude(age));
+}
+
+char* UserInfoFormatter::format(char* dest, const char* name, size_t nameLength, int age) {
+    std::memcpy(dest, kNamePrefix, kNamePrefixLength);
+    dest += kNamePrefixLength;
+    std::memcpy(dest, name, nameLength);
+    dest += nameLength;
+    std::memcpy(dest, kAgePrefix, kAgePrefixLength);
+    dest += kAgePrefixLength;
+    return writeInt(dest, age);
+}
+
+void UserInfoFormatter::formatInto(std::string& out, const std::string& name, int age) {
+    out.resize(formattedLength(name.size(), age));
+    format(&out[0], name.data(), name.size(), age);
+}
+
+void UserInfoFormatter::append(std::string& out, const std::string& name, int age, char separator) {
+    const size_t start = out.size();
+    const size_t length = formattedLength(name.size(), age);
+    out.resize(start + length + (separator != '\0' ? 1 : 0));
+    char* end = format(&out[start], name.data(), name.size(), age);
+    if (separator != '\0') {
+        *end = separator;
+    }
+}
@@ -0,0 +1,130 @@
+#include "write_behind.h"
+
+namespace {
+
+// How often an idle flusher rechecks for shutdown
+constexpr std::chrono::milliseconds kIdlePoll{100};
+
+} // namespace
+
+WriteBehindQueue::WriteBehindQueue(Sink sink, const WriteBehindOptions& options)
+    : sink_(std::move(sink)), options_(options) {
+    if (options_.maxBatch == 0) {
+        options_.maxBatch = 1;
+    }
+    flusher_ = std::thread([this]() { run(); });
+}
+
+WriteBehindQueue::~WriteBehindQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    flusher_.join();
+}
+
+void WriteBehindQueue::enqueue(UserMutation mutation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++enqueued_;
+
+    if (mutation.type != MutationType::Insert) {
+        auto it = pending_by_user_.find(mutation.userId);
+        if (it != pending_by_user_.end() && pending_[it->second].type == MutationType::Update) {
+            // A later update or a delete makes the pending update redundant
+            pending_[it->second] = std::move(mutation);
+            ++coalesced_;
+            return;
+        }
+        pending_by_user_[mutation.userId] = pending_.size();
+    }
+
+    if (pending_.empty()) {
+        oldest_ = std::chrono::steady_clock::now();
+    }
+    pending_.push_back(std::move(mutation));
+    if (pending_.size() == 1 || pending_.size() >= options_.maxBatch) {
+        lock.unlock();
+        wake_.notify_one();
+    }
+}
+
+bool WriteBehindQueue::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitApplied(lock);
+    bool succeeded = !failed_;
+    failed_ = false;
+    return succeeded;
+}
+
+void WriteBehindQueue::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitApplied(lock);
+}
+
+void WriteBehindQueue::waitApplied(std::unique_lock<std::mutex>& lock) {
+    const uint64_t target = enqueued_;
+    ++flush_waiters_;
+    wake_.notify_one();
+    while (applied_through_ < target) {
+        applied_.wait_for(lock, options_.maxDelay);
+    }
+    --flush_waiters_;
+}
+
+uint64_t WriteBehindQueue::getEnqueued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return enqueued_;
+}
+
+uint64_t WriteBehindQueue::getCoalesced() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return coalesced_;
+}
+
+uint64_t WriteBehindQueue::getBatches() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_;
+}
+
+size_t WriteBehindQueue::getPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+void WriteBehindQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        while (pending_.empty() && !stopping_) {
+            wake_.wait_for(lock, kIdlePoll);
+        }
+        if (pending_.empty()) {
+            applied_through_ = enqueued_;
+            applied_.notify_all();
+            return;
+        }
+
+        wake_.wait_until(lock, oldest_ + options_.maxDelay, [this]() {
+            return stopping_ || flush_waiters_ > 0 || pending_.size() >= options_.maxBatch;
+        });
+
+        std::vector<UserMutation> batch;
+        batch.swap(pending_);
+        pending_by_user_.clear();
+        const uint64_t through = enqueued_;
+        lock.unlock();
+
+        bool succeeded = false;
+        try {
+            succeeded = sink_(batch);
+        } catch (...) {
+            succeeded = false;
+        }
+
+        lock.lock();
+        ++batches_;
+        failed_ = failed_ || !succeeded;
+        applied_through_ = through;
+        applied_.notify_all();
+    }
+}
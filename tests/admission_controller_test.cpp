@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "admission_controller.h"
+#include "in_memory_database.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Admission Controller Test Suite
+ * Checks concurrency limits, bounded queues, priority ordering and AIMD
+ */
+
+using namespace std::chrono_literals;
+
+class AdmissionControllerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        AdmissionOptions options;
+        options.initialLimit = 1.0;
+        options.maxQueueDepth = 1;
+        options.queueTimeout = 20ms;
+        controller = std::make_shared<AdmissionController>(options);
+    }
+
+    static void waitForQueued(AdmissionController& controller, RequestPriority priority) {
+        while (controller.getQueued(priority) == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::shared_ptr<AdmissionController> controller;
+};
+
+// ============================================================================
+// LIMITS AND QUEUES
+// ============================================================================
+
+/**
+ * Calls beyond the limit wait and time out; releasing a ticket frees the slot
+ */
+TEST_F(AdmissionControllerTest, ConcurrencyLimit) {
+    AdmissionController::Ticket first = controller->admit(RequestPriority::Normal);
+    ASSERT_TRUE(first.admitted());
+    EXPECT_EQ(1u, controller->getInFlight(RequestPriority::Normal));
+
+    AdmissionController::Ticket second = controller->admit(RequestPriority::Normal);
+    EXPECT_FALSE(second.admitted());
+    EXPECT_EQ(1u, controller->getRejected(RequestPriority::Normal));
+
+    first.release();
+    EXPECT_TRUE(controller->admit(RequestPriority::Normal).admitted());
+}
+
+/**
+ * A full queue rejects immediately instead of waiting for the deadline
+ */
+TEST_F(AdmissionControllerTest, BoundedQueue) {
+    AdmissionController::Ticket holder = controller->admit(RequestPriority::Normal);
+    std::thread waiter([this]() {
+        controller->admit(RequestPriority::Normal, AdmissionController::Clock::now() + 500ms);
+    });
+    waitForQueued(*controller, RequestPriority::Normal);
+
+    auto start = AdmissionController::Clock::now();
+    EXPECT_FALSE(controller->admit(RequestPriority::Normal,
+                                   AdmissionController::Clock::now() + 500ms).admitted());
+    EXPECT_LT(AdmissionController::Clock::now() - start, 100ms);
+
+    holder.release();
+    waiter.join();
+}
+
+/**
+ * Bulk calls are held back while critical calls are queued
+ */
+TEST_F(AdmissionControllerTest, PriorityOrdering) {
+    AdmissionController::Ticket critical = controller->admit(RequestPriority::Critical);
+    std::thread waiter([this]() {
+        controller->admit(RequestPriority::Critical, AdmissionController::Clock::now() + 500ms);
+    });
+    waitForQueued(*controller, RequestPriority::Critical);
+
+    EXPECT_FALSE(controller->admit(RequestPriority::Bulk).admitted());
+
+    critical.release();
+    waiter.join();
+    EXPECT_TRUE(controller->admit(RequestPriority::Bulk).admitted());
+}
+
+// ============================================================================
+// ADAPTIVE LIMITS
+// ============================================================================
+
+/**
+ * Fast calls grow the limit additively, slow calls shrink it multiplicatively
+ */
+TEST_F(AdmissionControllerTest, AimdAdjustment) {
+    AdmissionOptions options;
+    options.initialLimit = 4.0;
+    options.targetLatency = 50ms;
+    controller->configure(RequestPriority::Normal, options);
+
+    // Growth needs the limit to be in use, so hold several tickets at once
+    for (int round = 0; round < 10; ++round) {
+        std::vector<AdmissionController::Ticket> tickets;
+        for (int i = 0; i < 3; ++i) {
+            tickets.push_back(controller->admit(RequestPriority::Normal));
+        }
+    }
+    double grown = controller->getLimit(RequestPriority::Normal);
+    EXPECT_GT(grown, 4.0);
+
+    {
+        AdmissionController::Ticket slow = controller->admit(RequestPriority::Normal);
+        std::this_thread::sleep_for(60ms);
+    }
+    EXPECT_DOUBLE_EQ(grown * options.backoffRatio, controller->getLimit(RequestPriority::Normal));
+}
+
+/**
+ * The starting limit is clamped to the configured bounds, as configure() does
+ */
+TEST(AdmissionLimitTest, InitialLimitClamped) {
+    AdmissionOptions options;
+    options.initialLimit = 0.0;
+    options.minLimit = 2.0;
+    options.maxLimit = 4.0;
+    EXPECT_DOUBLE_EQ(2.0, AdmissionController(options).getLimit(RequestPriority::Normal));
+
+    options.initialLimit = 100.0;
+    AdmissionController controller(options);
+    EXPECT_DOUBLE_EQ(4.0, controller.getLimit(RequestPriority::Bulk));
+    controller.configure(RequestPriority::Bulk, options);
+    EXPECT_DOUBLE_EQ(4.0, controller.getLimit(RequestPriority::Bulk));
+}
+
+/**
+ * DatabaseService fails rejected calls the same way as disconnected ones
+ */
+TEST_F(AdmissionControllerTest, ServiceRejection) {
+    auto db = std::make_shared<InMemoryDatabase>();
+    DatabaseService service(db);
+    service.setAdmissionController(controller);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+    ASSERT_TRUE(service.createUser("Alice", 25));
+
+    AdmissionController::Ticket bulk = controller->admit(RequestPriority::Bulk);
+    EXPECT_TRUE(service.getAllUserNames().empty());
+    EXPECT_EQ("Name: Alice, Age: 25", service.getUserInfo(1));
+
+    bulk.release();
+    EXPECT_EQ(1u, service.getAllUserNames().size());
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "age_index.h"
+#include "in_memory_database.h"
+
+/**
+ * Age Index Test Suite
+ * Covers the bitmap age index and combined WHERE predicates in the engine,
+ * with and without secondary indexes attached
+ */
+
+// ============================================================================
+// INDEX
+// ============================================================================
+
+/**
+ * Range lookups follow inserts, age changes and deletes
+ */
+TEST(AgeIndexTest, RangeLookups) {
+    AgeIndex index;
+    index.onInsert(1, "Alice", 25);
+    index.onInsert(2, "Bob", 30);
+    index.onInsert(3, "Carol", 35);
+    index.onInsert(4, "Dave", 30);
+
+    EXPECT_EQ(std::vector<uint32_t>({2, 4}), index.findRange(30, 30).toVector());
+    EXPECT_EQ(std::vector<uint32_t>({1, 2, 4}), index.findRange(0, 32).toVector());
+    EXPECT_EQ(3u, index.countRange(26, 100));
+
+    index.onUpdate(2, "Bob", 30, "Bobby", 30);
+    index.onUpdate(4, "Dave", 30, "Dave", 40);
+    index.onDelete(1, "Alice", 25);
+    EXPECT_EQ(std::vector<uint32_t>({2}), index.findRange(30, 30).toVector());
+    EXPECT_EQ(std::vector<uint32_t>({3, 4}), index.findRange(31, 100).toVector());
+    EXPECT_EQ(3u, index.size());
+}
+
+// ============================================================================
+// ENGINE QUERIES
+// ============================================================================
+
+/**
+ * AND/OR/NOT over name and age predicates answer the same with or without indexes
+ */
+TEST(AgeIndexTest, CombinedPredicates) {
+    for (int indexes = 0; indexes < 4; ++indexes) {
+        InMemoryDatabase db;
+        ASSERT_TRUE(db.connect("memory"));
+        if (indexes & 1) {
+            db.enableNameIndex();
+        }
+        db.insertUser("Alice", 25);
+        db.insertUser("Alina", 30);
+        db.insertUser("Bob", 35);
+        db.insertUser("Albert", 40);
+        db.insertUser("Carol", 45);
+        if (indexes & 2) {
+            db.enableAgeIndex();
+        }
+        db.updateUser(5, "Carol", 28);
+        db.deleteUser(3);
+
+        std::vector<std::string> results;
+        ASSERT_TRUE(db.executeQuery("SELECT NAME FROM USERS WHERE NAME LIKE 'Al%' AND AGE >= 30", results));
+        EXPECT_EQ(std::vector<std::string>({"Alina", "Albert"}), results) << indexes;
+
+        ASSERT_TRUE(db.executeQuery("SELECT NAME FROM USERS WHERE AGE < 26 OR NAME LIKE 'C%'", results));
+        EXPECT_EQ(std::vector<std::string>({"Alice", "Carol"}), results) << indexes;
+
+        ASSERT_TRUE(db.executeQuery("SELECT * FROM USERS WHERE NOT NAME LIKE 'Al%'", results));
+        EXPECT_EQ(std::vector<std::string>({"5,Carol,28"}), results) << indexes;
+
+        ASSERT_TRUE(db.executeQuery(
+            "SELECT COUNT(*) FROM USERS WHERE (AGE BETWEEN 20 AND 35 OR AGE = 40) AND NOT AGE <> 30", results));
+        EXPECT_EQ(std::vector<std::string>({"1"}), results) << indexes;
+
+        ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE AGE > 100", results));
+        EXPECT_EQ(std::vector<std::string>({"0"}), results) << indexes;
+
+        ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS", results));
+        EXPECT_EQ(std::vector<std::string>({"4"}), results) << indexes;
+    }
+}
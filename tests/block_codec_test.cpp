@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "block_codec.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Block Codec Test Suite
+ * Round-trips representative payloads through the framed codec and checks
+ * that corrupt input is rejected instead of producing garbage
+ */
+
+class BlockCodecTest : public ::testing::Test {
+protected:
+    static std::vector<uint8_t> makeText(size_t size) {
+        const std::string row = "id=42,name=Alice,age=25;";
+        std::vector<uint8_t> data;
+        data.reserve(size);
+        while (data.size() < size) {
+            data.push_back(static_cast<uint8_t>(row[data.size() % row.size()]));
+        }
+        return data;
+    }
+
+    static std::vector<uint8_t> makeRandom(size_t size) {
+        std::mt19937 rng(12345);
+        std::vector<uint8_t> data(size);
+        for (auto& b : data) {
+            b = static_cast<uint8_t>(rng());
+        }
+        return data;
+    }
+};
+
+// ============================================================================
+// ROUND TRIP
+// ============================================================================
+
+/**
+ * Repetitive data compresses well and comes back byte-for-byte
+ */
+TEST_F(BlockCodecTest, RoundTripCompressible) {
+    BlockCodec codec(4096, 4);
+    std::vector<uint8_t> input = makeText(100000);
+
+    std::vector<uint8_t> framed = codec.compress(input);
+    EXPECT_LT(framed.size(), input.size() / 4);
+    EXPECT_EQ(input, codec.decompress(framed));
+}
+
+/**
+ * Incompressible blocks are stored raw, bounding the expansion to headers
+ */
+TEST_F(BlockCodecTest, RoundTripIncompressible) {
+    BlockCodec codec(4096, 2);
+    std::vector<uint8_t> input = makeRandom(10000);
+
+    std::vector<uint8_t> framed = codec.compress(input);
+    EXPECT_LE(framed.size(), input.size() + 64);
+    EXPECT_EQ(input, codec.decompress(framed));
+}
+
+/**
+ * Empty input and tiny trailing blocks are handled
+ */
+TEST_F(BlockCodecTest, EdgeSizes) {
+    BlockCodec codec(16, 1);
+    for (size_t size : {0u, 1u, 3u, 16u, 17u, 100u}) {
+        std::vector<uint8_t> input = makeText(size);
+        EXPECT_EQ(input, codec.decompress(codec.compress(input))) << "size " << size;
+    }
+}
+
+/**
+ * Single-block primitives handle overlapping back-references (runs)
+ */
+TEST_F(BlockCodecTest, SingleBlockRun) {
+    std::vector<uint8_t> input(1000, 'x');
+    std::vector<uint8_t> block = BlockCodec::compressBlock(input.data(), input.size());
+    EXPECT_LT(block.size(), 32u);
+    EXPECT_EQ(input, BlockCodec::decompressBlock(block.data(), block.size(), input.size()));
+}
+
+// ============================================================================
+// CORRUPTION
+// ============================================================================
+
+/**
+ * Damaged frames are rejected with an exception
+ */
+TEST_F(BlockCodecTest, RejectsCorruptInput) {
+    BlockCodec codec(1024, 1);
+    std::vector<uint8_t> framed = codec.compress(makeText(5000));
+
+    std::vector<uint8_t> truncated(framed.begin(), framed.end() - 10);
+    EXPECT_THROW(codec.decompress(truncated), std::runtime_error);
+
+    std::vector<uint8_t> badMagic = framed;
+    badMagic[0] = 'X';
+    EXPECT_THROW(codec.decompress(badMagic), std::runtime_error);
+
+    // Header counts are checked against the input before anything is sized by them
+    std::vector<uint8_t> hugeCount = framed;
+    std::fill(hugeCount.begin() + 8, hugeCount.begin() + 12, 0xFF);
+    EXPECT_THROW(codec.decompress(hugeCount), std::runtime_error);
+
+    std::vector<uint8_t> hugeBlock = framed;
+    std::fill(hugeBlock.begin() + 20, hugeBlock.begin() + 24, 0xFF);
+    EXPECT_THROW(codec.decompress(hugeBlock), std::runtime_error);
+
+    // Block and raw lengths are bounded by what the stored bytes can decode to
+    auto emptyBlocks = [](uint32_t blockSize, uint32_t raw) {
+        std::vector<uint8_t> frame = {'L', 'Z', 'B', '1'};
+        const uint64_t rawSize = 1000 * static_cast<uint64_t>(raw);
+        for (int i = 0; i < 4; ++i) {
+            frame.push_back(static_cast<uint8_t>(blockSize >> (8 * i)));
+        }
+        frame.insert(frame.end(), {0xE8, 0x03, 0, 0});
+        for (int i = 0; i < 8; ++i) {
+            frame.push_back(static_cast<uint8_t>(rawSize >> (8 * i)));
+        }
+        for (int block = 0; block < 1000; ++block) {
+            for (int i = 0; i < 4; ++i) {
+                frame.push_back(static_cast<uint8_t>(raw >> (8 * i)));
+            }
+            frame.insert(frame.end(), {0, 0, 0, 0});
+        }
+        return frame;
+    };
+    EXPECT_THROW(codec.decompress(emptyBlocks(0xFFFFFFFFu, 0xFFFFFFFFu)), std::runtime_error);
+    EXPECT_THROW(codec.decompress(emptyBlocks(2048, 2048)), std::runtime_error);
+    EXPECT_THROW(codec.decompress(emptyBlocks(1024, 1024)), std::runtime_error);
+    EXPECT_TRUE(codec.decompress(emptyBlocks(1024, 0)).empty());
+
+    // A raw block whose stored length disagrees with its raw length
+    std::vector<uint8_t> rawMismatch = codec.compress(makeRandom(100));
+    rawMismatch[20] = 99;  // first block's raw length
+    EXPECT_THROW(codec.decompress(rawMismatch), std::runtime_error);
+
+    std::vector<uint8_t> block = BlockCodec::compressBlock(framed.data(), 0);
+    EXPECT_THROW(BlockCodec::decompressBlock(block.data(), block.size(), 10), std::runtime_error);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include "change_stream.h"
+#include "in_memory_database.h"
+#include "partitioned_database.h"
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+
+/**
+ * Change Stream Test Suite
+ * Verifies ordering, independent subscribers, overrun detection and the
+ * engine hooks that publish every mutation
+ */
+
+// ============================================================================
+// RING BUFFER
+// ============================================================================
+
+/**
+ * Each subscriber reads every record in sequence order at its own pace
+ */
+TEST(ChangeStreamTest, IndependentSubscribers) {
+    ChangeStream stream(8);
+    ChangeStream::Subscriber early = stream.subscribe();
+
+    stream.publish(ChangeType::Insert, 1, "Alice", 25);
+    ChangeStream::Subscriber late = stream.subscribe();
+    stream.publish(ChangeType::Update, 1, "Alice", 26);
+
+    ChangeRecord record;
+    ASSERT_EQ(ChangeStream::PollResult::Record, early.poll(record));
+    EXPECT_EQ(0u, record.sequence);
+    EXPECT_EQ(ChangeType::Insert, record.type);
+    ASSERT_EQ(ChangeStream::PollResult::Record, early.poll(record));
+    EXPECT_EQ(26, record.age);
+    EXPECT_EQ(ChangeStream::PollResult::Empty, early.poll(record));
+
+    ASSERT_EQ(ChangeStream::PollResult::Record, late.poll(record));
+    EXPECT_EQ(1u, record.sequence);
+    EXPECT_EQ(ChangeStream::PollResult::Empty, late.poll(record));
+}
+
+/**
+ * A subscriber lapped by publishers is told so and resumes at the oldest record
+ */
+TEST(ChangeStreamTest, OverrunDetection) {
+    ChangeStream stream(4);
+    ChangeStream::Subscriber subscriber = stream.subscribe();
+    for (int i = 0; i < 10; ++i) {
+        stream.publish(ChangeType::Insert, i, "user", i);
+    }
+
+    ChangeRecord record;
+    EXPECT_EQ(ChangeStream::PollResult::Overrun, subscriber.poll(record));
+    EXPECT_EQ(6u, subscriber.getDropped());
+    ASSERT_EQ(ChangeStream::PollResult::Record, subscriber.poll(record));
+    EXPECT_EQ(6u, record.sequence);
+}
+
+/**
+ * Concurrent publishers never hand out a sequence twice
+ */
+TEST(ChangeStreamTest, ConcurrentPublishers) {
+    ChangeStream stream(1 << 14);
+    ChangeStream::Subscriber subscriber = stream.subscribe();
+
+    std::vector<std::thread> publishers;
+    for (int p = 0; p < 4; ++p) {
+        publishers.emplace_back([&stream, p]() {
+            for (int i = 0; i < 1000; ++i) {
+                stream.publish(ChangeType::Insert, p * 1000 + i, "user", i);
+            }
+        });
+    }
+    for (auto& t : publishers) {
+        t.join();
+    }
+
+    std::set<int> seen;
+    ChangeRecord record;
+    while (subscriber.poll(record) == ChangeStream::PollResult::Record) {
+        seen.insert(record.userId);
+    }
+    EXPECT_EQ(4000u, seen.size());
+    EXPECT_EQ(0u, subscriber.getDropped());
+}
+
+/**
+ * Publishers lapping a small ring never hand a subscriber a torn record
+ */
+TEST(ChangeStreamTest, LappedSlotsStayConsistent) {
+    ChangeStream stream(4);
+    ChangeStream::Subscriber subscriber = stream.subscribe();
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> publishers;
+    for (int p = 0; p < 4; ++p) {
+        publishers.emplace_back([&stream, p]() {
+            for (int i = 0; i < 5000; ++i) {
+                const int id = p * 5000 + i;
+                // Names of varying length make slots grow their buffers mid-run
+                stream.publish(ChangeType::Update, id, std::string(1 + id % 40, static_cast<char>('a' + id % 26)), id);
+            }
+        });
+    }
+    std::thread closer([&publishers, &done]() {
+        for (auto& t : publishers) {
+            t.join();
+        }
+        done = true;
+    });
+
+    ChangeRecord record;
+    uint64_t last = 0;
+    uint64_t delivered = 0;
+    while (true) {
+        const bool finished = done;
+        const ChangeStream::PollResult result = subscriber.poll(record);
+        if (result == ChangeStream::PollResult::Empty && finished) {
+            break;
+        }
+        if (result != ChangeStream::PollResult::Record) {
+            continue;
+        }
+        EXPECT_TRUE(delivered == 0 || record.sequence > last);
+        EXPECT_EQ(record.userId, record.age);
+        EXPECT_EQ(std::string(1 + record.userId % 40, static_cast<char>('a' + record.userId % 26)), record.name);
+        last = record.sequence;
+        ++delivered;
+    }
+    closer.join();
+    EXPECT_EQ(20000u, stream.getNextSequence());
+    EXPECT_EQ(20000u, subscriber.getPosition());
+    EXPECT_EQ(20000u, delivered + subscriber.getDropped());
+}
+
+// ============================================================================
+// ENGINE INTEGRATION
+// ============================================================================
+
+/**
+ * The in-memory engine publishes inserts, updates and deletes with row values
+ */
+TEST(ChangeStreamTest, EnginePublishesMutations) {
+    auto stream = std::make_shared<ChangeStream>();
+    InMemoryDatabase db;
+    db.connect("memory");
+    db.setChangeStream(stream);
+    ChangeStream::Subscriber subscriber = stream->subscribe();
+
+    db.insertUser("Alice", 25);
+    db.updateUser(1, "Alicia", 26);
+    db.insertUser("", 1);  // rejected, not published
+    db.deleteUser(1);
+
+    ChangeRecord record;
+    ASSERT_EQ(ChangeStream::PollResult::Record, subscriber.poll(record));
+    EXPECT_EQ(ChangeType::Insert, record.type);
+    EXPECT_EQ(1, record.userId);
+    EXPECT_EQ("Alice", record.name);
+    ASSERT_EQ(ChangeStream::PollResult::Record, subscriber.poll(record));
+    EXPECT_EQ(ChangeType::Update, record.type);
+    EXPECT_EQ("Alicia", record.name);
+    ASSERT_EQ(ChangeStream::PollResult::Record, subscriber.poll(record));
+    EXPECT_EQ(ChangeType::Delete, record.type);
+    EXPECT_EQ(26, record.age);
+    EXPECT_EQ(ChangeStream::PollResult::Empty, subscriber.poll(record));
+}
+
+/**
+ * Every partition of the partitioned engine feeds the same stream
+ */
+TEST(ChangeStreamTest, PartitionsShareStream) {
+    auto stream = std::make_shared<ChangeStream>();
+    PartitionedDatabase db(2);
+    db.connect("partitions");
+    db.setChangeStream(stream);
+    ChangeStream::Subscriber subscriber = stream->subscribe();
+
+    db.insertUser("Alice", 25);
+    db.insertUser("Bob", 30);
+
+    std::set<int> ids;
+    ChangeRecord record;
+    while (subscriber.poll(record) == ChangeStream::PollResult::Record) {
+        ids.insert(record.userId);
+    }
+    EXPECT_EQ((std::set<int>{1, 2}), ids);
+}
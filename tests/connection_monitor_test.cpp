@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "connection_monitor.h"
+#include "in_memory_database.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+/**
+ * Connection Monitor Test Suite
+ * Covers background probing, reconnect backoff and the cached state used
+ * by DatabaseService
+ */
+
+namespace {
+
+// Engine whose connect() fails a set number of times and whose probes are counted
+class FlakyDatabase : public InMemoryDatabase {
+public:
+    bool connect(const std::string& connectionString) override {
+        if (failures_left > 0) {
+            --failures_left;
+            return false;
+        }
+        return InMemoryDatabase::connect(connectionString);
+    }
+
+    bool isConnected() const override {
+        ++probes;
+        return InMemoryDatabase::isConnected();
+    }
+
+    std::atomic<int> failures_left{0};
+    mutable std::atomic<int> probes{0};
+};
+
+template <typename Predicate>
+bool eventually(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// MONITOR
+// ============================================================================
+
+/**
+ * A dropped link is noticed by the periodic probe and reconnected after
+ * failed attempts with growing delays
+ */
+TEST(ConnectionMonitorTest, ReconnectsWithBackoff) {
+    auto db = std::make_shared<FlakyDatabase>();
+    ASSERT_TRUE(db->connect("memory"));
+
+    HealthCheckOptions options;
+    options.interval = 2ms;
+    options.minBackoff = 1ms;
+    options.maxBackoff = 4ms;
+    ConnectionMonitor monitor(db, "memory", options);
+    EXPECT_TRUE(monitor.isConnected());
+
+    db->failures_left = 5;
+    db->disconnect();
+    ASSERT_TRUE(eventually([&monitor]() { return monitor.getReconnects() == 1; }));
+    EXPECT_TRUE(monitor.isConnected());
+    EXPECT_TRUE(db->InMemoryDatabase::isConnected());
+    EXPECT_EQ(6u, monitor.getReconnectAttempts());
+    EXPECT_GE(monitor.getProbes(), 6u);
+}
+
+/**
+ * reportFailure probes at once instead of waiting for the next interval
+ */
+TEST(ConnectionMonitorTest, FailureReportProbesImmediately) {
+    auto db = std::make_shared<FlakyDatabase>();
+    ASSERT_TRUE(db->connect("memory"));
+
+    HealthCheckOptions options;
+    options.interval = std::chrono::hours(1);
+    ConnectionMonitor monitor(db, "memory", options);
+
+    db->disconnect();
+    EXPECT_TRUE(monitor.isConnected());
+    monitor.reportFailure();
+    ASSERT_TRUE(eventually([&monitor]() { return monitor.getReconnects() == 1; }));
+    EXPECT_EQ(1u, monitor.getProbes());
+}
+
+// ============================================================================
+// SERVICE INTEGRATION
+// ============================================================================
+
+/**
+ * With health checks on, service calls read the cached state; a failed
+ * write triggers the reconnect
+ */
+TEST(ConnectionMonitorTest, ServiceUsesCachedState) {
+    auto db = std::make_shared<FlakyDatabase>();
+    DatabaseService service(db);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+
+    HealthCheckOptions options;
+    options.interval = std::chrono::hours(1);
+    service.enableHealthCheck(options);
+    const int probesBefore = db->probes;
+
+    ASSERT_TRUE(service.createUser("Alice", 25));
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ("Name: Alice, Age: 25", service.getUserInfo(1));
+    }
+    EXPECT_EQ(1, service.getTotalUsers());
+
+    // Writes refused for their content do not look like a lost link
+    EXPECT_FALSE(service.createUser("", 30));
+    EXPECT_FALSE(service.removeUser(42));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(probesBefore, db->probes);
+
+    db->disconnect();
+    EXPECT_FALSE(service.createUser("Bob", 30));
+    ASSERT_TRUE(eventually([&service]() { return service.createUser("Bob", 30); }));
+    EXPECT_EQ(2, service.getTotalUsers());
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "db_status.h"
+#include "in_memory_database.h"
+#include "partitioned_database.h"
+#include "sharded_database.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/**
+ * Typed Status Test Suite
+ * Checks the error codes of the typed engine calls, the thread-local
+ * detail text and its agreement with getLastError(), directly and
+ * through the routers
+ */
+
+// ============================================================================
+// ENGINE CODES
+// ============================================================================
+
+/**
+ * Every failure class maps to its code, with the legacy text as detail
+ */
+TEST(DbStatusTest, EngineCodes) {
+    InMemoryDatabase db(1, 2);
+    EXPECT_EQ(DbError::NotConnected, db.tryInsertUser("Alice", 25).code());
+    EXPECT_EQ("Not connected", DbStatus::detail());
+    ASSERT_TRUE(db.connect("memory"));
+
+    EXPECT_TRUE(db.tryInsertUser("Alice", 25).ok());
+    EXPECT_EQ(DbError::InvalidArgument, db.tryInsertUser("", 25).code());
+    EXPECT_EQ("Invalid user data", DbStatus::detail());
+    EXPECT_EQ(DbError::OutOfRange, db.tryInsertUserWithId(4, "Bob", 30).code());
+    EXPECT_EQ(DbError::AlreadyExists, db.tryInsertUserWithId(1, "Bob", 30).code());
+    EXPECT_TRUE(db.tryInsertUserWithId(5, "Bob", 30).ok());
+    EXPECT_EQ(DbError::NotFound, db.tryUpdateUser(3, "Carol", 40).code());
+    EXPECT_TRUE(db.tryUpdateUser(5, "Bobby", 31).ok());
+    EXPECT_TRUE(db.tryDeleteUser(1).ok());
+    EXPECT_EQ(DbError::NotFound, db.tryDeleteUser(1).code());
+
+    UserRecord record;
+    ASSERT_TRUE(db.tryGetUser(5, record).ok());
+    EXPECT_EQ("Bobby", record.name);
+    EXPECT_EQ(31, record.age);
+    EXPECT_EQ(DbError::NotFound, db.tryGetUser(1, record).code());
+    EXPECT_EQ(1, record.id);
+    EXPECT_TRUE(record.name.empty());
+
+    std::vector<std::string> results;
+    EXPECT_FALSE(db.executeQuery("DROP TABLE USERS", results));
+    EXPECT_EQ("Unsupported query: DROP TABLE USERS", DbStatus::detail());
+    EXPECT_EQ(DbStatus::detail(), db.getLastError());
+    EXPECT_EQ(DbError::Unsupported, DbStatus::classify(db.getLastError()));
+}
+
+/**
+ * Detail text is per thread; only untyped calls publish it to getLastError()
+ */
+TEST(DbStatusTest, DetailIsThreadLocal) {
+    InMemoryDatabase db;
+    ASSERT_TRUE(db.connect("memory"));
+    EXPECT_EQ(DbError::NotFound, db.tryDeleteUser(9).code());
+    EXPECT_EQ("", db.getLastError());
+
+    std::string otherDetail;
+    std::thread other([&db, &otherDetail]() {
+        db.insertUser("", -1);
+        otherDetail = DbStatus::detail();
+    });
+    other.join();
+
+    EXPECT_EQ("Invalid user data", otherDetail);
+    EXPECT_EQ("User not found", DbStatus::detail());
+    EXPECT_EQ("Invalid user data", db.getLastError());
+    EXPECT_EQ(DbError::NotFound, db.tryUpdateUser(9, "Alice", 25).code());
+    EXPECT_EQ("Invalid user data", db.getLastError());
+    db.clearError();
+    EXPECT_EQ("", db.getLastError());
+}
+
+// ============================================================================
+// ROUTERS
+// ============================================================================
+
+/**
+ * Routers forward typed calls, so concurrent failures keep their own codes
+ */
+TEST(DbStatusTest, RoutersKeepCodesPerThread) {
+    PartitionedDatabase partitioned(2);
+    ShardedDatabase sharded({std::make_shared<InMemoryDatabase>(), std::make_shared<InMemoryDatabase>()});
+    for (DatabaseInterface* db : std::vector<DatabaseInterface*>{&partitioned, &sharded}) {
+        ASSERT_TRUE(db->connect("memory"));
+        ASSERT_TRUE(db->tryInsertUserWithId(7, "Alice", 25).ok());
+        EXPECT_EQ(DbError::AlreadyExists, db->tryInsertUserWithId(7, "Bob", 30).code());
+        EXPECT_EQ("User already exists", DbStatus::detail());
+
+        UserRecord record;
+        ASSERT_TRUE(db->tryGetUser(7, record).ok());
+        EXPECT_EQ("Alice", record.name);
+
+        // Each thread sees its own failure class on every call
+        std::atomic<int> crossed{0};
+        std::thread other([db, &crossed]() {
+            for (int i = 0; i < 500; ++i) {
+                if (db->tryInsertUser("", -1).code() != DbError::InvalidArgument ||
+                    DbStatus::detail() != "Invalid user data") {
+                    ++crossed;
+                }
+            }
+        });
+        for (int i = 0; i < 500; ++i) {
+            if (db->tryUpdateUser(9, "Carol", 40).code() != DbError::NotFound || DbStatus::detail() != "User not found") {
+                ++crossed;
+            }
+        }
+        other.join();
+        EXPECT_EQ(0, crossed.load());
+        EXPECT_EQ("", db->getLastError());
+    }
+}
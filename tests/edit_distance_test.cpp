@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "edit_distance.h"
+#include "name_index.h"
+#include <random>
+
+/**
+ * Edit Distance Test Suite
+ * Checks the bit-parallel and banded kernels against the full-matrix
+ * reference, and fuzzy name lookups against brute force
+ */
+
+namespace {
+
+std::string randomString(std::mt19937& rng, size_t maxLength, const char* alphabet, size_t letters) {
+    std::string text(rng() % (maxLength + 1), 'a');
+    for (char& c : text) {
+        c = alphabet[rng() % letters];
+    }
+    return text;
+}
+
+} // namespace
+
+// ============================================================================
+// KERNELS
+// ============================================================================
+
+/**
+ * Known distances, including empty strings and the 64-byte boundary
+ */
+TEST(EditDistanceTest, KnownDistances) {
+    EXPECT_EQ(3, EditDistanceMatcher("kitten").distance("sitting"));
+    EXPECT_EQ(0, EditDistanceMatcher("Alice").distance("Alice"));
+    EXPECT_EQ(5, EditDistanceMatcher("").distance("Alice"));
+    EXPECT_EQ(5, EditDistanceMatcher("Alice").distance(""));
+    EXPECT_EQ(2, EditDistanceMatcher("flaw").distance("lawn"));
+
+    std::string full(64, 'x');
+    std::string changed = full;
+    changed[0] = 'y';
+    changed[63] = 'y';
+    EXPECT_EQ(2, EditDistanceMatcher(full).distance(changed));
+
+    std::string longer(100, 'x');
+    EXPECT_EQ(36, EditDistanceMatcher(longer).distance(full));
+}
+
+/**
+ * Bounded calls report exact distances within the bound and bound + 1 beyond
+ */
+TEST(EditDistanceTest, MatchesReference) {
+    std::mt19937 rng(11);
+    const char alphabet[] = "abcd";
+    for (int round = 0; round < 3000; ++round) {
+        const size_t maxLength = round % 3 == 0 ? 120 : 20;
+        std::string pattern = randomString(rng, maxLength, alphabet, 4);
+        std::string text = randomString(rng, maxLength, alphabet, 4);
+        const int expected = EditDistanceMatcher::reference(pattern, text);
+        const EditDistanceMatcher matcher(pattern);
+
+        EXPECT_EQ(expected, matcher.distance(text)) << pattern << " / " << text;
+        for (int bound : {0, 1, 3, 10}) {
+            EXPECT_EQ(std::min(expected, bound + 1), matcher.distance(text, bound))
+                << pattern << " / " << text << " k=" << bound;
+        }
+    }
+}
+
+// ============================================================================
+// FUZZY LOOKUP
+// ============================================================================
+
+/**
+ * Nearest names first, and the trigram filter never drops a true match
+ */
+TEST(EditDistanceTest, FindSimilar) {
+    NameIndex index;
+    index.onInsert(1, "Jonathan", 20);
+    index.onInsert(2, "Johnathan", 21);
+    index.onInsert(3, "Jonathon", 22);
+    index.onInsert(4, "Nathan", 23);
+    index.onInsert(5, "Jon", 24);
+
+    std::vector<NameMatch> matches = index.findSimilar("Jonathan", 1);
+    ASSERT_EQ(3u, matches.size());
+    EXPECT_EQ(1, matches[0].userId);
+    EXPECT_EQ(0, matches[0].distance);
+    EXPECT_EQ(2, matches[1].userId);
+    EXPECT_EQ(3, matches[2].userId);
+    EXPECT_EQ(1, matches[2].distance);
+    EXPECT_TRUE(index.findSimilar("Jonathan", -1).empty());
+
+    std::mt19937 rng(5);
+    const char alphabet[] = "abc";
+    NameIndex random;
+    std::vector<std::string> names;
+    for (int userId = 0; userId < 400; ++userId) {
+        names.push_back(randomString(rng, 12, alphabet, 3));
+        random.onInsert(userId, names.back(), 0);
+    }
+    for (int round = 0; round < 50; ++round) {
+        std::string query = randomString(rng, 12, alphabet, 3);
+        for (int bound : {0, 1, 2}) {
+            std::vector<int> expected;
+            for (int userId = 0; userId < 400; ++userId) {
+                if (EditDistanceMatcher::reference(query, names[userId]) <= bound) {
+                    expected.push_back(userId);
+                }
+            }
+            std::vector<int> found;
+            for (const NameMatch& match : random.findSimilar(query, bound)) {
+                found.push_back(match.userId);
+            }
+            std::sort(found.begin(), found.end());
+            EXPECT_EQ(expected, found) << query << " k=" << bound;
+        }
+    }
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include "calculator.h"
+#include "expression_evaluator.h"
+#include "in_memory_database.h"
+#include "partitioned_database.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * ExpressionEvaluator Test Suite
+ * Checks the column forms of the Calculator operations, batch evaluation
+ * of parsed expressions, and arithmetic in engine queries
+ */
+
+namespace {
+
+QueryExpression parseColumn(const std::string& text) {
+    ParsedQuery query;
+    std::string error;
+    EXPECT_TRUE(QueryParser::parse("SELECT " + text + ", NAME FROM USERS", query, error)) << error;
+    return query.columns.empty() ? QueryExpression() : query.columns[0].expression;
+}
+
+} // namespace
+
+// ============================================================================
+// COLUMN OPERATIONS
+// ============================================================================
+
+/**
+ * Column forms agree with the scalar operations, also when out aliases an input
+ */
+TEST(CalculatorColumnTest, MatchesScalarForms) {
+    Calculator calc;
+    std::vector<double> a = {1, -2, 3.5, 40, 7};
+    std::vector<double> b = {4, 5, -0.5, 8, 2};
+    std::vector<double> out(a.size());
+
+    calc.add(a.data(), b.data(), out.data(), a.size());
+    EXPECT_EQ(std::vector<double>({5, 3, 3, 48, 9}), out);
+    calc.subtract(a.data(), b.data(), out.data(), a.size());
+    EXPECT_EQ(std::vector<double>({-3, -7, 4, 32, 5}), out);
+    calc.multiply(a.data(), b.data(), out.data(), a.size());
+    EXPECT_EQ(std::vector<double>({4, -10, -1.75, 320, 14}), out);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_DOUBLE_EQ(calc.divide(a[i], b[i]), a[i] / b[i]);
+    }
+    calc.divide(a.data(), b.data(), a.data(), a.size());
+    EXPECT_EQ(std::vector<double>({0.25, -0.4, -7, 5, 3.5}), a);
+
+    b[3] = 0;
+    std::fill(out.begin(), out.end(), 1.0);
+    EXPECT_THROW(calc.divide(a.data(), b.data(), out.data(), a.size()), std::invalid_argument);
+    EXPECT_EQ(std::vector<double>(out.size(), 1.0), out);
+
+    std::vector<double> squares = {0, 1, 6.25, 81};
+    calc.squareRoot(squares.data(), squares.data(), squares.size());
+    EXPECT_EQ(std::vector<double>({0, 1, 2.5, 9}), squares);
+    squares[2] = -1;
+    EXPECT_THROW(calc.squareRoot(squares.data(), out.data(), squares.size()), std::invalid_argument);
+}
+
+// ============================================================================
+// EVALUATOR
+// ============================================================================
+
+/**
+ * Nested expressions evaluate row by row over the batch columns
+ */
+TEST(ExpressionEvaluatorTest, EvaluatesBatches) {
+    std::vector<double> ids = {1, 2, 3, 4};
+    std::vector<double> ages = {20, 30, 40, 50};
+    ExpressionEvaluator::Batch batch;
+    batch.ids = ids.data();
+    batch.ages = ages.data();
+    batch.rows = ids.size();
+
+    ExpressionEvaluator evaluator;
+    std::vector<double> out;
+    evaluator.evaluate(parseColumn("(AGE - ID * 2) / -2 + 100"), batch, out);
+    EXPECT_EQ(std::vector<double>({91, 87, 83, 79}), out);
+    evaluator.evaluate(parseColumn("-AGE"), batch, out);
+    EXPECT_EQ(std::vector<double>({-20, -30, -40, -50}), out);
+    EXPECT_THROW(evaluator.evaluate(parseColumn("AGE / (ID - 3)"), batch, out), std::invalid_argument);
+    evaluator.evaluate(parseColumn("SQRT(AGE * AGE) + ID"), batch, out);
+    EXPECT_EQ(std::vector<double>({21, 32, 43, 54}), out);
+    EXPECT_THROW(evaluator.evaluate(parseColumn("SQRT(ID - 2)"), batch, out), std::invalid_argument);
+
+    ParsedQuery query;
+    std::string error;
+    ASSERT_TRUE(QueryParser::parse("SELECT * FROM USERS WHERE AGE / 20 >= ID - 1", query, error));
+    std::vector<uint8_t> selected;
+    evaluator.compare(query.where, batch, selected);
+    EXPECT_EQ(std::vector<uint8_t>({1, 1, 1, 0}), selected);
+}
+
+/**
+ * Trees built outside the parser are held to the same height limit
+ */
+TEST(ExpressionEvaluatorTest, RejectsDeepTrees) {
+    std::vector<double> ages = {4, 9};
+    ExpressionEvaluator::Batch batch;
+    batch.ids = ages.data();
+    batch.ages = ages.data();
+    batch.rows = ages.size();
+
+    QueryExpression expression;
+    expression.kind = ExpressionKind::Age;
+    for (size_t i = 0; i < QueryParser::kMaxNesting; ++i) {
+        QueryExpression parent;
+        parent.kind = ExpressionKind::Add;
+        parent.operands.push_back(std::move(expression));
+        parent.operands.emplace_back();
+        expression = std::move(parent);
+    }
+    ExpressionEvaluator evaluator;
+    std::vector<double> out;
+    evaluator.evaluate(expression, batch, out);
+    EXPECT_EQ(std::vector<double>({4, 9}), out);
+
+    QueryExpression root;
+    root.kind = ExpressionKind::SquareRoot;
+    root.operands.push_back(std::move(expression));
+    EXPECT_THROW(evaluator.evaluate(root, batch, out), std::invalid_argument);
+}
+
+/**
+ * Integral values print without a fraction, others with the fewest digits that read back
+ */
+TEST(ExpressionEvaluatorTest, Formatting) {
+    std::string text;
+    ExpressionEvaluator::formatInto(text, 42);
+    text.push_back(' ');
+    ExpressionEvaluator::formatInto(text, -7);
+    text.push_back(' ');
+    ExpressionEvaluator::formatInto(text, 12.5);
+    text.push_back(' ');
+    ExpressionEvaluator::formatInto(text, 1.0 / 3);
+    text.push_back(' ');
+    ExpressionEvaluator::formatInto(text, 0.1 + 0.2);
+    EXPECT_EQ("42 -7 12.5 0.3333333333333333 0.30000000000000004", text);
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+class ExpressionQueryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(db.connect("memory"));
+        // More rows than one batch, so batches are stitched together
+        for (int i = 1; i <= 3000; ++i) {
+            ASSERT_TRUE(db.insertUser("User" + std::to_string(i), i % 100));
+        }
+        ASSERT_TRUE(db.deleteUser(2));
+    }
+
+    InMemoryDatabase db;
+};
+
+/**
+ * Column lists project names and computed values in row order
+ */
+TEST_F(ExpressionQueryTest, ProjectsExpressions) {
+    std::vector<std::string> results;
+    ASSERT_TRUE(db.executeQuery("SELECT ID, NAME, AGE * 2 + 1, AGE / 4 FROM USERS", results));
+    ASSERT_EQ(2999u, results.size());
+    EXPECT_EQ("1,User1,3,0.25", results[0]);
+    EXPECT_EQ("3,User3,7,0.75", results[1]);
+    EXPECT_EQ("3000,User3000,1,0", results.back());
+
+    ASSERT_TRUE(db.executeQuery("SELECT NAME FROM USERS WHERE ID = 3", results));
+    EXPECT_EQ(std::vector<std::string>({"User3"}), results);
+}
+
+/**
+ * Computed comparisons filter, count and combine with other conditions
+ */
+TEST_F(ExpressionQueryTest, FiltersOnExpressions) {
+    std::vector<std::string> results;
+    // AGE equals ID exactly for ids 1..99, minus the deleted id 2
+    ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE AGE - ID = 0", results));
+    EXPECT_EQ(std::vector<std::string>({"98"}), results);
+
+    ASSERT_TRUE(db.executeQuery("SELECT ID FROM USERS WHERE ID * 2 > 5990 AND NOT AGE = 99", results));
+    EXPECT_EQ(std::vector<std::string>({"2996", "2997", "2998", "3000"}), results);
+
+    db.enableAgeIndex();
+    ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE ID BETWEEN 100 AND 199 AND AGE < 10", results));
+    EXPECT_EQ(std::vector<std::string>({"10"}), results);
+}
+
+/**
+ * Division by zero fails the query instead of producing rows
+ */
+TEST_F(ExpressionQueryTest, DivisionByZeroFails) {
+    std::vector<std::string> results;
+    EXPECT_FALSE(db.executeQuery("SELECT ID / AGE FROM USERS", results));
+    EXPECT_TRUE(results.empty());
+    EXPECT_EQ("Query failed: Division by zero", db.getLastError());
+    EXPECT_EQ(DbError::InvalidArgument, DbStatus::classify(db.getLastError()));
+
+    ASSERT_TRUE(db.executeQuery("SELECT ID / AGE FROM USERS WHERE AGE > 0 AND ID < 4", results));
+    EXPECT_EQ(std::vector<std::string>({"1", "1"}), results);
+
+    // A comparison only sees rows the other conditions kept, in any order
+    ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE 100 / (AGE - 25) > 1 AND AGE <> 25", results));
+    EXPECT_EQ(std::vector<std::string>({"2220"}), results);
+    ASSERT_TRUE(db.executeQuery("SELECT NAME FROM USERS WHERE AGE <> 25 AND 100 / (AGE - 25) > 1 AND ID < 100",
+                                results));
+    EXPECT_EQ(74u, results.size());
+    ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE ID < 100 AND NOT 100 / (AGE - 25) > 1 "
+                                "AND NOT AGE = 25", results));
+    EXPECT_EQ(std::vector<std::string>({"23"}), results);
+    EXPECT_FALSE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE 100 / (AGE - 25) > 1", results));
+
+    EXPECT_FALSE(db.executeQuery("SELECT SQRT(AGE - 50) FROM USERS", results));
+    EXPECT_EQ("Query failed: Square root is not defined for negative numbers", db.getLastError());
+    ASSERT_TRUE(db.executeQuery("SELECT SQRT(AGE - 50) FROM USERS WHERE AGE >= 50 AND ID < 54", results));
+    EXPECT_EQ(std::vector<std::string>({"0", "1", "1.4142135623730951", "1.7320508075688772"}), results);
+}
+
+/**
+ * Partitions evaluate expressions locally and the rows are concatenated
+ */
+TEST(ExpressionPartitionTest, ScatterGather) {
+    PartitionedDatabase db(3);
+    ASSERT_TRUE(db.connect("partitions"));
+    for (int i = 0; i < 30; ++i) {
+        ASSERT_TRUE(db.insertUser("User" + std::to_string(i), i));
+    }
+
+    std::vector<std::string> results;
+    ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE AGE * 3 >= 60", results));
+    EXPECT_EQ(std::vector<std::string>({"10"}), results);
+
+    ASSERT_TRUE(db.executeQuery("SELECT AGE + 1000 FROM USERS WHERE AGE < 3", results));
+    std::sort(results.begin(), results.end());
+    EXPECT_EQ(std::vector<std::string>({"1000", "1001", "1002"}), results);
+}
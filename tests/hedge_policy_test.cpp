@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+/**
+ * Hedge Policy Test Suite
+ * Covers the latency percentile, the hedge budget and hedged service reads
+ */
+
+namespace {
+
+// In-memory engine whose point reads take a configurable extra delay
+class SlowDatabase : public InMemoryDatabase {
+public:
+    std::string getUserName(int userId) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs.load()));
+        ++reads;
+        if (failing) {
+            throw std::runtime_error("replica read failed");
+        }
+        return InMemoryDatabase::getUserName(userId);
+    }
+
+    std::atomic<int> delayMs{0};
+    std::atomic<int> reads{0};
+    std::atomic<bool> failing{false};
+};
+
+} // namespace
+
+// ============================================================================
+// POLICY
+// ============================================================================
+
+/**
+ * The hedge delay tracks the configured percentile once enough samples exist
+ */
+TEST(HedgePolicyTest, DelayFollowsPercentile) {
+    HedgeOptions options;
+    options.minSamples = 10;
+    options.windowSize = 100;
+    options.initialDelay = 7ms;
+    HedgePolicy policy(options);
+    EXPECT_EQ(HedgePolicy::Clock::duration(7ms), policy.hedgeDelay());
+
+    // Any 100 consecutive samples hold each of 1..100 ms once
+    for (int i = 0; i < 300; ++i) {
+        policy.recordLatency(std::chrono::milliseconds(i % 100 + 1));
+    }
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(policy.hedgeDelay());
+    EXPECT_GE(delay.count(), 90);
+    EXPECT_LE(delay.count(), 96);
+}
+
+/**
+ * Hedges are paid for by reads and capped by the burst size
+ */
+TEST(HedgePolicyTest, Budget) {
+    HedgeOptions options;
+    options.budgetRatio = 0.5;
+    options.maxBurst = 1.0;
+    HedgePolicy policy(options);
+
+    policy.onRead();
+    EXPECT_FALSE(policy.tryHedge());
+    policy.onRead();
+    EXPECT_TRUE(policy.tryHedge());
+    EXPECT_FALSE(policy.tryHedge());
+
+    for (int i = 0; i < 10; ++i) {
+        policy.onRead();
+    }
+    EXPECT_TRUE(policy.tryHedge());
+    EXPECT_FALSE(policy.tryHedge());
+    EXPECT_EQ(12u, policy.getReads());
+    EXPECT_EQ(2u, policy.getHedges());
+}
+
+/**
+ * The executor only takes work an idle worker can start at once
+ */
+TEST(HedgeExecutorTest, RefusesWhenBusy) {
+    HedgeExecutor executor(1);
+    std::atomic<bool> release{false};
+    std::atomic<int> ran{0};
+    auto blocker = [&release, &ran] {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ++ran;
+    };
+
+    ASSERT_TRUE(executor.submit(blocker));
+    EXPECT_FALSE(executor.submit([&ran] { ++ran; }));
+
+    // The worker counts as idle again once it has finished the blocker
+    release = true;
+    bool accepted = false;
+    for (int i = 0; i < 1000 && !accepted; ++i) {
+        accepted = executor.submit([&ran] { ++ran; });
+        if (!accepted) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_TRUE(accepted);
+    while (ran.load() < 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// ============================================================================
+// HEDGED SERVICE READS
+// ============================================================================
+
+class HedgedServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        primary = std::make_shared<InMemoryDatabase>();
+        slow = std::make_shared<SlowDatabase>();
+        fast = std::make_shared<SlowDatabase>();
+        service = std::make_unique<DatabaseService>(primary);
+        service->setReplicas({slow, fast});
+        ASSERT_TRUE(service->initializeConnection("memory"));
+        slow->insertUser("Alice", 25);
+        fast->insertUser("Alice", 25);
+    }
+
+    std::shared_ptr<InMemoryDatabase> primary;
+    std::shared_ptr<SlowDatabase> slow;
+    std::shared_ptr<SlowDatabase> fast;
+    std::unique_ptr<DatabaseService> service;
+};
+
+/**
+ * A read stuck on a slow replica is answered by the hedge to another one
+ */
+TEST_F(HedgedServiceTest, HedgeBeatsSlowReplica) {
+    HedgeOptions options;
+    options.initialDelay = 5ms;
+    options.budgetRatio = 1.0;
+    auto policy = std::make_shared<HedgePolicy>(options);
+    service->setHedgePolicy(policy);
+    slow->delayMs = 300;
+
+    // The first read goes to the slow replica, which is listed first
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ("Name: Alice, Age: 25", service->getUserInfo(1));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 200ms);
+    EXPECT_EQ(1u, policy->getHedges());
+    EXPECT_EQ(1u, policy->getHedgeWins());
+}
+
+/**
+ * Without budget the read simply waits for its only attempt
+ */
+TEST_F(HedgedServiceTest, NoBudgetNoHedge) {
+    HedgeOptions options;
+    options.initialDelay = 5ms;
+    options.budgetRatio = 0.0;
+    auto policy = std::make_shared<HedgePolicy>(options);
+    service->setHedgePolicy(policy);
+    slow->delayMs = 40;
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ("Name: Alice, Age: 25", service->getUserInfo(1));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 40ms);
+    EXPECT_EQ(0u, policy->getHedges());
+    EXPECT_EQ(1u, policy->getReads());
+}
+
+/**
+ * A throwing attempt surfaces in the caller instead of ending the process
+ */
+TEST_F(HedgedServiceTest, AttemptExceptionReachesCaller) {
+    HedgeOptions options;
+    options.budgetRatio = 0.0;
+    service->setHedgePolicy(std::make_shared<HedgePolicy>(options));
+    slow->failing = true;
+
+    EXPECT_THROW(service->getUserInfo(1), std::runtime_error);
+}
+
+/**
+ * Destroying the service waits for a losing attempt still in flight
+ */
+TEST_F(HedgedServiceTest, DestructionJoinsLosingAttempt) {
+    HedgeOptions options;
+    options.initialDelay = 5ms;
+    options.budgetRatio = 1.0;
+    service->setHedgePolicy(std::make_shared<HedgePolicy>(options));
+    slow->delayMs = 100;
+
+    EXPECT_EQ("Name: Alice, Age: 25", service->getUserInfo(1));
+    EXPECT_EQ(0, slow->reads.load());
+    service.reset();
+    EXPECT_EQ(1, slow->reads.load());
+}
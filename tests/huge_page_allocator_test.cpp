@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "huge_page_allocator.h"
+#include "in_memory_database.h"
+#include <cstring>
+#include <vector>
+
+/**
+ * Huge Page Allocator Test Suite
+ * The large path must behave like ordinary memory whatever the kernel
+ * grants, and containers must work with the allocator
+ */
+
+/**
+ * Large blocks are mapped in whole huge pages and released again
+ */
+TEST(HugePageAllocatorTest, LargeAllocation) {
+    HugePageMemory::Stats before = HugePageMemory::getStats();
+
+    const size_t bytes = 3 * HugePageMemory::kHugePageSize + 123;
+    char* block = static_cast<char*>(HugePageMemory::allocate(bytes, HugePageMemory::currentNumaNode()));
+    ASSERT_NE(nullptr, block);
+    std::memset(block, 0x5a, bytes);
+    EXPECT_EQ(0x5a, block[bytes - 1]);
+
+#ifdef __linux__
+    HugePageMemory::Stats during = HugePageMemory::getStats();
+    EXPECT_EQ(before.mappedBytes + 4 * HugePageMemory::kHugePageSize, during.mappedBytes);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % HugePageMemory::kHugePageSize);
+#endif
+
+    HugePageMemory::deallocate(block, bytes);
+    EXPECT_EQ(before.mappedBytes, HugePageMemory::getStats().mappedBytes);
+}
+
+/**
+ * Small requests stay on the regular heap
+ */
+TEST(HugePageAllocatorTest, SmallAllocation) {
+    HugePageMemory::Stats before = HugePageMemory::getStats();
+    void* small = HugePageMemory::allocate(64);
+    EXPECT_EQ(before.mappedBytes, HugePageMemory::getStats().mappedBytes);
+    HugePageMemory::deallocate(small, 64);
+}
+
+/**
+ * Explicit huge pages fall back to transparent ones when none are reserved
+ */
+TEST(HugePageAllocatorTest, ExplicitFallback) {
+    HugePageMemory::setExplicitHugePages(true);
+    void* block = HugePageMemory::allocate(HugePageMemory::kHugePageSize);
+    ASSERT_NE(nullptr, block);
+    static_cast<char*>(block)[0] = 1;
+    HugePageMemory::deallocate(block, HugePageMemory::kHugePageSize);
+    HugePageMemory::setExplicitHugePages(false);
+}
+
+/**
+ * Containers grow across the small/large threshold and keep their contents
+ */
+TEST(HugePageAllocatorTest, ContainerGrowth) {
+    std::vector<int, HugePageAllocator<int>> column(HugePageAllocator<int>(0));
+    for (int i = 0; i < 1000000; ++i) {
+        column.push_back(i);
+    }
+    EXPECT_EQ(999999, column.back());
+    EXPECT_EQ(0, column.get_allocator().getNumaNode());
+    EXPECT_TRUE(HugePageAllocator<int>(1) == HugePageAllocator<char>(1));
+    EXPECT_TRUE(HugePageAllocator<int>(1) != HugePageAllocator<int>(2));
+}
+
+/**
+ * The engine runs unchanged on node-bound columns
+ */
+TEST(HugePageAllocatorTest, EngineColumns) {
+    InMemoryDatabase db(1, 1, HugePageMemory::currentNumaNode());
+    db.connect("memory");
+    for (int i = 0; i < 50000; ++i) {
+        db.insertUser("user", i % 100);
+    }
+    EXPECT_EQ(50000, db.getUserCount());
+    EXPECT_EQ(99, db.getUserAge(50000));
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "hyperloglog.h"
+#include "in_memory_database.h"
+#include "partitioned_database.h"
+#include "sharded_database.h"
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * HyperLogLog Test Suite
+ * Checks sketch accuracy and merging, and COUNT(DISTINCT NAME) in the
+ * engine and across partitions and shards
+ */
+
+namespace {
+
+double relativeError(uint64_t estimate, uint64_t actual) {
+    return std::fabs(static_cast<double>(estimate) - static_cast<double>(actual)) / static_cast<double>(actual);
+}
+
+} // namespace
+
+// ============================================================================
+// SKETCH
+// ============================================================================
+
+/**
+ * Estimates stay within a few standard errors; duplicates change nothing
+ */
+TEST(HyperLogLogTest, Accuracy) {
+    HyperLogLog sketch;
+    EXPECT_EQ(0u, sketch.estimate());
+    EXPECT_LT(sketch.standardError(), 0.01);
+
+    for (uint64_t actual : {10ull, 1000ull, 20000ull, 200000ull}) {
+        sketch.clear();
+        for (int pass = 0; pass < 2; ++pass) {
+            for (uint64_t i = 0; i < actual; ++i) {
+                sketch.add("user-" + std::to_string(i));
+            }
+        }
+        EXPECT_LT(relativeError(sketch.estimate(), actual), 0.03) << actual;
+    }
+
+    EXPECT_THROW(HyperLogLog(3), std::invalid_argument);
+    EXPECT_THROW(HyperLogLog(19), std::invalid_argument);
+}
+
+/**
+ * Merged sketches equal one sketch of the union; precisions must match
+ */
+TEST(HyperLogLogTest, Merge) {
+    HyperLogLog left;
+    HyperLogLog right;
+    HyperLogLog both;
+    for (int i = 0; i < 30000; ++i) {
+        const std::string value = std::to_string(i);
+        (i < 20000 ? left : right).add(value);
+        if (i >= 10000 && i < 20000) {
+            right.add(value);
+        }
+        both.add(value);
+    }
+
+    ASSERT_TRUE(left.merge(right));
+    EXPECT_EQ(both.estimate(), left.estimate());
+    EXPECT_LT(relativeError(left.estimate(), 30000), 0.03);
+
+    HyperLogLog coarse(10);
+    EXPECT_FALSE(left.merge(coarse));
+    EXPECT_EQ(both.estimate(), left.estimate());
+}
+
+// ============================================================================
+// ENGINE QUERIES
+// ============================================================================
+
+/**
+ * Distinct counts follow inserts, renames and deletes, with and without WHERE
+ */
+TEST(HyperLogLogTest, EngineDistinctNames) {
+    InMemoryDatabase db;
+    ASSERT_TRUE(db.connect("memory"));
+    for (int i = 0; i < 3000; ++i) {
+        db.insertUser("name-" + std::to_string(i % 1000), 20 + i % 3);
+    }
+
+    std::vector<std::string> results;
+    ASSERT_TRUE(db.executeQuery("SELECT COUNT(DISTINCT NAME) FROM USERS", results));
+    ASSERT_EQ(1u, results.size());
+    EXPECT_LT(relativeError(std::stoull(results[0]), 1000), 0.03);
+
+    // Built sketches keep following inserts
+    for (int i = 0; i < 1000; ++i) {
+        db.insertUser("extra-" + std::to_string(i), 30);
+    }
+    EXPECT_LT(relativeError(static_cast<uint64_t>(db.estimateDistinctNames()), 2000), 0.03);
+
+    // Deletes and renames rebuild the affected segment
+    for (int userId = 3001; userId <= 4000; ++userId) {
+        db.deleteUser(userId);
+    }
+    db.updateUser(1, "renamed", 20);
+    EXPECT_LT(relativeError(static_cast<uint64_t>(db.estimateDistinctNames()), 1001), 0.03);
+
+    ASSERT_TRUE(db.executeQuery("SELECT COUNT(DISTINCT NAME) FROM USERS WHERE AGE = 21", results));
+    EXPECT_LT(relativeError(std::stoull(results[0]), 1000), 0.03);
+
+    HyperLogLog coarse(10);
+    EXPECT_FALSE(db.mergeDistinctNames("SELECT COUNT(DISTINCT NAME) FROM USERS", coarse));
+    EXPECT_FALSE(db.mergeDistinctNames("SELECT COUNT(*) FROM USERS", coarse));
+}
+
+/**
+ * Names repeated across partitions or shards are counted once
+ */
+TEST(HyperLogLogTest, MergedAcrossPartitionsAndShards) {
+    PartitionedDatabase partitioned(3);
+    ASSERT_TRUE(partitioned.connect("memory"));
+
+    std::vector<std::shared_ptr<DatabaseInterface>> backends;
+    for (int i = 0; i < 3; ++i) {
+        backends.push_back(std::make_shared<InMemoryDatabase>());
+    }
+    ShardedDatabase sharded(backends);
+    ASSERT_TRUE(sharded.connect("memory"));
+
+    for (int i = 0; i < 6000; ++i) {
+        const std::string name = "name-" + std::to_string(i % 1500);
+        partitioned.insertUser(name, 40);
+        sharded.insertUser(name, 40);
+    }
+
+    EXPECT_LT(relativeError(static_cast<uint64_t>(partitioned.estimateDistinctNames()), 1500), 0.03);
+    for (DatabaseInterface* db : {static_cast<DatabaseInterface*>(&partitioned),
+                                  static_cast<DatabaseInterface*>(&sharded)}) {
+        std::vector<std::string> results;
+        ASSERT_TRUE(db->executeQuery("select count(distinct name) from users where age > 30", results));
+        ASSERT_EQ(1u, results.size());
+        EXPECT_LT(relativeError(std::stoull(results[0]), 1500), 0.03);
+
+        ASSERT_TRUE(db->executeQuery("SELECT COUNT(*) FROM USERS", results));
+        EXPECT_EQ(std::vector<std::string>({"6000"}), results);
+    }
+}
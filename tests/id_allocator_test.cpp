@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "id_allocator.h"
+#include "in_memory_database.h"
+#include "partitioned_database.h"
+#include "sharded_database.h"
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * IdAllocator Test Suite
+ * Checks block allocation and reservations, and that every engine reports
+ * the id an insert assigned
+ */
+
+// ============================================================================
+// ALLOCATOR
+// ============================================================================
+
+/**
+ * One thread gets consecutive ids, block after block
+ */
+TEST(IdAllocatorTest, SequentialWithinThread) {
+    IdAllocator ids(1, 4);
+    for (int expected = 1; expected <= 10; ++expected) {
+        EXPECT_EQ(expected, ids.allocate());
+    }
+    EXPECT_EQ(13, ids.limit());
+    EXPECT_THROW(IdAllocator(1, 0), std::invalid_argument);
+}
+
+/**
+ * Concurrent allocators never hand out the same id, and each thread's ids increase
+ */
+TEST(IdAllocatorTest, ConcurrentIdsAreUnique) {
+    IdAllocator ids;
+    const int threadCount = 8;
+    const int perThread = 20000;
+    std::vector<std::vector<int>> drawn(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&ids, &drawn, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                drawn[t].push_back(ids.allocate());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::set<int> unique;
+    for (const auto& values : drawn) {
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+        unique.insert(values.begin(), values.end());
+    }
+    EXPECT_EQ(static_cast<size_t>(threadCount * perThread), unique.size());
+    EXPECT_LT(*unique.rbegin(), ids.limit());
+}
+
+/**
+ * Allocation resumes above a reserved id, skipping the rest of a held block
+ */
+TEST(IdAllocatorTest, ReserveThroughSkipsChosenIds) {
+    IdAllocator ids(1, 8);
+    EXPECT_EQ(1, ids.allocate());
+
+    ids.reserveThrough(5);
+    EXPECT_EQ(6, ids.allocate());
+
+    ids.reserveThrough(100);
+    EXPECT_EQ(101, ids.limit());
+    EXPECT_EQ(101, ids.allocate());
+
+    ids.reserveThrough(50);
+    EXPECT_EQ(102, ids.allocate());
+}
+
+/**
+ * Allocators keep separate blocks, even on the same thread
+ */
+TEST(IdAllocatorTest, InstancesAreIndependent) {
+    IdAllocator first(1, 16);
+    IdAllocator second(1000, 16);
+    EXPECT_EQ(1, first.allocate());
+    EXPECT_EQ(1000, second.allocate());
+    EXPECT_EQ(2, first.allocate());
+    EXPECT_EQ(1001, second.allocate());
+}
+
+// ============================================================================
+// INSERT RETURNING ID
+// ============================================================================
+
+/**
+ * The engine reports the slot id, including within a strided range
+ */
+TEST(InsertReturningIdTest, InMemory) {
+    InMemoryDatabase db(2, 3);
+    EXPECT_EQ(-1, db.insertUserReturningId("Alice", 25));
+    ASSERT_TRUE(db.connect("memory"));
+
+    EXPECT_EQ(2, db.insertUserReturningId("Alice", 25));
+    EXPECT_EQ(5, db.insertUserReturningId("Bob", 30));
+    EXPECT_EQ("Bob", db.getUserName(5));
+    EXPECT_EQ(-1, db.insertUserReturningId("", 30));
+    EXPECT_EQ("Invalid user data", db.getLastError());
+}
+
+/**
+ * Partition ids come back as assigned by the owning partition
+ */
+TEST(InsertReturningIdTest, Partitioned) {
+    PartitionedDatabase db(3);
+    ASSERT_TRUE(db.connect("partitions"));
+    std::set<int> seen;
+    for (int i = 0; i < 9; ++i) {
+        int userId = db.insertUserReturningId("User" + std::to_string(i), 20 + i);
+        ASSERT_GT(userId, 0);
+        EXPECT_TRUE(seen.insert(userId).second);
+        EXPECT_EQ(20 + i, db.getUserAge(userId));
+    }
+}
+
+/**
+ * Concurrent router inserts get distinct ids that all resolve
+ */
+TEST(InsertReturningIdTest, ShardedConcurrent) {
+    std::vector<std::shared_ptr<DatabaseInterface>> backends;
+    for (int i = 0; i < 3; ++i) {
+        backends.push_back(std::make_shared<InMemoryDatabase>());
+    }
+    ShardedDatabase db(backends);
+    ASSERT_TRUE(db.connect("memory"));
+    ASSERT_TRUE(db.insertUserWithId(5, "Explicit", 50));
+
+    const int threadCount = 4;
+    const int perThread = 500;
+    std::vector<std::vector<int>> assigned(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&db, &assigned, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                assigned[t].push_back(db.insertUserReturningId("T" + std::to_string(t), t));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::set<int> unique;
+    for (int t = 0; t < threadCount; ++t) {
+        for (int userId : assigned[t]) {
+            ASSERT_GT(userId, 5);
+            EXPECT_EQ("T" + std::to_string(t), db.getUserName(userId));
+            unique.insert(userId);
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(threadCount * perThread), unique.size());
+    EXPECT_EQ(threadCount * perThread + 1, db.getUserCount());
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "in_memory_database.h"
+#include <algorithm>
+#include <memory>
+
+/**
+ * In-Memory Database Test Suite
+ * Exercises the concrete column store directly and through DatabaseService
+ */
+
+class InMemoryDatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db = std::make_shared<InMemoryDatabase>();
+        ASSERT_TRUE(db->connect("memory"));
+    }
+
+    void TearDown() override {
+        db.reset();
+    }
+
+    std::shared_ptr<InMemoryDatabase> db;
+};
+
+// ============================================================================
+// CRUD OPERATIONS
+// ============================================================================
+
+/**
+ * Inserted users receive sequential ids and can be read, updated and deleted
+ */
+TEST_F(InMemoryDatabaseTest, BasicCrud) {
+    EXPECT_TRUE(db->insertUser("Alice", 25));
+    EXPECT_TRUE(db->insertUser("Bob", 30));
+    EXPECT_EQ(2, db->getUserCount());
+
+    EXPECT_EQ("Alice", db->getUserName(1));
+    EXPECT_EQ(30, db->getUserAge(2));
+
+    EXPECT_TRUE(db->updateUser(1, "Alicia", 26));
+    EXPECT_EQ("Alicia", db->getUserName(1));
+    EXPECT_EQ(26, db->getUserAge(1));
+
+    EXPECT_TRUE(db->deleteUser(2));
+    EXPECT_EQ("", db->getUserName(2));
+    EXPECT_EQ(-1, db->getUserAge(2));
+    EXPECT_EQ(1, db->getUserCount());
+}
+
+/**
+ * Invalid input and unknown ids fail and record an error
+ */
+TEST_F(InMemoryDatabaseTest, ErrorReporting) {
+    EXPECT_FALSE(db->insertUser("", 20));
+    EXPECT_EQ("Invalid user data", db->getLastError());
+
+    db->clearError();
+    EXPECT_FALSE(db->deleteUser(42));
+    EXPECT_EQ("User not found", db->getLastError());
+
+    db->disconnect();
+    EXPECT_FALSE(db->insertUser("Carol", 40));
+    EXPECT_EQ("Not connected", db->getLastError());
+}
+
+/**
+ * The small built-in query set returns names, rows and counts
+ */
+TEST_F(InMemoryDatabaseTest, ExecuteQuery) {
+    db->insertUser("Alice", 25);
+    db->insertUser("Bob", 30);
+
+    std::vector<std::string> results;
+    EXPECT_TRUE(db->executeQuery("select name from users;", results));
+    EXPECT_EQ((std::vector<std::string>{"Alice", "Bob"}), results);
+
+    EXPECT_TRUE(db->executeQuery("SELECT * FROM users", results));
+    EXPECT_EQ((std::vector<std::string>{"1,Alice,25", "2,Bob,30"}), results);
+
+    EXPECT_TRUE(db->executeQuery("SELECT COUNT(*) FROM users", results));
+    EXPECT_EQ((std::vector<std::string>{"2"}), results);
+
+    EXPECT_FALSE(db->executeQuery("DROP TABLE users", results));
+}
+
+// ============================================================================
+// BATCH LOOKUP
+// ============================================================================
+
+/**
+ * getUsers keeps input order and marks unknown or deleted ids
+ */
+TEST_F(InMemoryDatabaseTest, BatchLookup) {
+    for (int i = 0; i < 100; ++i) {
+        db->insertUser("user" + std::to_string(i), i);
+    }
+    db->deleteUser(50);
+
+    std::vector<int> ids = {100, 1, 50, 0, 999, 37};
+    std::vector<UserRecord> records = db->getUsers(ids);
+    ASSERT_EQ(ids.size(), records.size());
+
+    EXPECT_EQ(100, records[0].id);
+    EXPECT_EQ("user99", records[0].name);
+    EXPECT_EQ(99, records[0].age);
+    EXPECT_EQ("user0", records[1].name);
+    EXPECT_TRUE(records[2].name.empty());
+    EXPECT_EQ(-1, records[2].age);
+    EXPECT_TRUE(records[3].name.empty());
+    EXPECT_TRUE(records[4].name.empty());
+    EXPECT_EQ(36, records[5].age);
+}
+
+/**
+ * Paging with the last id as cursor visits every live user once, in id order
+ */
+TEST_F(InMemoryDatabaseTest, KeysetPagination) {
+    for (int i = 0; i < 100; ++i) {
+        db->insertUser("user" + std::to_string(i), i);
+    }
+    for (int userId = 10; userId <= 30; ++userId) {
+        db->deleteUser(userId);
+    }
+
+    std::vector<int> seen;
+    int cursor = 0;
+    while (true) {
+        std::vector<UserRecord> page = db->listUsers(cursor, 7);
+        if (page.empty()) {
+            break;
+        }
+        EXPECT_LE(page.size(), 7u);
+        for (const UserRecord& record : page) {
+            EXPECT_EQ("user" + std::to_string(record.id - 1), record.name);
+            seen.push_back(record.id);
+        }
+        cursor = page.back().id;
+    }
+    ASSERT_EQ(79u, seen.size());
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+    EXPECT_EQ(9, seen[8]);
+    EXPECT_EQ(31, seen[9]);
+
+    // A cursor on a deleted id resumes after it
+    std::vector<UserRecord> page = db->listUsers(15, 2);
+    ASSERT_EQ(2u, page.size());
+    EXPECT_EQ(31, page[0].id);
+    EXPECT_EQ(32, page[1].id);
+    EXPECT_TRUE(db->listUsers(100, 5).empty());
+    EXPECT_TRUE(db->listUsers(0, 0).empty());
+}
+
+/**
+ * Widely spaced explicit ids switch to sparse storage without changing results
+ */
+TEST_F(InMemoryDatabaseTest, SparseIds) {
+    EXPECT_TRUE(db->insertUser("Alice", 25));
+    EXPECT_TRUE(db->insertUserWithId(4000000, "Dave", 40));
+    EXPECT_TRUE(db->insertUserWithId(2000000, "Carol", 35));
+    EXPECT_FALSE(db->insertUserWithId(2000000, "Again", 1));
+    EXPECT_EQ(4000001, db->insertUserReturningId("Erin", 45));
+    EXPECT_EQ(4, db->getUserCount());
+    EXPECT_EQ("Carol", db->getUserName(2000000));
+    EXPECT_EQ("", db->getUserName(3000000));
+
+    // Pages and query rows stay in id order, whatever the insert order
+    std::vector<UserRecord> page = db->listUsers(1, 2);
+    ASSERT_EQ(2u, page.size());
+    EXPECT_EQ(2000000, page[0].id);
+    EXPECT_EQ(4000000, page[1].id);
+
+    std::vector<std::string> results;
+    EXPECT_TRUE(db->executeQuery("SELECT * FROM users WHERE age > 30", results));
+    EXPECT_EQ((std::vector<std::string>{"2000000,Carol,35", "4000000,Dave,40", "4000001,Erin,45"}), results);
+
+    // A deleted id can be inserted again
+    EXPECT_TRUE(db->deleteUser(2000000));
+    EXPECT_TRUE(db->insertUserWithId(2000000, "Carla", 36));
+    EXPECT_EQ("Carla", db->getUsers({2000000})[0].name);
+    EXPECT_EQ(4, db->getUserCount());
+}
+
+/**
+ * Compaction drops tombstones only once they dominate, keeping every id
+ */
+TEST_F(InMemoryDatabaseTest, CompactDropsTombstones) {
+    for (int i = 1; i <= 200; ++i) {
+        ASSERT_TRUE(db->insertUser("User" + std::to_string(i), i));
+    }
+    for (int userId = 1; userId <= 150; ++userId) {
+        ASSERT_TRUE(db->deleteUser(userId));
+    }
+    EXPECT_EQ(0u, db->compact());
+    for (int userId = 151; userId <= 190; ++userId) {
+        ASSERT_TRUE(db->deleteUser(userId));
+    }
+    EXPECT_EQ(190u, db->compact());
+    EXPECT_EQ(0u, db->compact());
+
+    EXPECT_EQ(10, db->getUserCount());
+    EXPECT_EQ("User195", db->getUserName(195));
+    EXPECT_EQ("", db->getUserName(5));
+    EXPECT_EQ(201, db->insertUserReturningId("Next", 1));
+    EXPECT_TRUE(db->insertUserWithId(5, "Back", 5));
+    EXPECT_EQ(5, db->listUsers(0, 1)[0].id);
+
+    std::vector<std::string> results;
+    ASSERT_TRUE(db->executeQuery("SELECT COUNT(DISTINCT NAME) FROM USERS", results));
+    EXPECT_EQ(std::vector<std::string>({"12"}), results);
+}
+
+/**
+ * DatabaseService works end to end on top of the in-memory engine
+ */
+TEST_F(InMemoryDatabaseTest, ServiceIntegration) {
+    DatabaseService service(db);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+
+    EXPECT_TRUE(service.createUser("Alice", 25));
+    EXPECT_EQ("Name: Alice, Age: 25", service.getUserInfo(1));
+    EXPECT_EQ(1, service.getTotalUsers());
+    EXPECT_EQ(2u, service.getUsers({1, 2}).size());
+    EXPECT_EQ(1u, service.listUsers(0, 10).size());
+    EXPECT_TRUE(service.removeUser(1));
+    EXPECT_EQ("", service.getUserInfo(1));
+    EXPECT_EQ(2, service.createUserReturningId("Bob", 30));
+    EXPECT_EQ("Name: Bob, Age: 30", service.getUserInfo(2));
+    EXPECT_EQ(-1, service.createUserReturningId("", 30));
+}
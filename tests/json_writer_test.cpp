@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include "json_writer.h"
+#include <memory>
+
+/**
+ * JSON Writer Test Suite
+ * Covers structure, escaping on both sides of the 16-byte fast path and the
+ * user record helpers
+ */
+
+namespace {
+
+// Reference escaper, one byte at a time
+std::string slowEscape(const std::string& text) {
+    std::string out;
+    for (unsigned char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                char unicode[8];
+                snprintf(unicode, sizeof(unicode), "\\u%04x", c);
+                out += unicode;
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+// ============================================================================
+// ESCAPING
+// ============================================================================
+
+/**
+ * Every byte value escapes the same as the reference, at every offset
+ * within and across 16-byte chunks
+ */
+TEST(JsonWriterTest, EscapingMatchesReference) {
+    for (int c = 0; c < 256; ++c) {
+        for (size_t offset : {0u, 5u, 15u, 16u, 17u, 40u}) {
+            std::string text(offset, 'a');
+            text.push_back(static_cast<char>(c));
+            text.append(20, 'b');
+
+            std::string escaped;
+            JsonWriter::escape(escaped, text.data(), text.size());
+            ASSERT_EQ(slowEscape(text), escaped) << "byte " << c << " at " << offset;
+        }
+    }
+
+    std::string dense = "\"\\\n\t\"\\\x01\x1f \"\\\n\t\"\\\x01\x1f ";
+    std::string escaped;
+    JsonWriter::escape(escaped, dense.data(), dense.size());
+    EXPECT_EQ(slowEscape(dense), escaped);
+}
+
+// ============================================================================
+// STRUCTURE
+// ============================================================================
+
+/**
+ * Nested containers get commas and colons in the right places
+ */
+TEST(JsonWriterTest, NestedStructure) {
+    JsonWriter writer;
+    writer.beginObject();
+    writer.key("ok");
+    writer.value(true);
+    writer.key("count");
+    writer.value(-42);
+    writer.key("items");
+    writer.beginArray();
+    writer.value("a");
+    writer.beginObject();
+    writer.endObject();
+    writer.nullValue();
+    writer.endArray();
+    writer.key("say \"hi\"");
+    writer.value(std::string("line\nbreak"));
+    writer.endObject();
+
+    EXPECT_EQ("{\"ok\":true,\"count\":-42,\"items\":[\"a\",{},null],"
+              "\"say \\\"hi\\\"\":\"line\\nbreak\"}",
+              writer.str());
+
+    std::string taken = writer.take();
+    EXPECT_FALSE(taken.empty());
+    EXPECT_TRUE(writer.str().empty());
+}
+
+/**
+ * User records and result rows serialize directly
+ */
+TEST(JsonWriterTest, RecordsAndRows) {
+    JsonWriter writer;
+    UserRecord alice;
+    alice.id = 1;
+    alice.name = "Alice";
+    alice.age = 25;
+    UserRecord missing;
+    missing.id = 2;
+    writer.writeUsers({alice, missing, alice});
+    EXPECT_EQ("[{\"id\":1,\"name\":\"Alice\",\"age\":25},{\"id\":1,\"name\":\"Alice\",\"age\":25}]",
+              writer.str());
+
+    writer.clear();
+    EXPECT_TRUE(writer.writeRows("SELECT * FROM USERS", {"1,Alice,25", "2,\"Bob\", Jr,30"}));
+    EXPECT_EQ("[{\"id\":1,\"name\":\"Alice\",\"age\":25},{\"id\":2,\"name\":\"\\\"Bob\\\", Jr\",\"age\":30}]",
+              writer.str());
+}
+
+/**
+ * Query rows become one JSON value per row, shaped by the query's projection
+ */
+TEST(JsonWriterTest, QueryRows) {
+    JsonWriter writer;
+    EXPECT_TRUE(writer.writeRows("SELECT NAME FROM USERS", {"Alice"}));
+    EXPECT_EQ("[{\"name\":\"Alice\"}]", writer.str());
+
+    writer.clear();
+    EXPECT_TRUE(writer.writeRows("SELECT COUNT(*) FROM USERS", {"42"}));
+    EXPECT_EQ("[{\"count\":42}]", writer.str());
+
+    writer.clear();
+    EXPECT_TRUE(writer.writeRows("SELECT ID, NAME, AGE / 4, AGE FROM USERS", {"3,Lee, Ann,7.5,30", "4,Bo,0.25,1"}));
+    EXPECT_EQ("[[3,\"Lee, Ann\",7.5,30],[4,\"Bo\",0.25,1]]", writer.str());
+
+    writer.clear();
+    EXPECT_TRUE(writer.writeRows("SELECT ID * 2, AGE FROM USERS", {"6,30"}));
+    EXPECT_EQ("[[6,30]]", writer.str());
+
+    // Fields that do not read back as a finite number become null
+    writer.clear();
+    EXPECT_TRUE(writer.writeRows("SELECT ID, AGE, ID + AGE, AGE * 2 FROM USERS", {"inf,-nan,1e400,2.5e-3"}));
+    EXPECT_EQ("[[null,null,null,2.5e-3]]", writer.str());
+
+    // A query the engines would reject writes nothing
+    writer.clear();
+    EXPECT_FALSE(writer.writeRows("DROP TABLE USERS", {"1"}));
+    EXPECT_TRUE(writer.str().empty());
+}
+
+/**
+ * The service writes batch lookups straight into a writer
+ */
+TEST(JsonWriterTest, ServiceBatch) {
+    auto db = std::make_shared<InMemoryDatabase>();
+    DatabaseService service(db);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+    service.createUser("Alice", 25);
+    service.createUser("Bob", 30);
+
+    JsonWriter writer;
+    EXPECT_EQ(2u, service.getUsersJson({2, 7, 1}, writer));
+    EXPECT_EQ("[{\"id\":2,\"name\":\"Bob\",\"age\":30},{\"id\":1,\"name\":\"Alice\",\"age\":25}]",
+              writer.str());
+}
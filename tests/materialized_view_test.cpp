@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "in_memory_database.h"
+#include "materialized_view.h"
+#include "partitioned_database.h"
+#include <memory>
+
+/**
+ * Materialized View Test Suite
+ * Aggregates must match a full recount after any mix of mutations
+ */
+
+class MaterializedViewTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db = std::make_shared<InMemoryDatabase>();
+        db->connect("memory");
+        buckets = std::make_shared<AgeBucketCountView>(10, 5);
+        stats = std::make_shared<AgeStatsView>();
+    }
+
+    std::shared_ptr<InMemoryDatabase> db;
+    std::shared_ptr<AgeBucketCountView> buckets;
+    std::shared_ptr<AgeStatsView> stats;
+};
+
+/**
+ * Bucket boundaries, the negative clamp and the open-ended last bucket
+ */
+TEST_F(MaterializedViewTest, BucketMapping) {
+    EXPECT_EQ(0u, buckets->bucketOf(0));
+    EXPECT_EQ(0u, buckets->bucketOf(9));
+    EXPECT_EQ(1u, buckets->bucketOf(10));
+    EXPECT_EQ(4u, buckets->bucketOf(40));
+    EXPECT_EQ(4u, buckets->bucketOf(120));
+    EXPECT_THROW(AgeBucketCountView(0, 5), std::invalid_argument);
+}
+
+/**
+ * Views attached late are seeded from existing rows, then follow every delta
+ */
+TEST_F(MaterializedViewTest, IncrementalMaintenance) {
+    db->insertUser("Alice", 25);
+    db->insertUser("Bob", 31);
+    db->addView(buckets);
+    db->addView(stats);
+    EXPECT_EQ(1, buckets->getCountForAge(25));
+    EXPECT_EQ(28.0, stats->getAverageAge());
+
+    db->insertUser("Carol", 27);
+    db->updateUser(2, "Bobby", 45);
+    db->deleteUser(1);
+    db->updateUser(3, "", 1);  // rejected, no delta
+
+    EXPECT_EQ((std::vector<int64_t>{0, 0, 1, 0, 1}), buckets->getCounts());
+    EXPECT_EQ(2, stats->getCount());
+    EXPECT_EQ(72, stats->getAgeSum());
+    EXPECT_DOUBLE_EQ(36.0, stats->getAverageAge());
+}
+
+/**
+ * One view fed concurrently by every partition ends up exact
+ */
+TEST_F(MaterializedViewTest, PartitionedFeeds) {
+    PartitionedDatabase partitioned(4);
+    partitioned.connect("partitions");
+    partitioned.addView(stats);
+
+    for (int i = 0; i < 100; ++i) {
+        partitioned.insertUser("user", i);
+    }
+    for (int id = 1; id <= 50; ++id) {
+        partitioned.deleteUser(id);
+    }
+
+    EXPECT_EQ(50, stats->getCount());
+    EXPECT_EQ(partitioned.getUserCount(), stats->getCount());
+    EXPECT_EQ((50 + 99) * 50 / 2, stats->getAgeSum());
+}
@@ -193,6 +193,98 @@ TEST_F(MockDatabaseTest, MultipleReturnValues) {
     EXPECT_EQ("Name: Unknown, Age: 0", info3);
 }
 
+/**
+ * Test the default batch lookup built on the per-id virtual calls
+ * Unknown ids skip the age lookup entirely
+ */
+TEST_F(MockDatabaseTest, DefaultBatchLookup) {
+    EXPECT_CALL(*mockDb, connect(_)).WillOnce(Return(true));
+    EXPECT_CALL(*mockDb, isConnected()).WillRepeatedly(Return(true));
+    
+    EXPECT_CALL(*mockDb, getUserName(1)).WillOnce(Return("Alice"));
+    EXPECT_CALL(*mockDb, getUserName(2)).WillOnce(Return(""));
+    EXPECT_CALL(*mockDb, getUserAge(1)).WillOnce(Return(25));
+    EXPECT_CALL(*mockDb, getUserAge(2)).Times(0);
+    
+    service->initializeConnection("test");
+    std::vector<UserRecord> records = service->getUsers({1, 2});
+    
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ("Alice", records[0].name);
+    EXPECT_EQ(25, records[0].age);
+    EXPECT_EQ(2, records[1].id);
+    EXPECT_EQ(-1, records[1].age);
+}
+
+/**
+ * Test the default bulk write built on the per-row virtual calls
+ * Every mutation is attempted even after one fails
+ */
+TEST_F(MockDatabaseTest, DefaultApplyMutations) {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*mockDb, insertUser("Alice", 25)).WillOnce(Return(true));
+    EXPECT_CALL(*mockDb, updateUser(7, "Bob", 31)).WillOnce(Return(false));
+    EXPECT_CALL(*mockDb, deleteUser(3)).WillOnce(Return(true));
+
+    std::vector<UserMutation> mutations(3);
+    mutations[0].name = "Alice";
+    mutations[0].age = 25;
+    mutations[1].type = MutationType::Update;
+    mutations[1].userId = 7;
+    mutations[1].name = "Bob";
+    mutations[1].age = 31;
+    mutations[2].type = MutationType::Delete;
+    mutations[2].userId = 3;
+
+    EXPECT_FALSE(mockDb->applyMutations(mutations));
+}
+
+/**
+ * Test the default typed calls built on the bool calls and getLastError
+ */
+TEST_F(MockDatabaseTest, DefaultTypedStatus) {
+    EXPECT_CALL(*mockDb, updateUser(7, "Bob", 31)).WillOnce(Return(false));
+    EXPECT_CALL(*mockDb, getLastError()).WillOnce(Return("User not found"));
+    EXPECT_CALL(*mockDb, deleteUser(3)).WillOnce(Return(true));
+    EXPECT_CALL(*mockDb, getUserName(4)).WillOnce(Return(""));
+    EXPECT_CALL(*mockDb, isConnected()).WillOnce(Return(false));
+
+    EXPECT_EQ(DbError::NotFound, mockDb->tryUpdateUser(7, "Bob", 31).code());
+    EXPECT_EQ("User not found", DbStatus::detail());
+    EXPECT_TRUE(mockDb->tryDeleteUser(3).ok());
+
+    UserRecord record;
+    EXPECT_EQ(DbError::NotConnected, mockDb->tryGetUser(4, record).code());
+}
+
+/**
+ * Test the default pagination built on a full SELECT *
+ * Names may contain commas; rows come back ordered by id
+ */
+TEST_F(MockDatabaseTest, DefaultListUsers) {
+    std::vector<std::string> rows = {"9,Carol,41", "2,Smith, Alice,25", "5,Bob,30"};
+    EXPECT_CALL(*mockDb, executeQuery("SELECT * FROM USERS", _))
+        .WillOnce(DoAll(SetArgReferee<1>(rows), Return(true)));
+
+    std::vector<UserRecord> page = mockDb->listUsers(1, 2);
+    ASSERT_EQ(2u, page.size());
+    EXPECT_EQ(2, page[0].id);
+    EXPECT_EQ("Smith, Alice", page[0].name);
+    EXPECT_EQ(25, page[0].age);
+    EXPECT_EQ(5, page[1].id);
+}
+
+/**
+ * Backends without native support insert through insertUser and report kUnknownId
+ */
+TEST_F(MockDatabaseTest, DefaultInsertReturningId) {
+    EXPECT_CALL(*mockDb, insertUser("Alice", 25)).WillOnce(Return(true));
+    EXPECT_CALL(*mockDb, insertUser("Bob", -1)).WillOnce(Return(false));
+
+    EXPECT_EQ(DatabaseInterface::kUnknownId, mockDb->insertUserReturningId("Alice", 25));
+    EXPECT_EQ(-1, mockDb->insertUserReturningId("Bob", -1));
+}
+
 // ============================================================================
 // ADVANCED MOCK FEATURES
 // ============================================================================
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "in_memory_database.h"
+#include "name_index.h"
+#include <map>
+#include <memory>
+#include <random>
+
+/**
+ * Name Index Test Suite
+ * Checks the radix tree and trigram lookups against brute force and the
+ * engine's NAME LIKE queries with and without the index
+ */
+
+namespace {
+
+std::vector<int> bruteForce(const std::map<int, std::string>& names, const std::string& pattern) {
+    std::vector<int> ids;
+    for (const auto& entry : names) {
+        if (NameIndex::likeMatch(entry.second, pattern)) {
+            ids.push_back(entry.first);
+        }
+    }
+    return ids;
+}
+
+} // namespace
+
+// ============================================================================
+// INDEX
+// ============================================================================
+
+/**
+ * Prefix and substring lookups, including edge splits and shared names
+ */
+TEST(NameIndexTest, PrefixAndSubstring) {
+    NameIndex index;
+    index.onInsert(1, "Alice", 25);
+    index.onInsert(2, "Alina", 30);
+    index.onInsert(3, "Al", 40);
+    index.onInsert(4, "Bob", 50);
+    index.onInsert(5, "Alice", 60);
+    index.onInsert(6, "Janice", 70);
+
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 5}), index.findPrefix("Al"));
+    EXPECT_EQ(std::vector<int>({1, 2, 5}), index.findPrefix("Ali"));
+    EXPECT_EQ(std::vector<int>({1, 5}), index.findPrefix("Alice"));
+    EXPECT_TRUE(index.findPrefix("Alicia").empty());
+    EXPECT_EQ(6u, index.findPrefix("").size());
+
+    EXPECT_EQ(std::vector<int>({1, 5, 6}), index.findSubstring("ice"));
+    EXPECT_EQ(std::vector<int>({1, 2, 5, 6}), index.findSubstring("i"));
+    EXPECT_TRUE(index.findSubstring("xyz").empty());
+
+    index.onUpdate(1, "Alice", 25, "Bobby", 25);
+    index.onDelete(3, "Al", 40);
+    EXPECT_EQ(std::vector<int>({2, 5}), index.findPrefix("Al"));
+    EXPECT_EQ(std::vector<int>({1, 4}), index.findPrefix("Bob"));
+    EXPECT_EQ(5u, index.size());
+}
+
+/**
+ * LIKE results agree with brute force through random inserts and deletes
+ */
+TEST(NameIndexTest, MatchesBruteForce) {
+    NameIndex index;
+    std::map<int, std::string> names;
+    std::mt19937 rng(7);
+    const char alphabet[] = "abc";
+
+    for (int step = 0; step < 2000; ++step) {
+        int userId = static_cast<int>(rng() % 300) + 1;
+        auto it = names.find(userId);
+        if (it != names.end()) {
+            index.onDelete(userId, it->second, 0);
+            names.erase(it);
+            continue;
+        }
+        std::string name(1 + rng() % 6, 'a');
+        for (char& c : name) {
+            c = alphabet[rng() % 3];
+        }
+        index.onInsert(userId, name, 0);
+        names[userId] = name;
+    }
+
+    const std::string patterns[] = {"a%", "ab%", "%bc%", "%cab%", "a_c%", "%a", "abc", "%", "_b%", "c%a%b"};
+    for (const std::string& pattern : patterns) {
+        EXPECT_EQ(bruteForce(names, pattern), index.findLike(pattern)) << pattern;
+    }
+}
+
+// ============================================================================
+// ENGINE QUERIES
+// ============================================================================
+
+/**
+ * NAME LIKE answers the same with the index attached or by scanning
+ */
+TEST(NameIndexTest, EngineLikeQueries) {
+    for (bool indexed : {false, true}) {
+        InMemoryDatabase db;
+        ASSERT_TRUE(db.connect("memory"));
+        db.insertUser("Alice", 25);
+        if (indexed) {
+            db.enableNameIndex();
+        }
+        db.insertUser("Alina", 30);
+        db.insertUser("Janice", 40);
+        db.deleteUser(2);
+
+        std::vector<std::string> results;
+        ASSERT_TRUE(db.executeQuery("SELECT NAME FROM USERS WHERE NAME LIKE 'Al%'", results));
+        EXPECT_EQ(std::vector<std::string>({"Alice"}), results);
+
+        ASSERT_TRUE(db.executeQuery("select * from users where name like '%ice%';", results));
+        EXPECT_EQ(std::vector<std::string>({"1,Alice,25", "3,Janice,40"}), results);
+
+        ASSERT_TRUE(db.executeQuery("SELECT COUNT(*) FROM USERS WHERE NAME LIKE '%a%'", results));
+        EXPECT_EQ(std::vector<std::string>({"1"}), results);
+    }
+}
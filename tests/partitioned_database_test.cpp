@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "mpsc_queue.h"
+#include "partitioned_database.h"
+#include <algorithm>
+#include <set>
+#include <thread>
+
+/**
+ * Partitioned Database Test Suite
+ * Covers the lock-free message queue and the shared-nothing engine built on it
+ */
+
+// ============================================================================
+// MPSC QUEUE
+// ============================================================================
+
+/**
+ * Many producers, one consumer: every item arrives exactly once and each
+ * producer's items stay in order
+ */
+TEST(MpscQueueTest, ConcurrentProducers) {
+    MpscQueue<int> queue;
+    const int producers = 4;
+    const int perProducer = 10000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                queue.push(p * perProducer + i);
+            }
+        });
+    }
+
+    std::vector<int> last(producers, -1);
+    int received = 0;
+    while (received < producers * perProducer) {
+        int value;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = value / perProducer;
+        EXPECT_LT(last[producer], value);
+        last[producer] = value;
+        ++received;
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+// ============================================================================
+// PARTITIONED ENGINE
+// ============================================================================
+
+class PartitionedDatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db = std::make_shared<PartitionedDatabase>(3);
+        ASSERT_TRUE(db->connect("partitions"));
+    }
+
+    std::shared_ptr<PartitionedDatabase> db;
+};
+
+/**
+ * Inserts spread round-robin; ids route back to the owning partition
+ */
+TEST_F(PartitionedDatabaseTest, PointOperationsRoute) {
+    for (int i = 0; i < 9; ++i) {
+        ASSERT_TRUE(db->insertUser("user" + std::to_string(i), 20 + i));
+    }
+    EXPECT_EQ(9, db->getUserCount());
+
+    // Round-robin over 3 partitions: insert i lands in partition i % 3
+    EXPECT_EQ("user0", db->getUserName(1));
+    EXPECT_EQ("user1", db->getUserName(2));
+    EXPECT_EQ("user3", db->getUserName(4));
+    EXPECT_EQ(2u, db->partitionOf(6));
+
+    EXPECT_TRUE(db->updateUser(4, "renamed", 99));
+    EXPECT_EQ(99, db->getUserAge(4));
+    EXPECT_TRUE(db->deleteUser(4));
+    EXPECT_FALSE(db->deleteUser(4));
+    EXPECT_EQ("User not found", db->getLastError());
+    EXPECT_EQ(8, db->getUserCount());
+}
+
+/**
+ * Batch lookups and cross-partition queries gather from every partition
+ */
+TEST_F(PartitionedDatabaseTest, ScatterGather) {
+    for (int i = 0; i < 30; ++i) {
+        db->insertUser("user" + std::to_string(i), i);
+    }
+
+    std::vector<UserRecord> records = db->getUsers({30, 1, 0, 17, 500});
+    ASSERT_EQ(5u, records.size());
+    EXPECT_EQ("user29", records[0].name);
+    EXPECT_EQ("user0", records[1].name);
+    EXPECT_TRUE(records[2].name.empty());
+    EXPECT_EQ(16, records[3].age);
+    EXPECT_TRUE(records[4].name.empty());
+
+    EXPECT_EQ(30u, db->getAllUserNames().size());
+
+    // Pages interleave the partitions' strided ids back into one id order
+    std::vector<UserRecord> page = db->listUsers(0, 4);
+    ASSERT_EQ(4u, page.size());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(i + 1, page[i].id);
+    }
+    page = db->listUsers(26, 10);
+    ASSERT_EQ(4u, page.size());
+    EXPECT_EQ(27, page[0].id);
+    EXPECT_EQ("user29", page[3].name);
+
+    std::vector<std::string> results;
+    EXPECT_TRUE(db->executeQuery("SELECT COUNT(*) FROM users", results));
+    EXPECT_EQ((std::vector<std::string>{"30"}), results);
+    EXPECT_TRUE(db->executeQuery("SELECT name FROM users", results));
+    EXPECT_EQ(30u, results.size());
+    EXPECT_FALSE(db->executeQuery("DELETE FROM users", results));
+}
+
+/**
+ * Concurrent clients through DatabaseService never lose an insert
+ */
+TEST_F(PartitionedDatabaseTest, ConcurrentService) {
+    DatabaseService service(db);
+    ASSERT_TRUE(service.initializeConnection("partitions"));
+
+    std::vector<std::thread> clients;
+    for (int c = 0; c < 4; ++c) {
+        clients.emplace_back([&service, c]() {
+            for (int i = 0; i < 250; ++i) {
+                service.createUser("client" + std::to_string(c) + "-" + std::to_string(i), i);
+            }
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    EXPECT_EQ(1000, service.getTotalUsers());
+
+    // Ids depend on how partitions drain their queues, so compare names only
+    std::set<std::string> expected;
+    for (int c = 0; c < 4; ++c) {
+        for (int i = 0; i < 250; ++i) {
+            expected.insert("client" + std::to_string(c) + "-" + std::to_string(i));
+        }
+    }
+    std::vector<std::string> names = service.getAllUserNames();
+    EXPECT_EQ(expected, std::set<std::string>(names.begin(), names.end()));
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "pool_allocator.h"
+#include <cstring>
+#include <list>
+#include <set>
+#include <thread>
+
+/**
+ * Slab Pool Test Suite
+ * Covers size-class rounding, cross-thread frees and the published counters
+ */
+
+/**
+ * Live blocks never alias and are fully writable
+ */
+TEST(SlabPoolTest, DistinctBlocks) {
+    std::set<void*> live;
+    for (int i = 0; i < 200; ++i) {
+        void* block = SlabPool::allocate(40);
+        std::memset(block, i, 40);
+        EXPECT_TRUE(live.insert(block).second);
+    }
+    for (void* block : live) {
+        SlabPool::deallocate(block, 40);
+    }
+
+    void* large = SlabPool::allocate(SlabPool::kMaxBlockSize + 1);
+    std::memset(large, 0, SlabPool::kMaxBlockSize + 1);
+    SlabPool::deallocate(large, SlabPool::kMaxBlockSize + 1);
+}
+
+/**
+ * Blocks allocated on one thread and freed on another return to the central pool
+ */
+TEST(SlabPoolTest, CrossThreadFree) {
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        blocks.push_back(SlabPool::allocate(64));
+    }
+    std::thread consumer([&blocks]() {
+        for (void* block : blocks) {
+            SlabPool::deallocate(block, 64);
+        }
+    });
+    consumer.join();
+
+    // Reallocating must succeed and reuse pooled memory rather than grow
+    uint64_t reserved = SlabPool::getStats(64).reservedBytes;
+    for (int i = 0; i < 500; ++i) {
+        blocks[i] = SlabPool::allocate(64);
+    }
+    for (int i = 0; i < 500; ++i) {
+        SlabPool::deallocate(blocks[i], 64);
+    }
+    EXPECT_EQ(reserved, SlabPool::getStats(64).reservedBytes);
+}
+
+/**
+ * Counters are published once a thread's cache talks to the central pool
+ */
+TEST(SlabPoolTest, Counters) {
+    const size_t bytes = 500;  // size class used by no other test
+    SlabPool::ClassStats before = SlabPool::getStats(bytes);
+
+    std::thread worker([bytes]() {
+        std::vector<void*> blocks;
+        for (int i = 0; i < 100; ++i) {
+            blocks.push_back(SlabPool::allocate(bytes));
+        }
+        for (void* block : blocks) {
+            SlabPool::deallocate(block, bytes);
+        }
+    });
+    worker.join();
+
+    SlabPool::ClassStats after = SlabPool::getStats(bytes);
+    EXPECT_EQ(512u, after.blockSize);
+    EXPECT_EQ(before.allocations + 100, after.allocations);
+    EXPECT_EQ(before.frees + 100, after.frees);
+    EXPECT_GE(after.reservedBytes, SlabPool::kSlabSize);
+    EXPECT_EQ(0u, after.inUseBytes());
+    EXPECT_DOUBLE_EQ(1.0, after.fragmentation());
+}
+
+/**
+ * Node-based containers run on the pool allocator
+ */
+TEST(SlabPoolTest, ContainerNodes) {
+    std::list<int, PoolAllocator<int>> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    values.remove_if([](int v) { return v % 2 == 0; });
+    EXPECT_EQ(500u, values.size());
+    EXPECT_EQ(999, values.back());
+}
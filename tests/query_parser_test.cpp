@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "query_parser.h"
+
+/**
+ * Query Parser Test Suite
+ * Covers the accepted grammar and the rejection of everything else
+ */
+
+/**
+ * Projections, free-form whitespace, case and trailing semicolons
+ */
+TEST(QueryParserTest, AcceptedQueries) {
+    ParsedQuery query;
+    std::string error;
+
+    ASSERT_TRUE(QueryParser::parse("SELECT * FROM USERS", query, error));
+    EXPECT_EQ(QueryProjection::Star, query.projection);
+    EXPECT_FALSE(query.hasWhere);
+
+    ASSERT_TRUE(QueryParser::parse("  select   name\n from users ;", query, error));
+    EXPECT_EQ(QueryProjection::Name, query.projection);
+
+    ASSERT_TRUE(QueryParser::parse("SELECT COUNT( * ) FROM USERS", query, error));
+    EXPECT_EQ(QueryProjection::Count, query.projection);
+
+    ASSERT_TRUE(QueryParser::parse("SELECT COUNT(DISTINCT name) FROM USERS", query, error));
+    EXPECT_EQ(QueryProjection::CountDistinctName, query.projection);
+
+    ASSERT_TRUE(QueryParser::parse("SELECT NAME FROM USERS WHERE name LIKE 'O''Br%'", query, error));
+    ASSERT_TRUE(query.hasWhere);
+    EXPECT_EQ(PredicateKind::NameLike, query.where.kind);
+    EXPECT_EQ("O'Br%", query.where.text);
+}
+
+/**
+ * AND binds tighter than OR; NOT, parentheses and age comparisons nest
+ */
+TEST(QueryParserTest, BooleanConditions) {
+    ParsedQuery query;
+    std::string error;
+
+    ASSERT_TRUE(QueryParser::parse(
+        "SELECT * FROM USERS WHERE NAME LIKE 'A%' OR AGE > 30 AND NOT (AGE = 40 OR AGE BETWEEN 50 AND 60)",
+        query, error)) << error;
+    const QueryPredicate& root = query.where;
+    ASSERT_EQ(PredicateKind::Or, root.kind);
+    ASSERT_EQ(2u, root.children.size());
+    EXPECT_EQ(PredicateKind::NameLike, root.children[0].kind);
+
+    const QueryPredicate& conjunction = root.children[1];
+    ASSERT_EQ(PredicateKind::And, conjunction.kind);
+    ASSERT_EQ(2u, conjunction.children.size());
+    EXPECT_EQ(PredicateKind::AgeRange, conjunction.children[0].kind);
+    EXPECT_EQ(31, conjunction.children[0].low);
+    EXPECT_EQ(INT_MAX, conjunction.children[0].high);
+
+    const QueryPredicate& negation = conjunction.children[1];
+    ASSERT_EQ(PredicateKind::Not, negation.kind);
+    ASSERT_EQ(PredicateKind::Or, negation.children[0].kind);
+    EXPECT_EQ(40, negation.children[0].children[0].low);
+    EXPECT_EQ(50, negation.children[0].children[1].low);
+    EXPECT_EQ(60, negation.children[0].children[1].high);
+
+    ASSERT_TRUE(QueryParser::parse("SELECT COUNT(*) FROM USERS WHERE age <> 7 AND age <= -1", query, error));
+    ASSERT_EQ(PredicateKind::And, query.where.kind);
+    EXPECT_EQ(PredicateKind::Not, query.where.children[0].kind);
+    EXPECT_EQ(7, query.where.children[0].children[0].high);
+    EXPECT_EQ(-1, query.where.children[1].high);
+}
+
+/**
+ * Arithmetic follows the usual precedence in column lists and comparisons;
+ * bare AGE against literals still becomes an AgeRange
+ */
+TEST(QueryParserTest, ArithmeticExpressions) {
+    ParsedQuery query;
+    std::string error;
+
+    ASSERT_TRUE(QueryParser::parse("SELECT id, NAME, age * 2 + 1 FROM USERS", query, error)) << error;
+    ASSERT_EQ(QueryProjection::Columns, query.projection);
+    ASSERT_EQ(3u, query.columns.size());
+    EXPECT_EQ(ExpressionKind::Id, query.columns[0].expression.kind);
+    EXPECT_TRUE(query.columns[1].isName);
+    const QueryExpression& sum = query.columns[2].expression;
+    ASSERT_EQ(ExpressionKind::Add, sum.kind);
+    EXPECT_EQ(ExpressionKind::Multiply, sum.operands[0].kind);
+    EXPECT_EQ(1, sum.operands[1].value);
+
+    ASSERT_TRUE(QueryParser::parse("SELECT COUNT(*) FROM USERS WHERE (AGE + 1) * 2 > ID - -3", query, error))
+        << error;
+    ASSERT_EQ(PredicateKind::Compare, query.where.kind);
+    EXPECT_EQ(CompareOp::Greater, query.where.op);
+    EXPECT_EQ(ExpressionKind::Multiply, query.where.operands[0].kind);
+    EXPECT_EQ(ExpressionKind::Add, query.where.operands[0].operands[0].kind);
+    ASSERT_EQ(ExpressionKind::Subtract, query.where.operands[1].kind);
+    EXPECT_EQ(-3, query.where.operands[1].operands[1].value);
+
+    ASSERT_TRUE(QueryParser::parse("SELECT * FROM USERS WHERE ID / 2 BETWEEN AGE AND 10", query, error)) << error;
+    ASSERT_EQ(PredicateKind::And, query.where.kind);
+    EXPECT_EQ(CompareOp::GreaterEqual, query.where.children[0].op);
+    EXPECT_EQ(CompareOp::LessEqual, query.where.children[1].op);
+
+    ASSERT_TRUE(QueryParser::parse("SELECT * FROM USERS WHERE (AGE >= 5) AND ID = 3", query, error)) << error;
+    EXPECT_EQ(PredicateKind::AgeRange, query.where.children[0].kind);
+    EXPECT_EQ(PredicateKind::Compare, query.where.children[1].kind);
+}
+
+/**
+ * Anything outside the grammar is rejected with a reason
+ */
+TEST(QueryParserTest, RejectedQueries) {
+    ParsedQuery query;
+    std::string error;
+    const char* rejected[] = {
+        "",
+        "DROP TABLE USERS",
+        "SELECT AGE + FROM USERS",
+        "SELECT NAME, FROM USERS",
+        "SELECT * FROM ORDERS",
+        "SELECT * FROM USERS WHERE NAME LIKE Alice",
+        "SELECT * FROM USERS WHERE NAME LIKE 'open",
+        "SELECT * FROM USERS extra",
+        "SELECT * FROM USERS WHERE AGE > 'ten'",
+        "SELECT * FROM USERS WHERE AGE = 12345678901",
+        "SELECT * FROM USERS WHERE (AGE = 1",
+        "SELECT * FROM USERS WHERE NAME LIKE 'a' AND",
+        "SELECT * FROM USERS WHERE ID = NAME",
+        "SELECT * FROM USERS WHERE (AGE + 1 > 2",
+        "SELECT * FROM USERS WHERE AGE * 2",
+        "SELECT COUNT(DISTINCT AGE) FROM USERS",
+    };
+    for (const char* text : rejected) {
+        error.clear();
+        EXPECT_FALSE(QueryParser::parse(text, query, error)) << text;
+        EXPECT_FALSE(error.empty()) << text;
+    }
+}
+
+/**
+ * Nesting past kMaxNesting fails the parse instead of exhausting the stack
+ */
+TEST(QueryParserTest, NestingLimit) {
+    ParsedQuery query;
+    std::string error;
+    const size_t limit = QueryParser::kMaxNesting;
+
+    std::string nots;
+    for (size_t i = 0; i < 200000; ++i) {
+        nots += "NOT ";
+    }
+    EXPECT_FALSE(QueryParser::parse("SELECT * FROM USERS WHERE " + nots + "AGE > 1", query, error));
+    EXPECT_EQ("Query nested too deeply", error);
+
+    error.clear();
+    EXPECT_FALSE(QueryParser::parse("SELECT * FROM USERS WHERE " + std::string(200000, '(') + "AGE > 1", query, error));
+    EXPECT_EQ("Query nested too deeply", error);
+
+    error.clear();
+    EXPECT_FALSE(QueryParser::parse("SELECT " + std::string(200000, '-') + "AGE FROM USERS", query, error));
+    EXPECT_EQ("Query nested too deeply", error);
+
+    // Left-associative chains build tall trees without recursing
+    std::string sum = "AGE";
+    for (size_t i = 0; i < limit; ++i) {
+        sum += " + 1";
+    }
+    ASSERT_TRUE(QueryParser::parse("SELECT " + sum + " FROM USERS", query, error)) << error;
+    error.clear();
+    EXPECT_FALSE(QueryParser::parse("SELECT " + sum + " + 1 FROM USERS", query, error));
+    EXPECT_EQ("Query nested too deeply", error);
+
+    const std::string open(limit / 2, '(');
+    const std::string close(limit / 2, ')');
+    ASSERT_TRUE(QueryParser::parse("SELECT * FROM USERS WHERE NOT " + open + "AGE > 1" + close, query, error))
+        << error;
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include <memory>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+/**
+ * Replica Router Test Suite
+ * Uses separate in-memory engines as primary and replicas; replicas that
+ * never see the primary's writes stand in for replication lag
+ */
+
+class ReplicaRouterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        primary = std::make_shared<InMemoryDatabase>();
+        ASSERT_TRUE(primary->connect("memory"));
+        for (int i = 0; i < 3; ++i) {
+            replicas.push_back(std::make_shared<InMemoryDatabase>());
+            ASSERT_TRUE(replicas.back()->connect("memory"));
+        }
+    }
+
+    std::vector<std::shared_ptr<DatabaseInterface>> replicaList() const {
+        return std::vector<std::shared_ptr<DatabaseInterface>>(replicas.begin(), replicas.end());
+    }
+
+    std::shared_ptr<InMemoryDatabase> primary;
+    std::vector<std::shared_ptr<InMemoryDatabase>> replicas;
+};
+
+// ============================================================================
+// BALANCING
+// ============================================================================
+
+/**
+ * Reads go to the connected replica with the fewest outstanding requests
+ */
+TEST_F(ReplicaRouterTest, LeastOutstandingRequests) {
+    ReplicaRouter router(primary, replicaList());
+
+    ReplicaRouter::Lease first = router.routeRead();
+    ReplicaRouter::Lease second = router.routeRead();
+    ReplicaRouter::Lease third = router.routeRead();
+    EXPECT_FALSE(first.onPrimary());
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(1, router.getOutstanding(i));
+    }
+
+    // Freeing one replica makes it the only least-loaded choice
+    DatabaseInterface* freed = &*second;
+    second.release();
+    ReplicaRouter::Lease next = router.routeRead();
+    EXPECT_EQ(freed, &*next);
+
+    // Disconnected replicas are skipped, and with none left reads use the primary
+    next.release();
+    for (auto& replica : replicas) {
+        replica->disconnect();
+    }
+    ReplicaRouter::Lease fallback = router.routeRead();
+    EXPECT_TRUE(fallback.onPrimary());
+    EXPECT_EQ(primary.get(), &*fallback);
+    EXPECT_EQ(4u, router.getReplicaReads());
+    EXPECT_EQ(1u, router.getPrimaryReads());
+}
+
+// ============================================================================
+// SERVICE ROUTING
+// ============================================================================
+
+/**
+ * Reads are served by replicas and writes by the primary
+ */
+TEST_F(ReplicaRouterTest, ServiceSplitsReadsAndWrites) {
+    for (auto& replica : replicas) {
+        replica->insertUser("Replica", 40);
+    }
+    DatabaseService service(primary);
+    service.setReplicas(replicaList());
+    ASSERT_TRUE(service.initializeConnection("memory"));
+
+    EXPECT_EQ(1, service.getTotalUsers());
+    EXPECT_EQ("Name: Replica, Age: 40", service.getUserInfo(1));
+
+    // Another thread wrote nothing, so it keeps reading the stale replicas
+    EXPECT_TRUE(service.createUser("Alice", 25));
+    EXPECT_EQ(1, primary->getUserCount());
+    std::thread other([&service]() {
+        EXPECT_EQ("Name: Replica, Age: 40", service.getUserInfo(1));
+    });
+    other.join();
+}
+
+/**
+ * A writer reads its own writes until the sticky window expires
+ */
+TEST_F(ReplicaRouterTest, ReadYourWrites) {
+    ReplicaOptions options;
+    options.stickyWindow = 50ms;
+    DatabaseService service(primary);
+    service.setReplicas(replicaList(), options);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+
+    EXPECT_TRUE(service.createUser("Alice", 25));
+    EXPECT_EQ("Name: Alice, Age: 25", service.getUserInfo(1));
+    EXPECT_EQ(1, service.getTotalUsers());
+
+    std::this_thread::sleep_for(80ms);
+    EXPECT_EQ("", service.getUserInfo(1));
+    EXPECT_EQ(0, service.getTotalUsers());
+}
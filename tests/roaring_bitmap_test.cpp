@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "roaring_bitmap.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+
+/**
+ * Roaring Bitmap Test Suite
+ * Checks membership and set algebra against std::set across sparse and
+ * dense containers
+ */
+
+namespace {
+
+RoaringBitmap fromSet(const std::set<uint32_t>& values) {
+    RoaringBitmap bitmap;
+    for (uint32_t value : values) {
+        bitmap.add(value);
+    }
+    return bitmap;
+}
+
+// Mixes a dense run (bitmap container) with scattered values (array containers)
+std::set<uint32_t> randomSet(std::mt19937& rng, uint32_t denseStart, size_t denseCount) {
+    std::set<uint32_t> values;
+    for (size_t i = 0; i < denseCount; ++i) {
+        values.insert(denseStart + static_cast<uint32_t>(rng() % 20000));
+    }
+    for (int i = 0; i < 500; ++i) {
+        values.insert(static_cast<uint32_t>(rng()) % 400000);
+    }
+    return values;
+}
+
+std::vector<uint32_t> toVector(const std::set<uint32_t>& values) {
+    return std::vector<uint32_t>(values.begin(), values.end());
+}
+
+} // namespace
+
+// ============================================================================
+// MEMBERSHIP
+// ============================================================================
+
+/**
+ * Add, remove and contains across the array/bitmap threshold
+ */
+TEST(RoaringBitmapTest, AddRemoveContains) {
+    RoaringBitmap bitmap;
+    EXPECT_TRUE(bitmap.empty());
+
+    for (uint32_t value = 0; value < 10000; value += 2) {
+        bitmap.add(value);
+    }
+    bitmap.add(70000);
+    bitmap.add(70000);
+    bitmap.add(0xFFFFFFFFu);
+    EXPECT_EQ(5002u, bitmap.cardinality());
+    EXPECT_TRUE(bitmap.contains(9998));
+    EXPECT_FALSE(bitmap.contains(9999));
+    EXPECT_TRUE(bitmap.contains(0xFFFFFFFFu));
+
+    for (uint32_t value = 0; value < 10000; value += 4) {
+        bitmap.remove(value);
+    }
+    bitmap.remove(12345);
+    EXPECT_EQ(2502u, bitmap.cardinality());
+    EXPECT_FALSE(bitmap.contains(4));
+    EXPECT_TRUE(bitmap.contains(6));
+
+    std::vector<uint32_t> values = bitmap.toVector();
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+    EXPECT_EQ(0xFFFFFFFFu, values.back());
+
+    bitmap.remove(70000);
+    bitmap.remove(0xFFFFFFFFu);
+    for (uint32_t value = 2; value < 10000; value += 4) {
+        bitmap.remove(value);
+    }
+    EXPECT_TRUE(bitmap.empty());
+}
+
+// ============================================================================
+// SET ALGEBRA
+// ============================================================================
+
+/**
+ * AND, OR, AND NOT and intersection counts agree with std::set
+ */
+TEST(RoaringBitmapTest, MatchesStdSet) {
+    std::mt19937 rng(3);
+    for (int round = 0; round < 20; ++round) {
+        std::set<uint32_t> a = randomSet(rng, 65536, round % 2 == 0 ? 8000 : 100);
+        std::set<uint32_t> b = randomSet(rng, 70000, round % 3 == 0 ? 9000 : 50);
+        RoaringBitmap x = fromSet(a);
+        RoaringBitmap y = fromSet(b);
+
+        std::set<uint32_t> both;
+        std::set<uint32_t> either;
+        std::set<uint32_t> onlyA;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(both, both.end()));
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(either, either.end()));
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(onlyA, onlyA.end()));
+
+        EXPECT_EQ(toVector(both), (x & y).toVector());
+        EXPECT_EQ(toVector(either), (x | y).toVector());
+        EXPECT_EQ(toVector(onlyA), (x - y).toVector());
+        EXPECT_EQ(both.size(), x.andCardinality(y));
+        EXPECT_EQ(either.size(), (x | y).cardinality());
+
+        // Results are normalized, so equal sets compare equal however built
+        EXPECT_EQ(fromSet(both), x & y);
+        EXPECT_EQ(x, (x - y) | (x & y));
+    }
+}
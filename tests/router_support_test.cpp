@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "in_memory_database.h"
+#include "partitioned_database.h"
+#include "router_support.h"
+#include "sharded_database.h"
+#include <memory>
+
+/**
+ * Router Support Test Suite
+ * Checks query classification and page merging shared by the fan-out
+ * engines, and that row queries are never mistaken for counts
+ */
+
+// ============================================================================
+// CLASSIFICATION
+// ============================================================================
+
+/**
+ * Only the parsed column list decides the projection, not the query text
+ */
+TEST(RouterSupportTest, ProjectionOf) {
+    QueryProjection projection = QueryProjection::Star;
+    ASSERT_TRUE(RouterSupport::projectionOf("select count( * ) from users", projection));
+    EXPECT_EQ(QueryProjection::Count, projection);
+    ASSERT_TRUE(RouterSupport::projectionOf("SELECT COUNT(DISTINCT NAME) FROM USERS", projection));
+    EXPECT_EQ(QueryProjection::CountDistinctName, projection);
+    ASSERT_TRUE(RouterSupport::projectionOf("SELECT NAME FROM USERS WHERE NAME LIKE 'COUNT(%'", projection));
+    EXPECT_EQ(QueryProjection::Name, projection);
+    EXPECT_FALSE(RouterSupport::projectionOf("SELECT COUNT( FROM USERS", projection));
+}
+
+/**
+ * Pages interleave by id and stop at the limit
+ */
+TEST(RouterSupportTest, MergePages) {
+    auto record = [](int id) {
+        UserRecord r;
+        r.id = id;
+        r.name = "User" + std::to_string(id);
+        return r;
+    };
+    std::vector<std::vector<UserRecord>> pages = {{record(1), record(4), record(9)}, {}, {record(2), record(3)}};
+    std::vector<UserRecord> page = RouterSupport::mergePages(pages, 4);
+    ASSERT_EQ(4u, page.size());
+    EXPECT_EQ(1, page[0].id);
+    EXPECT_EQ(2, page[1].id);
+    EXPECT_EQ(3, page[2].id);
+    EXPECT_EQ("User4", page[3].name);
+    EXPECT_TRUE(RouterSupport::mergePages(pages, 0).empty());
+}
+
+/**
+ * A name that looks like an aggregate comes back as a row from every router
+ */
+TEST(RouterSupportTest, CountLookalikeRows) {
+    const std::string query = "SELECT NAME FROM USERS WHERE NAME LIKE 'COUNT(%'";
+
+    PartitionedDatabase partitioned(2);
+    ASSERT_TRUE(partitioned.connect("partitions"));
+    std::vector<std::shared_ptr<DatabaseInterface>> backends = {std::make_shared<InMemoryDatabase>(),
+                                                                std::make_shared<InMemoryDatabase>()};
+    ShardedDatabase sharded(backends);
+    ASSERT_TRUE(sharded.connect("memory"));
+
+    for (DatabaseInterface* db : {static_cast<DatabaseInterface*>(&partitioned),
+                                  static_cast<DatabaseInterface*>(&sharded)}) {
+        ASSERT_TRUE(db->insertUser("COUNT(x)", 30));
+        ASSERT_TRUE(db->insertUser("Alice", 25));
+        std::vector<std::string> results;
+        ASSERT_TRUE(db->executeQuery(query, results));
+        EXPECT_EQ(std::vector<std::string>({"COUNT(x)"}), results);
+        ASSERT_TRUE(db->executeQuery("SELECT COUNT(*) FROM USERS", results));
+        EXPECT_EQ(std::vector<std::string>({"2"}), results);
+    }
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include "in_memory_database.h"
+#include "sharded_database.h"
+#include <algorithm>
+#include <memory>
+
+/**
+ * Sharded Database Test Suite
+ * Routes users over several in-memory backends and grows the backend set
+ */
+
+class ShardedDatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (int i = 0; i < 3; ++i) {
+            backends.push_back(std::make_shared<InMemoryDatabase>());
+        }
+        db = std::make_shared<ShardedDatabase>(
+            std::vector<std::shared_ptr<DatabaseInterface>>(backends.begin(), backends.end()));
+        ASSERT_TRUE(db->connect("memory"));
+    }
+
+    void TearDown() override {
+        db.reset();
+        backends.clear();
+    }
+
+    std::vector<std::shared_ptr<InMemoryDatabase>> backends;
+    std::shared_ptr<ShardedDatabase> db;
+};
+
+// ============================================================================
+// ROUTING
+// ============================================================================
+
+/**
+ * Jump hash stays in range, spreads keys evenly and only moves keys into a
+ * newly added bucket
+ */
+TEST(JumpHashTest, BalancedAndMinimalMovement) {
+    const int keys = 30000;
+    std::vector<int> counts(3, 0);
+    for (int key = 0; key < keys; ++key) {
+        int32_t bucket = ShardedDatabase::jumpHash(key, 3);
+        ASSERT_GE(bucket, 0);
+        ASSERT_LT(bucket, 3);
+        ++counts[bucket];
+
+        int32_t grown = ShardedDatabase::jumpHash(key, 4);
+        EXPECT_TRUE(grown == bucket || grown == 3);
+    }
+    for (int count : counts) {
+        EXPECT_NEAR(keys / 3, count, keys / 30);
+    }
+}
+
+/**
+ * Each user lives on exactly the backend the router names for it
+ */
+TEST_F(ShardedDatabaseTest, UsersLandOnTheirBackend) {
+    for (int i = 0; i < 60; ++i) {
+        ASSERT_TRUE(db->insertUser("User" + std::to_string(i), 20 + i % 40));
+    }
+    for (int id = 1; id <= 60; ++id) {
+        size_t owner = db->backendOf(id);
+        for (size_t b = 0; b < backends.size(); ++b) {
+            EXPECT_EQ(b == owner, !backends[b]->getUserName(id).empty());
+        }
+    }
+    for (const auto& backend : backends) {
+        EXPECT_GT(backend->getUserCount(), 0);
+    }
+}
+
+// ============================================================================
+// OPERATIONS
+// ============================================================================
+
+/**
+ * Point operations reach the owning backend; errors surface on the router
+ */
+TEST_F(ShardedDatabaseTest, BasicCrud) {
+    EXPECT_TRUE(db->insertUser("Alice", 25));
+    EXPECT_TRUE(db->insertUser("Bob", 30));
+    EXPECT_EQ("Alice", db->getUserName(1));
+    EXPECT_EQ(30, db->getUserAge(2));
+
+    EXPECT_TRUE(db->updateUser(1, "Alicia", 26));
+    EXPECT_EQ("Alicia", db->getUserName(1));
+    EXPECT_TRUE(db->deleteUser(2));
+    EXPECT_EQ("", db->getUserName(2));
+
+    EXPECT_FALSE(db->deleteUser(2));
+    EXPECT_EQ("User not found", db->getLastError());
+
+    // Explicit ids push the generator past them
+    EXPECT_TRUE(db->insertUserWithId(10, "Carol", 40));
+    EXPECT_TRUE(db->insertUser("Dave", 50));
+    EXPECT_EQ("Dave", db->getUserName(11));
+}
+
+/**
+ * A generated id that is already taken is skipped instead of failing the insert
+ */
+TEST_F(ShardedDatabaseTest, GeneratedIdClashRetries) {
+    // Written behind the router's back, as an overlapping insertUserWithId could
+    ASSERT_TRUE(backends[db->backendOf(1)]->insertUserWithId(1, "Taken", 20));
+    EXPECT_EQ(2, db->insertUserReturningId("Alice", 25));
+    EXPECT_EQ("Taken", db->getUserName(1));
+    EXPECT_TRUE(db->tryInsertUser("Bob", 30).ok());
+    EXPECT_EQ("Bob", db->getUserName(3));
+}
+
+/**
+ * Aggregates and batch lookups merge every backend's reply
+ */
+TEST_F(ShardedDatabaseTest, Aggregates) {
+    for (int i = 0; i < 20; ++i) {
+        db->insertUser("User" + std::to_string(i), 30);
+    }
+    EXPECT_EQ(20, db->getUserCount());
+    EXPECT_EQ(20u, db->getAllUserNames().size());
+
+    std::vector<std::string> results;
+    ASSERT_TRUE(db->executeQuery("SELECT COUNT(*) FROM USERS", results));
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ("20", results[0]);
+
+    ASSERT_TRUE(db->executeQuery("SELECT * FROM USERS", results));
+    EXPECT_EQ(20u, results.size());
+    EXPECT_FALSE(db->executeQuery("DROP TABLE USERS", results));
+
+    std::vector<UserRecord> records = db->getUsers({5, 99, 1, 20});
+    ASSERT_EQ(4u, records.size());
+    EXPECT_EQ("User4", records[0].name);
+    EXPECT_EQ("", records[1].name);
+    EXPECT_EQ("User0", records[2].name);
+    EXPECT_EQ(30, records[3].age);
+
+    std::vector<UserRecord> page = db->listUsers(5, 3);
+    ASSERT_EQ(3u, page.size());
+    EXPECT_EQ(6, page[0].id);
+    EXPECT_EQ("User7", page[2].name);
+    EXPECT_EQ(2u, db->listUsers(18, 100).size());
+}
+
+// ============================================================================
+// RESHARDING
+// ============================================================================
+
+/**
+ * A new backend takes over its share of users and nothing goes missing
+ */
+TEST_F(ShardedDatabaseTest, AddBackendMigratesUsers) {
+    const int users = 300;
+    for (int i = 1; i <= users; ++i) {
+        ASSERT_TRUE(db->insertUser("User" + std::to_string(i), i % 90));
+    }
+
+    auto added = std::make_shared<InMemoryDatabase>();
+    EXPECT_FALSE(db->addBackend(added));
+    ASSERT_TRUE(added->connect("memory"));
+    ASSERT_TRUE(db->addBackend(added));
+    EXPECT_EQ(4u, db->getBackendCount());
+
+    EXPECT_EQ(users, db->getUserCount());
+    EXPECT_NEAR(users / 4, added->getUserCount(), users / 10);
+    for (int id = 1; id <= users; ++id) {
+        EXPECT_EQ("User" + std::to_string(id), db->getUserName(id));
+    }
+}
+
+/**
+ * The engine accepts caller-chosen ids within its own id sequence only
+ */
+TEST(InsertWithIdTest, EngineValidatesIds) {
+    InMemoryDatabase engine(2, 2);
+    ASSERT_TRUE(engine.connect("memory"));
+    EXPECT_TRUE(engine.insertUserWithId(6, "Alice", 25));
+    EXPECT_EQ("Alice", engine.getUserName(6));
+
+    EXPECT_FALSE(engine.insertUserWithId(6, "Bob", 30));
+    EXPECT_EQ("User already exists", engine.getLastError());
+    EXPECT_FALSE(engine.insertUserWithId(5, "Bob", 30));
+    EXPECT_EQ("User id outside this database's range", engine.getLastError());
+
+    // Generated ids skip the slot already taken
+    EXPECT_TRUE(engine.insertUser("Carol", 40));
+    EXPECT_EQ(2, engine.getUserCount());
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include "single_flight.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * Single-Flight Test Suite
+ * Covers duplicate suppression directly and through DatabaseService
+ */
+
+namespace {
+
+// In-memory engine that counts and slows down its point reads
+class CountingDatabase : public InMemoryDatabase {
+public:
+    std::string getUserName(int userId) override {
+        ++nameCalls;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return InMemoryDatabase::getUserName(userId);
+    }
+
+    std::atomic<int> nameCalls{0};
+};
+
+template <typename Fn>
+void runConcurrently(int threads, Fn fn) {
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(fn);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// SINGLE FLIGHT
+// ============================================================================
+
+/**
+ * Callers arriving during a flight share its result instead of calling again
+ */
+TEST(SingleFlightTest, ConcurrentCallersShareOneCall) {
+    SingleFlight<int, int> flights;
+    std::atomic<int> calls{0};
+    const int threads = 8;
+
+    runConcurrently(threads, [&]() {
+        int value = flights.run(7, [&]() {
+            ++calls;
+            // Hold the flight open until every other caller has joined it
+            while (flights.getSharedCalls() < static_cast<uint64_t>(threads - 1)) {
+                std::this_thread::yield();
+            }
+            return 42;
+        });
+        EXPECT_EQ(42, value);
+    });
+    EXPECT_EQ(1, calls.load());
+    EXPECT_EQ(0u, flights.getInFlight());
+
+    // Completed flights are not cached
+    EXPECT_EQ(43, flights.run(7, []() { return 43; }));
+}
+
+/**
+ * A failing flight rethrows its exception to every caller sharing it
+ */
+TEST(SingleFlightTest, ExceptionsAreShared) {
+    SingleFlight<int, int> flights;
+    std::atomic<int> failures{0};
+
+    runConcurrently(4, [&]() {
+        try {
+            flights.run(1, [&]() -> int {
+                while (flights.getSharedCalls() < 3) {
+                    std::this_thread::yield();
+                }
+                throw std::runtime_error("backend down");
+            });
+        } catch (const std::runtime_error&) {
+            ++failures;
+        }
+    });
+    EXPECT_EQ(4, failures.load());
+}
+
+/**
+ * After forget(), new callers start their own flight
+ */
+TEST(SingleFlightTest, ForgetStartsNewFlight) {
+    SingleFlight<int, int> flights;
+    std::atomic<bool> release{false};
+
+    std::thread slow([&]() {
+        EXPECT_EQ(1, flights.run(5, [&]() {
+            while (!release) {
+                std::this_thread::yield();
+            }
+            return 1;
+        }));
+    });
+    while (flights.getInFlight() == 0) {
+        std::this_thread::yield();
+    }
+
+    flights.forget(5);
+    EXPECT_EQ(2, flights.run(5, []() { return 2; }));
+    release = true;
+    slow.join();
+    EXPECT_EQ(0u, flights.getSharedCalls());
+}
+
+// ============================================================================
+// SERVICE COALESCING
+// ============================================================================
+
+/**
+ * A burst of lookups for one hot user reaches the backend about once
+ */
+TEST(SingleFlightServiceTest, HotUserLookupsCoalesce) {
+    auto db = std::make_shared<CountingDatabase>();
+    DatabaseService service(db);
+    service.setRequestCoalescing(true);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+    ASSERT_TRUE(service.createUser("Alice", 25));
+
+    runConcurrently(16, [&service]() {
+        EXPECT_EQ("Name: Alice, Age: 25", service.getUserInfo(1));
+    });
+    EXPECT_LT(db->nameCalls.load(), 4);
+
+    // Without coalescing every call reaches the backend
+    service.setRequestCoalescing(false);
+    db->nameCalls = 0;
+    runConcurrently(4, [&service]() {
+        EXPECT_EQ("Name: Alice, Age: 25", service.getUserInfo(1));
+    });
+    EXPECT_EQ(4, db->nameCalls.load());
+}
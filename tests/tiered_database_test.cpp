@@ -0,0 +1,365 @@
+#include <gtest/gtest.h>
+#include "tiered_database.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+/**
+ * Tiered Database Test Suite
+ * Covers demotion sweeps, promotion on access, scans across both tiers,
+ * segment file lifetime and tier statistics
+ */
+
+namespace {
+
+size_t segmentFiles(const std::string& directory) {
+    size_t count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        count += entry.path().extension() == ".lzb";
+    }
+    return count;
+}
+
+} // namespace
+
+class TieredDatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        directory = (std::filesystem::temp_directory_path() /
+                     ("tiered-" + std::string(info->name()) + "-" + std::to_string(::getpid())))
+                        .string();
+        std::filesystem::remove_all(directory);
+        options.directory = directory;
+        options.segmentRows = 4;
+    }
+
+    void TearDown() override {
+        db.reset();
+        std::filesystem::remove_all(directory);
+    }
+
+    // Connects and inserts users 1..count named UserN with age N
+    void open(int count) {
+        db = std::make_unique<TieredDatabase>(options);
+        ASSERT_TRUE(db->connect("tiered"));
+        for (int i = 1; i <= count; ++i) {
+            ASSERT_EQ(i, db->insertUserReturningId("User" + std::to_string(i), i));
+        }
+    }
+
+    std::string directory;
+    TieringOptions options;
+    std::unique_ptr<TieredDatabase> db;
+};
+
+// ============================================================================
+// MIGRATION
+// ============================================================================
+
+/**
+ * New rows survive one sweep; rows unread since then move to disk segments
+ */
+TEST_F(TieredDatabaseTest, SweepDemotesUnreadRows) {
+    open(10);
+    EXPECT_EQ(0, db->sweep());
+    for (int userId = 1; userId <= 3; ++userId) {
+        EXPECT_EQ("User" + std::to_string(userId), db->getUserName(userId));
+    }
+    EXPECT_EQ(7, db->sweep());
+
+    TierStats stats = db->getStats();
+    EXPECT_EQ(3u, stats.hotRows);
+    EXPECT_EQ(7u, stats.coldRows);
+    EXPECT_EQ(2u, stats.coldSegments);
+    EXPECT_GT(stats.coldBytes, 0u);
+    EXPECT_EQ(7u, stats.demotions);
+    EXPECT_EQ(2u, segmentFiles(directory));
+    EXPECT_EQ(10, db->getUserCount());
+
+    // Read once and halved to zero by the last sweep, so demoted by this one
+    EXPECT_EQ(3, db->sweep());
+    EXPECT_EQ(0u, db->getStats().hotRows);
+}
+
+/**
+ * A capped hot tier keeps the most-read rows
+ */
+TEST_F(TieredDatabaseTest, CapacityKeepsHottestRows) {
+    options.maxHotRows = 2;
+    open(6);
+    for (int userId = 1; userId <= 6; ++userId) {
+        for (int reads = 0; reads < userId; ++reads) {
+            db->getUserAge(userId);
+        }
+    }
+    EXPECT_EQ(4, db->sweep());
+    TierStats stats = db->getStats();
+    EXPECT_EQ(2u, stats.hotRows);
+    EXPECT_EQ(4u, stats.coldRows);
+    EXPECT_EQ(6u * 7 / 2, stats.hotHits);
+    EXPECT_EQ(0u, stats.coldHits);
+
+    // The survivors are served from memory without promotions
+    EXPECT_EQ(5, db->getUserAge(5));
+    EXPECT_EQ(6, db->getUserAge(6));
+    EXPECT_EQ(0u, db->getStats().promotions);
+}
+
+// ============================================================================
+// PROMOTION
+// ============================================================================
+
+/**
+ * Reading a cold row brings it back; later reads are hot hits
+ */
+TEST_F(TieredDatabaseTest, ColdReadPromotes) {
+    open(8);
+    db->sweep();
+    ASSERT_EQ(8, db->sweep());
+
+    EXPECT_EQ("User5", db->getUserName(5));
+    EXPECT_EQ(5, db->getUserAge(5));
+    EXPECT_EQ(6, db->getUserAge(6));
+    EXPECT_EQ("", db->getUserName(99));
+
+    TierStats stats = db->getStats();
+    EXPECT_EQ(2u, stats.hotRows);
+    EXPECT_EQ(6u, stats.coldRows);
+    EXPECT_EQ(2u, stats.coldHits);
+    EXPECT_EQ(1u, stats.hotHits);
+    EXPECT_EQ(2u, stats.promotions);
+    EXPECT_NEAR(1.0 / 3.0, stats.hitRatio(), 1e-9);
+    EXPECT_DOUBLE_EQ(1.0, TierStats().hitRatio());
+}
+
+/**
+ * Writes to cold rows work in place of the hot tier; empty segments are removed
+ */
+TEST_F(TieredDatabaseTest, ColdWritesAndSegmentCleanup) {
+    open(8);
+    db->sweep();
+    ASSERT_EQ(8, db->sweep());
+    ASSERT_EQ(2u, segmentFiles(directory));
+
+    EXPECT_TRUE(db->updateUser(1, "Renamed", 40));
+    EXPECT_EQ("Renamed", db->getUserName(1));
+    EXPECT_EQ(1u, db->getStats().promotions);
+
+    EXPECT_FALSE(db->insertUserWithId(2, "Clash", 1));
+    EXPECT_EQ("User already exists", db->getLastError());
+
+    EXPECT_TRUE(db->deleteUser(2));
+    EXPECT_TRUE(db->deleteUser(3));
+    EXPECT_TRUE(db->deleteUser(4));
+    EXPECT_FALSE(db->deleteUser(4));
+    EXPECT_EQ("", db->getUserName(3));
+    EXPECT_EQ(1u, segmentFiles(directory));
+    EXPECT_EQ(5, db->getUserCount());
+
+    // Ids keep increasing past demoted ones
+    EXPECT_EQ(9, db->insertUserReturningId("Newcomer", 30));
+
+    db.reset();
+    EXPECT_EQ(0u, segmentFiles(directory));
+}
+
+/**
+ * A damaged segment fails the read instead of returning wrong data
+ */
+TEST_F(TieredDatabaseTest, CorruptSegmentFailsRead) {
+    open(4);
+    db->sweep();
+    ASSERT_EQ(4, db->sweep());
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::ofstream(entry.path(), std::ios::binary | std::ios::trunc) << "garbage";
+    }
+
+    EXPECT_EQ("", db->getUserName(1));
+    EXPECT_EQ(0u, db->getLastError().find("Cold segment unreadable"));
+    EXPECT_EQ(4u, db->getStats().coldRows);
+}
+
+/**
+ * Typed calls promote cold rows too, and report their codes without getLastError
+ */
+TEST_F(TieredDatabaseTest, TypedCallsReachColdRows) {
+    open(8);
+    db->sweep();
+    ASSERT_EQ(8, db->sweep());
+
+    UserRecord record;
+    ASSERT_TRUE(db->tryGetUser(2, record).ok());
+    EXPECT_EQ("User2", record.name);
+    EXPECT_EQ(1u, db->getStats().promotions);
+    EXPECT_EQ(DbError::AlreadyExists, db->tryInsertUserWithId(3, "Clash", 1).code());
+    EXPECT_TRUE(db->tryUpdateUser(3, "Renamed", 30).ok());
+    EXPECT_TRUE(db->tryDeleteUser(4).ok());
+    EXPECT_EQ(DbError::NotFound, db->tryDeleteUser(4).code());
+    EXPECT_EQ(DbError::NotFound, db->tryGetUser(99, record).code());
+    EXPECT_TRUE(db->tryInsertUser("Newcomer", 30).ok());
+    EXPECT_EQ("Newcomer", db->getUserName(9));
+    EXPECT_EQ("", db->getLastError());
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::ofstream(entry.path(), std::ios::binary | std::ios::trunc) << "garbage";
+    }
+    // Row 2 left its segment cached; row 6 is in the other one
+    EXPECT_EQ(DbError::Unknown, db->tryGetUser(6, record).code());
+    EXPECT_EQ(0u, DbStatus::detail().find("Cold segment unreadable"));
+    EXPECT_EQ("", db->getLastError());
+}
+
+/**
+ * A far-off explicit id costs one row, in the hot tier and in the ranking
+ */
+TEST_F(TieredDatabaseTest, LargeExplicitId) {
+    open(2);
+    ASSERT_TRUE(db->insertUserWithId(300000000, "Far", 30));
+    EXPECT_EQ(3u, db->getStats().hotRows);
+    db->sweep();
+    ASSERT_EQ(3, db->sweep());
+    EXPECT_EQ("Far", db->getUserName(300000000));
+    EXPECT_EQ(1u, db->getStats().promotions);
+}
+
+// ============================================================================
+// SCANS
+// ============================================================================
+
+/**
+ * Pages, names and queries see both tiers and promote nothing
+ */
+TEST_F(TieredDatabaseTest, ScansCoverBothTiers) {
+    open(10);
+    db->sweep();
+    for (int userId = 2; userId <= 10; userId += 2) {
+        db->getUserName(userId);
+    }
+    ASSERT_EQ(5, db->sweep());
+
+    std::vector<UserRecord> page = db->listUsers(2, 4);
+    ASSERT_EQ(4u, page.size());
+    for (size_t i = 0; i < page.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(i) + 3, page[i].id);
+        EXPECT_EQ("User" + std::to_string(page[i].id), page[i].name);
+        EXPECT_EQ(page[i].id, page[i].age);
+    }
+    EXPECT_EQ(10u, db->listUsers(0, 100).size());
+
+    std::vector<std::string> names = db->getAllUserNames();
+    EXPECT_EQ(10u, names.size());
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "User7"));
+
+    std::vector<std::string> results;
+    ASSERT_TRUE(db->executeQuery("SELECT COUNT(*) FROM USERS WHERE AGE > 3", results));
+    EXPECT_EQ(std::vector<std::string>({"7"}), results);
+    ASSERT_TRUE(db->executeQuery("SELECT NAME FROM USERS WHERE AGE * 2 >= 18", results));
+    std::sort(results.begin(), results.end());
+    EXPECT_EQ(std::vector<std::string>({"User10", "User9"}), results);
+    ASSERT_TRUE(db->executeQuery("SELECT COUNT(DISTINCT NAME) FROM USERS", results));
+    EXPECT_EQ(std::vector<std::string>({"10"}), results);
+    EXPECT_FALSE(db->executeQuery("DROP TABLE USERS", results));
+
+    EXPECT_EQ(0u, db->getStats().promotions);
+    EXPECT_EQ(5u, db->getStats().coldRows);
+}
+
+/**
+ * Scans after promotions, deletes and further demotions still see each row once
+ */
+TEST_F(TieredDatabaseTest, ColdScansFollowTierChanges) {
+    open(6);
+    db->sweep();
+    ASSERT_EQ(6, db->sweep());
+
+    std::vector<std::string> results;
+    ASSERT_TRUE(db->executeQuery("SELECT COUNT(*) FROM USERS WHERE AGE > 0", results));
+    EXPECT_EQ(std::vector<std::string>({"6"}), results);
+
+    EXPECT_EQ("User2", db->getUserName(2));
+    EXPECT_TRUE(db->deleteUser(3));
+    ASSERT_TRUE(db->insertUser("User7", 7));
+    ASSERT_TRUE(db->executeQuery("SELECT NAME FROM USERS WHERE AGE > 0", results));
+    std::sort(results.begin(), results.end());
+    EXPECT_EQ(std::vector<std::string>({"User1", "User2", "User4", "User5", "User6", "User7"}), results);
+
+    db->sweep();
+    ASSERT_EQ(2, db->sweep());
+    ASSERT_TRUE(db->executeQuery("SELECT COUNT(*) FROM USERS WHERE AGE > 0", results));
+    EXPECT_EQ(std::vector<std::string>({"6"}), results);
+    ASSERT_TRUE(db->executeQuery("SELECT COUNT(*) FROM USERS", results));
+    EXPECT_EQ(std::vector<std::string>({"6"}), results);
+    EXPECT_EQ(6u, db->getAllUserNames().size());
+}
+
+/**
+ * Segments from different sweeps interleave ids; pages still come in id order
+ */
+TEST_F(TieredDatabaseTest, InterleavedSegments) {
+    open(8);
+    db->sweep();
+    for (int userId = 2; userId <= 8; userId += 2) {
+        db->getUserName(userId);
+    }
+    ASSERT_EQ(4, db->sweep());
+    ASSERT_EQ(4, db->sweep());
+    EXPECT_EQ(0u, db->getStats().hotRows);
+    EXPECT_EQ(2u, db->getStats().coldSegments);
+
+    std::vector<UserRecord> page = db->listUsers(3, 3);
+    ASSERT_EQ(3u, page.size());
+    EXPECT_EQ(4, page[0].id);
+    EXPECT_EQ(5, page[1].id);
+    EXPECT_EQ(6, page[2].id);
+
+    EXPECT_TRUE(db->deleteUser(5));
+    EXPECT_FALSE(db->insertUserWithId(6, "Clash", 1));
+    std::vector<std::string> results;
+    ASSERT_TRUE(db->executeQuery("SELECT * FROM USERS WHERE ID > 3", results));
+    std::sort(results.begin(), results.end());
+    EXPECT_EQ(std::vector<std::string>({"4,User4,4", "6,User6,6", "7,User7,7", "8,User8,8"}), results);
+    EXPECT_EQ(7u, db->getAllUserNames().size());
+    EXPECT_EQ(0u, db->getStats().promotions);
+}
+
+/**
+ * Two instances sharing a directory keep separate segment files
+ */
+TEST_F(TieredDatabaseTest, InstancesShareDirectory) {
+    open(4);
+    TieredDatabase other(options);
+    ASSERT_TRUE(other.connect("tiered"));
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(other.insertUser("Other" + std::to_string(i), i));
+    }
+
+    db->sweep();
+    other.sweep();
+    ASSERT_EQ(4, db->sweep());
+    ASSERT_EQ(4, other.sweep());
+    EXPECT_EQ(2u, segmentFiles(directory));
+    EXPECT_EQ("User3", db->getUserName(3));
+    EXPECT_EQ("Other3", other.getUserName(3));
+}
+
+/**
+ * The background sweeper demotes idle rows on its own
+ */
+TEST_F(TieredDatabaseTest, BackgroundSweep) {
+    options.sweepInterval = 5ms;
+    open(20);
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (db->getStats().coldRows < 20 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(20u, db->getStats().coldRows);
+    EXPECT_EQ("User20", db->getUserName(20));
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include "user_info_formatter.h"
+#include <climits>
+#include <memory>
+
+/**
+ * User Info Formatter Test Suite
+ * Checks the output against the original string concatenation and that
+ * reused buffers are not reallocated
+ */
+
+// ============================================================================
+// FORMATTING
+// ============================================================================
+
+/**
+ * Integer conversion agrees with std::to_string across digit boundaries
+ */
+TEST(UserInfoFormatterTest, IntegerConversion) {
+    const int values[] = {0, 7, 9, 10, 42, 99, 100, 101, 999, 1000, 12345, 99999, 100000,
+                          1000000, -1, -7, -10, -100, INT_MAX, INT_MIN};
+    for (int value : values) {
+        char buffer[16];
+        char* end = UserInfoFormatter::writeInt(buffer, value);
+        EXPECT_EQ(std::to_string(value), std::string(buffer, end)) << value;
+    }
+}
+
+/**
+ * Formatted lines match the concatenated form exactly
+ */
+TEST(UserInfoFormatterTest, MatchesConcatenation) {
+    const std::string names[] = {"A", "Alice", "A much longer name than fits inline"};
+    const int ages[] = {0, 5, 25, 130, -1};
+    for (const std::string& name : names) {
+        for (int age : ages) {
+            std::string expected = "Name: " + name + ", Age: " + std::to_string(age);
+            EXPECT_EQ(expected.size(), UserInfoFormatter::formattedLength(name.size(), age));
+
+            std::string out;
+            UserInfoFormatter::formatInto(out, name, age);
+            EXPECT_EQ(expected, out);
+        }
+    }
+}
+
+/**
+ * A reused string keeps its buffer once it has grown to the longest line
+ */
+TEST(UserInfoFormatterTest, ReusedBufferDoesNotReallocate) {
+    std::string out;
+    out.reserve(128);
+    const char* buffer = out.data();
+    for (int i = 0; i < 1000; ++i) {
+        UserInfoFormatter::formatInto(out, "User" + std::to_string(i % 10), i);
+        ASSERT_EQ(buffer, out.data());
+    }
+    EXPECT_EQ("Name: User9, Age: 999", out);
+
+    std::string lines;
+    UserInfoFormatter::append(lines, "Alice", 25, '\n');
+    UserInfoFormatter::append(lines, "Bob", 30, '\n');
+    EXPECT_EQ("Name: Alice, Age: 25\nName: Bob, Age: 30\n", lines);
+}
+
+// ============================================================================
+// SERVICE FORMATTING
+// ============================================================================
+
+/**
+ * The buffer-reusing and batch service calls produce the legacy text
+ */
+TEST(UserInfoFormatterServiceTest, ServiceVariants) {
+    auto db = std::make_shared<InMemoryDatabase>();
+    DatabaseService service(db);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+    service.createUser("Alice", 25);
+    service.createUser("Bob", 30);
+
+    std::string out = "stale";
+    EXPECT_TRUE(service.getUserInfo(2, out));
+    EXPECT_EQ("Name: Bob, Age: 30", out);
+    EXPECT_EQ(service.getUserInfo(2), out);
+    EXPECT_FALSE(service.getUserInfo(9, out));
+    EXPECT_TRUE(out.empty());
+
+    EXPECT_EQ(2u, service.getUsersInfo({1, 9, 2}, out));
+    EXPECT_EQ("Name: Alice, Age: 25\nName: Bob, Age: 30\n", out);
+}
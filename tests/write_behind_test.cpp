@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "database_interface.h"
+#include "in_memory_database.h"
+#include "write_behind.h"
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+/**
+ * Write-Behind Test Suite
+ * Covers batching thresholds, per-user merging and the flush barrier
+ */
+
+class WriteBehindQueueTest : public ::testing::Test {
+protected:
+    WriteBehindQueue::Sink recorder(bool succeed = true) {
+        return [this, succeed](const std::vector<UserMutation>& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(batch);
+            return succeed;
+        };
+    }
+
+    static UserMutation update(int userId, const std::string& name, int age) {
+        UserMutation mutation;
+        mutation.type = MutationType::Update;
+        mutation.userId = userId;
+        mutation.name = name;
+        mutation.age = age;
+        return mutation;
+    }
+
+    static UserMutation insert(const std::string& name, int age) {
+        UserMutation mutation;
+        mutation.name = name;
+        mutation.age = age;
+        return mutation;
+    }
+
+    size_t batchCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches.size();
+    }
+
+    std::mutex mutex;
+    std::vector<std::vector<UserMutation>> batches;
+};
+
+// ============================================================================
+// BATCHING
+// ============================================================================
+
+/**
+ * Repeated writes to one user merge; inserts are kept as they are
+ */
+TEST_F(WriteBehindQueueTest, CoalescesPerUser) {
+    WriteBehindOptions options;
+    options.maxDelay = 10s;
+    WriteBehindQueue queue(recorder(), options);
+
+    queue.enqueue(update(1, "A", 1));
+    queue.enqueue(update(2, "B", 2));
+    queue.enqueue(insert("C", 3));
+    queue.enqueue(update(1, "A2", 11));
+    UserMutation remove;
+    remove.type = MutationType::Delete;
+    remove.userId = 2;
+    queue.enqueue(remove);
+    queue.enqueue(insert("C", 3));
+    EXPECT_EQ(4u, queue.getPending());
+
+    EXPECT_TRUE(queue.flush());
+    ASSERT_EQ(1u, batches.size());
+    const std::vector<UserMutation>& batch = batches[0];
+    ASSERT_EQ(4u, batch.size());
+    EXPECT_EQ("A2", batch[0].name);
+    EXPECT_EQ(11, batch[0].age);
+    EXPECT_EQ(MutationType::Delete, batch[1].type);
+    EXPECT_EQ(MutationType::Insert, batch[2].type);
+    EXPECT_EQ(MutationType::Insert, batch[3].type);
+    EXPECT_EQ(6u, queue.getEnqueued());
+    EXPECT_EQ(2u, queue.getCoalesced());
+}
+
+/**
+ * A full batch is applied without waiting for the delay
+ */
+TEST_F(WriteBehindQueueTest, FlushesOnSize) {
+    WriteBehindOptions options;
+    options.maxBatch = 10;
+    options.maxDelay = 10s;
+    WriteBehindQueue queue(recorder(), options);
+
+    for (int i = 0; i < 10; ++i) {
+        queue.enqueue(insert("User", i));
+    }
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (batchCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(1u, batchCount());
+    EXPECT_EQ(0u, queue.getPending());
+}
+
+/**
+ * A lone write is applied once it has waited the maximum delay
+ */
+TEST_F(WriteBehindQueueTest, FlushesOnDelay) {
+    WriteBehindOptions options;
+    options.maxDelay = 10ms;
+    WriteBehindQueue queue(recorder(), options);
+
+    queue.enqueue(insert("Alice", 25));
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (batchCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(1u, batchCount());
+}
+
+/**
+ * flush() reports failed batches once, and destruction applies leftovers
+ */
+TEST_F(WriteBehindQueueTest, FailuresAndShutdown) {
+    WriteBehindOptions options;
+    options.maxDelay = 10s;
+    {
+        WriteBehindQueue queue(recorder(false), options);
+        queue.enqueue(insert("Alice", 25));
+        EXPECT_FALSE(queue.flush());
+        EXPECT_TRUE(queue.flush());
+        queue.enqueue(insert("Bob", 30));
+    }
+    EXPECT_EQ(2u, batches.size());
+}
+
+// ============================================================================
+// SERVICE WRITE-BEHIND
+// ============================================================================
+
+/**
+ * Service writes land in the engine once flushed, rejected ones fail the flush
+ */
+TEST(WriteBehindServiceTest, BufferedWrites) {
+    auto db = std::make_shared<InMemoryDatabase>();
+    DatabaseService service(db);
+    ASSERT_TRUE(service.initializeConnection("memory"));
+    WriteBehindOptions options;
+    options.maxDelay = 10s;
+    service.enableWriteBehind(options);
+
+    EXPECT_TRUE(service.createUser("Alice", 25));
+    EXPECT_TRUE(service.createUser("Bob", 30));
+    EXPECT_TRUE(service.flush());
+    EXPECT_EQ(2, db->getUserCount());
+
+    EXPECT_TRUE(service.updateUser(1, "Alicia", 26));
+    EXPECT_TRUE(service.updateUser(1, "Alicia", 27));
+    EXPECT_TRUE(service.removeUser(2));
+    EXPECT_EQ("Alice", db->getUserName(1));
+    EXPECT_TRUE(service.flush());
+    EXPECT_EQ("Name: Alicia, Age: 27", service.getUserInfo(1));
+    EXPECT_EQ(1, service.getTotalUsers());
+
+    EXPECT_TRUE(service.removeUser(2));
+    EXPECT_FALSE(service.flush());
+    EXPECT_EQ("User not found", db->getLastError());
+
+    // An insert that reports its id goes after the queue, which keeps its failures
+    EXPECT_TRUE(service.updateUser(1, "Alice", 28));
+    EXPECT_TRUE(service.removeUser(2));
+    EXPECT_EQ(3, service.createUserReturningId("Carol", 40));
+    EXPECT_EQ("Name: Alice, Age: 28", service.getUserInfo(1));
+    EXPECT_FALSE(service.flush());
+}